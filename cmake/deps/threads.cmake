@@ -0,0 +1,5 @@
+if(TARGET Threads::Threads)
+    return()
+endif()
+
+find_package(Threads REQUIRED)
@@ -0,0 +1,323 @@
+#pragma once
+
+/*
+    Parallel building blocks for bulk operations on spans (scans, sorts, partitions). Each function
+    takes an executor and runs serially when given the default one.
+*/
+
+#include <algorithm>
+#include <cassert>
+#include <type_traits>
+
+#include <dr/basic_traits.hpp>
+#include <dr/basic_types.hpp>
+#include <dr/container_utils.hpp>
+#include <dr/dynamic_array.hpp>
+#include <dr/executor.hpp>
+#include <dr/memory.hpp>
+#include <dr/span.hpp>
+
+namespace dr
+{
+namespace impl
+{
+
+/// Computes the prefix sum of the given values. Can be used in-place. Returns the total.
+template <bool inclusive, typename T>
+T scan(
+    Span<T const> const& values,
+    Span<T> const& result,
+    Executor const exec,
+    Allocator const alloc)
+{
+    assert(result.size() == values.size());
+    isize const n = values.size();
+
+    auto const scan_block = [&](T sum, isize const begin, isize const end) -> T {
+        for (isize i = begin; i < end; ++i)
+        {
+            T const value = values[i];
+
+            if constexpr (inclusive)
+            {
+                sum += value;
+                result[i] = sum;
+            }
+            else
+            {
+                result[i] = sum;
+                sum += value;
+            }
+        }
+
+        return sum;
+    };
+
+    isize const num_blocks = exec.num_blocks(n);
+    if (num_blocks == 1)
+        return scan_block(T{0}, 0, n);
+
+    // Sum of each block offset by 1
+    DynamicArray<T> block_sums(num_blocks + 1, T{0}, alloc);
+
+    exec.parallel_for_blocks(n, [&](isize const b, isize const begin, isize const end) {
+        T sum{0};
+        for (isize i = begin; i < end; ++i)
+            sum += values[i];
+
+        block_sums[b + 1] = sum;
+    });
+
+    for (isize b = 1; b <= num_blocks; ++b)
+        block_sums[b] += block_sums[b - 1];
+
+    exec.parallel_for_blocks(n, [&](isize const b, isize const begin, isize const end) {
+        scan_block(block_sums[b], begin, end);
+    });
+
+    return block_sums[num_blocks];
+}
+
+/// Stable sorts keys by 8 bits at a time, least significant first, applying the same reordering to
+/// each key's value. Passes over bits which are the same for all keys are skipped.
+template <typename Key, typename Value>
+void radix_sort(
+    Span<Key> const& keys,
+    Value* const values,
+    Executor const exec,
+    Allocator const alloc)
+{
+    static_assert(is_natural<Key>);
+    constexpr bool has_values = !std::is_void_v<Value>;
+    using Payload = std::conditional_t<has_values, Value, u8>;
+
+    constexpr isize radix = 256;
+    constexpr isize key_bits = sizeof(Key) * 8;
+
+    isize const n = keys.size();
+    if (n < 2)
+        return;
+
+    isize const num_blocks = exec.num_blocks(n);
+
+    // Bits which differ between keys
+    Key diff_bits{0};
+    for (isize i = 1; i < n; ++i)
+        diff_bits |= keys[i] ^ keys[0];
+
+    DynamicArray<Key> tmp_keys(alloc);
+    DynamicArray<Payload> tmp_values(alloc);
+
+    // Per-block counts (or offsets) of each digit
+    DynamicArray<isize> counts(num_blocks * radix, alloc);
+
+    Key* src_keys = keys.data();
+    Key* dst_keys = nullptr;
+    Payload* src_values = nullptr;
+    Payload* dst_values = nullptr;
+
+    if constexpr (has_values)
+        src_values = values;
+
+    for (isize shift = 0; shift < key_bits; shift += 8)
+    {
+        if (((diff_bits >> shift) & (radix - 1)) == 0)
+            continue;
+
+        // Scratch is only allocated once a pass is required
+        if (dst_keys == nullptr)
+        {
+            tmp_keys.resize(n);
+            dst_keys = tmp_keys.data();
+
+            if constexpr (has_values)
+            {
+                tmp_values.resize(n);
+                dst_values = tmp_values.data();
+            }
+        }
+
+        auto const count_digits = [&](isize const b, isize const begin, isize const end) {
+            isize* const c = counts.data() + b * radix;
+            std::fill(c, c + radix, 0);
+
+            for (isize i = begin; i < end; ++i)
+                ++c[(src_keys[i] >> shift) & (radix - 1)];
+        };
+
+        exec.parallel_for_blocks(n, count_digits);
+
+        // Convert counts to offsets ordered by digit then block
+        isize sum = 0;
+        for (isize d = 0; d < radix; ++d)
+        {
+            for (isize b = 0; b < num_blocks; ++b)
+            {
+                isize const count = counts[b * radix + d];
+                counts[b * radix + d] = sum;
+                sum += count;
+            }
+        }
+
+        auto const scatter = [&](isize const b, isize const begin, isize const end) {
+            isize* const offsets = counts.data() + b * radix;
+
+            for (isize i = begin; i < end; ++i)
+            {
+                isize const j = offsets[(src_keys[i] >> shift) & (radix - 1)]++;
+                dst_keys[j] = src_keys[i];
+
+                if constexpr (has_values)
+                    dst_values[j] = std::move(src_values[i]);
+            }
+        };
+
+        exec.parallel_for_blocks(n, scatter);
+
+        std::swap(src_keys, dst_keys);
+        std::swap(src_values, dst_values);
+    }
+
+    // Copy back if the final pass left the result in scratch
+    if (src_keys != keys.data())
+    {
+        exec.parallel_for(n, [&](isize const i) {
+            keys[i] = src_keys[i];
+
+            if constexpr (has_values)
+                values[i] = std::move(src_values[i]);
+        });
+    }
+}
+
+} // namespace impl
+
+/// Computes the inclusive prefix sum of the given values. Can be used in-place.
+template <typename T>
+void inclusive_scan(
+    Span<T const> const& values,
+    Span<T> const& result,
+    Executor const exec = {},
+    Allocator const alloc = {})
+{
+    impl::scan<true>(values, result, exec, alloc);
+}
+
+/// Computes the exclusive prefix sum of the given values and returns the total. Can be used
+/// in-place.
+template <typename T>
+T exclusive_scan(
+    Span<T const> const& values,
+    Span<T> const& result,
+    Executor const exec = {},
+    Allocator const alloc = {})
+{
+    return impl::scan<false>(values, result, exec, alloc);
+}
+
+/// Stable sorts the given keys in ascending order
+template <typename Key>
+void radix_sort(Span<Key> const& keys, Executor const exec = {}, Allocator const alloc = {})
+{
+    impl::radix_sort<Key, void>(keys, nullptr, exec, alloc);
+}
+
+/// Stable sorts the given keys in ascending order and applies the same reordering to the given
+/// values
+template <typename Key, typename Value>
+void radix_sort(
+    Span<Key> const& keys,
+    Span<Value> const& values,
+    Executor const exec = {},
+    Allocator const alloc = {})
+{
+    assert(values.size() == keys.size());
+    impl::radix_sort<Key, Value>(keys, values.data(), exec, alloc);
+}
+
+/// Returns the permutation which stable sorts the given keys (i.e. result[i] is the index of the
+/// key with rank i)
+template <typename Key, typename Index>
+void radix_sort_permutation(
+    Span<Key const> const& keys,
+    Span<Index> const& result,
+    Executor const exec = {},
+    Allocator const alloc = {})
+{
+    static_assert(is_integer<Index> || is_natural<Index>);
+    assert(result.size() == keys.size());
+
+    isize const n = keys.size();
+    DynamicArray<Key> sorted_keys(n, alloc);
+
+    exec.parallel_for(n, [&](isize const i) {
+        sorted_keys[i] = keys[i];
+        result[i] = Index(i);
+    });
+
+    radix_sort(as_span(sorted_keys), result, exec, alloc);
+}
+
+/// Copies values which satisfy the given predicate to the front of the result followed by those
+/// that don't, preserving relative order within each group. Returns the number of values which
+/// satisfy the predicate.
+template <typename T, typename Predicate>
+isize partition(
+    Span<T const> const& values,
+    Predicate&& pred,
+    Span<T> const& result,
+    Executor const exec = {},
+    Allocator const alloc = {})
+{
+    static_assert(std::is_invocable_r_v<bool, Predicate, T const&>);
+    assert(result.size() == values.size());
+    assert(values.size() == 0 || result.data() != values.data());
+
+    isize const n = values.size();
+    isize const num_blocks = exec.num_blocks(n);
+
+    // Predicate is only evaluated once per value
+    DynamicArray<u8> flags(n, alloc);
+
+    // Number of accepted values in each block offset by 1
+    DynamicArray<isize> block_offsets(num_blocks + 1, isize{0}, alloc);
+
+    auto const count_accepted = [&](isize const b, isize const begin, isize const end) {
+        isize count = 0;
+
+        for (isize i = begin; i < end; ++i)
+        {
+            bool const accept = pred(values[i]);
+            flags[i] = u8(accept);
+            count += accept;
+        }
+
+        block_offsets[b + 1] = count;
+    };
+
+    exec.parallel_for_blocks(n, count_accepted);
+
+    for (isize b = 1; b <= num_blocks; ++b)
+        block_offsets[b] += block_offsets[b - 1];
+
+    isize const num_accepted = block_offsets[num_blocks];
+
+    auto const scatter = [&](isize const b, isize const begin, isize const end) {
+        isize accepted = block_offsets[b];
+        isize rejected = num_accepted + begin - block_offsets[b];
+
+        for (isize i = begin; i < end; ++i)
+        {
+            if (flags[i])
+                result[accepted++] = values[i];
+            else
+                result[rejected++] = values[i];
+        }
+    };
+
+    exec.parallel_for_blocks(n, scatter);
+
+    return num_accepted;
+}
+
+} // namespace dr
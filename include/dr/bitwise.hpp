@@ -80,6 +80,172 @@ constexpr Nat prev_pow2(Nat x)
     return x ^ (x >> 1);
 }
 
+/// Returns the base 2 logarithm of the given value rounded down to the nearest integer
+template <typename Nat>
+constexpr u8 log2_floor(Nat const x)
+{
+    static_assert(is_natural<Nat>);
+
+    assert(x != 0);
+    return u8(63 - __builtin_clzll(u64(x)));
+}
+
+/// Returns the number of trailing zeros in the binary representation of the given value
+template <typename Nat>
+constexpr u8 trailing_zeros(Nat const x)
+{
+    static_assert(is_natural<Nat>);
+
+    assert(x != 0);
+    return u8(__builtin_ctzll(u64(x)));
+}
+
+namespace impl
+{
+
+/// Spreads the lower 32 bits of the given value such that each bit is followed by a zero
+constexpr u64 morton_spread2(u64 x)
+{
+    x &= 0xffffffff;
+    x = (x | x << 16) & 0x0000ffff0000ffff;
+    x = (x | x << 8) & 0x00ff00ff00ff00ff;
+    x = (x | x << 4) & 0x0f0f0f0f0f0f0f0f;
+    x = (x | x << 2) & 0x3333333333333333;
+    x = (x | x << 1) & 0x5555555555555555;
+    return x;
+}
+
+/// Inverse of morton_spread2
+constexpr u32 morton_compact2(u64 x)
+{
+    x &= 0x5555555555555555;
+    x = (x ^ (x >> 1)) & 0x3333333333333333;
+    x = (x ^ (x >> 2)) & 0x0f0f0f0f0f0f0f0f;
+    x = (x ^ (x >> 4)) & 0x00ff00ff00ff00ff;
+    x = (x ^ (x >> 8)) & 0x0000ffff0000ffff;
+    x = (x ^ (x >> 16)) & 0xffffffff;
+    return u32(x);
+}
+
+/// Spreads the lower 21 bits of the given value such that each bit is followed by 2 zeros
+constexpr u64 morton_spread3(u64 x)
+{
+    x &= 0x1fffff;
+    x = (x | x << 32) & 0x1f00000000ffff;
+    x = (x | x << 16) & 0x1f0000ff0000ff;
+    x = (x | x << 8) & 0x100f00f00f00f00f;
+    x = (x | x << 4) & 0x10c30c30c30c30c3;
+    x = (x | x << 2) & 0x1249249249249249;
+    return x;
+}
+
+/// Inverse of morton_spread3
+constexpr u32 morton_compact3(u64 x)
+{
+    x &= 0x1249249249249249;
+    x = (x ^ (x >> 2)) & 0x10c30c30c30c30c3;
+    x = (x ^ (x >> 4)) & 0x100f00f00f00f00f;
+    x = (x ^ (x >> 8)) & 0x1f0000ff0000ff;
+    x = (x ^ (x >> 16)) & 0x1f00000000ffff;
+    x = (x ^ (x >> 32)) & 0x1fffff;
+    return u32(x);
+}
+
+/// Transforms grid coordinates in place such that interleaving their bits (with the first
+/// coordinate as the most significant) produces a Hilbert code with the given number of bits per
+/// coordinate.
+template <int dim>
+constexpr void hilbert_transpose(u32 (&x)[dim], u8 const num_bits)
+{
+    // Impl ref
+    // https://doi.org/10.1063/1.1751381 (Skilling 2004)
+
+    assert(num_bits > 0 && num_bits <= 32);
+    u32 const m = u32{1} << (num_bits - 1);
+
+    // Inverse undo
+    for (u32 q = m; q > 1; q >>= 1)
+    {
+        u32 const p = q - 1;
+
+        for (int i = 0; i < dim; ++i)
+        {
+            if (x[i] & q)
+            {
+                x[0] ^= p;
+            }
+            else
+            {
+                u32 const t = (x[0] ^ x[i]) & p;
+                x[0] ^= t;
+                x[i] ^= t;
+            }
+        }
+    }
+
+    // Gray encode
+    for (int i = 1; i < dim; ++i)
+        x[i] ^= x[i - 1];
+
+    u32 t = 0;
+    for (u32 q = m; q > 1; q >>= 1)
+    {
+        if (x[dim - 1] & q)
+            t ^= q - 1;
+    }
+
+    for (int i = 0; i < dim; ++i)
+        x[i] ^= t;
+}
+
+} // namespace impl
+
+/// Interleaves the bits of the given coordinates to produce a 2D Morton code
+constexpr u64 morton_encode(u32 const x, u32 const y)
+{
+    return impl::morton_spread2(x) | (impl::morton_spread2(y) << 1);
+}
+
+/// Recovers the coordinates from a 2D Morton code
+constexpr void morton_decode(u64 const code, u32 (&result)[2])
+{
+    result[0] = impl::morton_compact2(code);
+    result[1] = impl::morton_compact2(code >> 1);
+}
+
+/// Interleaves the bits of the given coordinates to produce a 3D Morton code. Only the lower 21
+/// bits of each coordinate are used.
+constexpr u64 morton_encode(u32 const x, u32 const y, u32 const z)
+{
+    return impl::morton_spread3(x) | (impl::morton_spread3(y) << 1)
+        | (impl::morton_spread3(z) << 2);
+}
+
+/// Recovers the coordinates from a 3D Morton code
+constexpr void morton_decode(u64 const code, u32 (&result)[3])
+{
+    result[0] = impl::morton_compact3(code);
+    result[1] = impl::morton_compact3(code >> 1);
+    result[2] = impl::morton_compact3(code >> 2);
+}
+
+/// Returns the index of the given coordinates along a 2D Hilbert curve
+constexpr u64 hilbert_encode(u32 const x, u32 const y)
+{
+    u32 t[]{x, y};
+    impl::hilbert_transpose(t, 32);
+    return morton_encode(t[1], t[0]);
+}
+
+/// Returns the index of the given coordinates along a 3D Hilbert curve. Only the lower 21 bits of
+/// each coordinate are used.
+constexpr u64 hilbert_encode(u32 const x, u32 const y, u32 const z)
+{
+    u32 t[]{x & 0x1fffff, y & 0x1fffff, z & 0x1fffff};
+    impl::hilbert_transpose(t, 21);
+    return morton_encode(t[2], t[1], t[0]);
+}
+
 template <typename Scalar>
 constexpr void unit_square_corner(u8 const index, Scalar result[2])
 {
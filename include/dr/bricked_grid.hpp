@@ -0,0 +1,171 @@
+#pragma once
+
+#include <cassert>
+
+#include <dr/container_utils.hpp>
+#include <dr/dynamic_array.hpp>
+#include <dr/executor.hpp>
+#include <dr/grid.hpp>
+#include <dr/math_types.hpp>
+#include <dr/memory.hpp>
+#include <dr/span.hpp>
+
+namespace dr
+{
+
+/// Dense 3D array of values stored in the bricked layout (see bricked_grid_to_index). Unlike the
+/// row-major layout, grid points which are close to each other are also close in memory which
+/// benefits neighborhood operations (finite differences, sampling, smoothing, etc.) on large
+/// grids.
+template <typename T>
+struct BrickedGrid : AllocatorAware
+{
+    BrickedGrid(Allocator const alloc = {}) : values_(alloc) {}
+
+    BrickedGrid(Vec3<isize> const& shape, T const& value = {}, Allocator const alloc = {}) :
+        values_(alloc)
+    {
+        resize(shape, value);
+    }
+
+    BrickedGrid(BrickedGrid const& other, Allocator const alloc = {}) :
+        values_(other.values_, alloc),
+        shape_(other.shape_),
+        brick_stride_(other.brick_stride_)
+    {
+    }
+
+    BrickedGrid(BrickedGrid&& other) noexcept = default;
+    BrickedGrid& operator=(BrickedGrid const& other) = default;
+    BrickedGrid& operator=(BrickedGrid&& other) = default;
+
+    /// Returns the allocator used by this container
+    Allocator allocator() const { return values_.get_allocator(); }
+
+    /// Returns the number of grid points along each axis
+    Vec3<isize> const& shape() const { return shape_; }
+
+    /// Returns the number of bricks along each axis
+    Vec3<isize> brick_count() const { return grid_brick_count(shape_); }
+
+    /// Returns the stride between bricks along each axis
+    Vec3<isize> const& brick_stride() const { return brick_stride_; }
+
+    /// Returns the number of bricks
+    isize num_bricks() const { return size(values_) / grid_brick_size; }
+
+    /// Resizes the grid. Existing values are discarded.
+    void resize(Vec3<isize> const& shape, T const& value = {})
+    {
+        assert((shape.array() >= 0).all());
+        shape_ = shape;
+        brick_stride_ = grid_stride(grid_brick_count(shape));
+
+        values_.clear();
+        values_.resize(grid_brick_count(shape).prod() * grid_brick_size, value);
+    }
+
+    /// Returns the index of the given grid point
+    isize to_index(Vec3<isize> const& grid_pt) const
+    {
+        assert(contains(grid_pt));
+        return bricked_grid_to_index(grid_pt, brick_stride_);
+    }
+
+    /// Returns the grid point at the given index
+    Vec3<isize> to_grid(isize const index) const
+    {
+        return bricked_index_to_grid(index, brick_stride_);
+    }
+
+    /// Returns true if the given grid point is within the grid
+    bool contains(Vec3<isize> const& grid_pt) const
+    {
+        return (grid_pt.array() >= 0).all() && (grid_pt.array() < shape_.array()).all();
+    }
+
+    /// Returns the value at the given grid point
+    T& operator[](Vec3<isize> const& grid_pt) { return values_[to_index(grid_pt)]; }
+
+    /// Returns the value at the given grid point
+    T const& operator[](Vec3<isize> const& grid_pt) const { return values_[to_index(grid_pt)]; }
+
+    /// Returns all values in storage order. This includes padding in bricks that extend past the
+    /// boundary of the grid.
+    Span<T> values() { return as_span(values_); }
+
+    /// Returns all values in storage order. This includes padding in bricks that extend past the
+    /// boundary of the grid.
+    Span<T const> values() const { return as_span(values_); }
+
+    /// Returns the values of the brick at the given index in storage order
+    Span<T> brick(isize const index)
+    {
+        assert(index >= 0 && index < num_bricks());
+        return as_span(values_).segment(index * grid_brick_size, grid_brick_size);
+    }
+
+    /// Returns the values of the brick at the given index in storage order
+    Span<T const> brick(isize const index) const
+    {
+        return const_cast<BrickedGrid<T>&>(*this).brick(index);
+    }
+
+    /// Copies values from the row-major layout (see grid_to_index)
+    void assign(Span<T const> const& values, Executor const exec = {})
+    {
+        assert(values.size() == shape_.prod());
+        Vec3<isize> const stride = grid_stride(shape_);
+
+        for_each_brick_point(exec, [&](isize const index, Vec3<isize> const& grid_pt) {
+            values_[index] = values[grid_to_index(grid_pt, stride)];
+        });
+    }
+
+    /// Copies values to the row-major layout (see grid_to_index)
+    void copy_to(Span<T> const& result, Executor const exec = {}) const
+    {
+        assert(result.size() == shape_.prod());
+        Vec3<isize> const stride = grid_stride(shape_);
+
+        for_each_brick_point(exec, [&](isize const index, Vec3<isize> const& grid_pt) {
+            result[grid_to_index(grid_pt, stride)] = values_[index];
+        });
+    }
+
+  private:
+    DynamicArray<T> values_;
+    Vec3<isize> shape_{};
+    Vec3<isize> brick_stride_{};
+
+    /// Calls the given function with the index and grid point of each point in the grid
+    template <typename Fn>
+    void for_each_brick_point(Executor const exec, Fn&& fn) const
+    {
+        constexpr isize w = grid_brick_width;
+        Vec3<isize> const brick_count = grid_brick_count(shape_);
+
+        auto const loop_body = [&](isize const b) {
+            Vec3<isize> const origin = index_to_grid(b, brick_stride_) * w;
+            Vec3<isize> const end = (origin.array() + w).min(shape_.array());
+
+            for (isize k = origin[2]; k < end[2]; ++k)
+            {
+                for (isize j = origin[1]; j < end[1]; ++j)
+                {
+                    for (isize i = origin[0]; i < end[0]; ++i)
+                    {
+                        Vec3<isize> const grid_pt{i, j, k};
+                        fn(bricked_grid_to_index(grid_pt, brick_stride_), grid_pt);
+                    }
+                }
+            }
+        };
+
+        isize const n = brick_count.prod();
+
+        exec.parallel_for(n, loop_body);
+    }
+};
+
+} // namespace dr
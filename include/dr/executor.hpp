@@ -0,0 +1,342 @@
+#pragma once
+
+/*
+    Execution policies for parallel kernels. Kernels take an Executor which decides where their
+    work runs: serially, on OpenMP threads, on the built-in ThreadPool or on a user-supplied
+    ExecutionResource (e.g. a pool owned by the host application).
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include <dr/allocator.hpp>
+#include <dr/basic_types.hpp>
+#include <dr/container_utils.hpp>
+#include <dr/dynamic_array.hpp>
+#include <dr/function.hpp>
+#include <dr/function_ref.hpp>
+#include <dr/shim/omp.hpp>
+
+namespace dr
+{
+
+/// Runs batches of tasks on behalf of an executor. Derive from this to run library kernels on an
+/// external thread pool.
+struct ExecutionResource
+{
+    virtual ~ExecutionResource() = default;
+
+    /// Returns the maximum number of tasks that may run concurrently
+    virtual isize concurrency() const = 0;
+
+    /// Calls `fn(i)` for each i in [0, num_tasks) and returns once all calls have completed. Calls
+    /// may run concurrently and in any order.
+    virtual void run(isize num_tasks, FunctionRef<void(isize)> fn) = 0;
+
+    /// Calls `fn(begin, end)` for disjoint ranges of at most grain_size items which cover [0,
+    /// count) and returns once all calls have completed. Resources which can split ranges on
+    /// demand should override this. By default, ranges are run as individual tasks.
+    virtual void run_ranges(isize count, isize grain_size, FunctionRef<void(isize, isize)> fn)
+    {
+        auto const run_range = [&](isize const i) {
+            isize const begin = i * grain_size;
+            fn(begin, std::min(begin + grain_size, count));
+        };
+
+        run((count + grain_size - 1) / grain_size, &run_range);
+    }
+};
+
+/// Built-in work-stealing pool of worker threads. Each thread owns a Chase-Lev deque of index
+/// ranges. A thread splits the range it's working on in half, pushes the back half onto its deque
+/// and continues with the front half, so idle threads can steal the largest pending piece of a
+/// busy thread's work. This balances loops whose per-item cost is uneven without having to pick a
+/// chunk size up front.
+///
+/// The thread calling run also participates. Calls to run from a task already running on the pool
+/// are executed serially on the calling thread to avoid oversubscription. Threads which can't find
+/// work spin briefly then sleep until more work is pushed or the job completes.
+struct ThreadPool final : ExecutionResource, AllocatorAware
+{
+    /// Creates a pool which runs up to the given number of tasks concurrently (including the
+    /// calling thread)
+    explicit ThreadPool(
+        isize num_threads = std::thread::hardware_concurrency(),
+        Allocator alloc = {});
+
+    ThreadPool(ThreadPool const& other) = delete;
+    ThreadPool& operator=(ThreadPool const& other) = delete;
+
+    ~ThreadPool();
+
+    /// Returns the allocator used by this instance
+    Allocator allocator() const;
+
+    isize concurrency() const override;
+
+    void run(isize num_tasks, FunctionRef<void(isize)> fn) override;
+
+    void run_ranges(isize count, isize grain_size, FunctionRef<void(isize, isize)> fn) override;
+
+  private:
+    struct Deque;
+
+    // One deque per thread. The calling thread uses the first.
+    DynamicArray<Deque> deques_;
+    DynamicArray<std::thread> workers_;
+
+    // Serializes calls to run from different external threads
+    std::mutex run_mutex_;
+
+    // Guards the fields below
+    std::mutex mutex_;
+    std::condition_variable job_ready_;
+    std::condition_variable job_done_;
+    FunctionRef<void(isize, isize)> job_fn_;
+    isize job_grain_size_{};
+    u64 job_id_{};
+    isize num_busy_{};
+    bool stop_{};
+
+    // Signalled when work is pushed or the current job completes while threads are idle. Guarded
+    // by mutex_.
+    std::condition_variable work_ready_;
+    u64 wake_id_{};
+
+    // Number of items in the current job which haven't been processed yet
+    std::atomic<isize> num_remaining_{};
+
+    // Number of threads sleeping on work_ready_ (or about to)
+    std::atomic<isize> num_idle_{};
+
+    void work(isize thread, isize grain_size, FunctionRef<void(isize, isize)> fn);
+    void wait_for_work(isize thread);
+    void wake_idle();
+    void worker_loop(isize thread);
+};
+
+/// Non-owning handle which determines how parallel kernels execute. Executors are cheap to copy.
+struct Executor
+{
+    /// Creates an executor which runs everything on the calling thread
+    constexpr Executor() = default;
+
+    /// Creates an executor which runs on up to the given number of OpenMP threads. Falls back to
+    /// serial execution if OpenMP is unavailable or if called from within an OpenMP parallel
+    /// region.
+    explicit constexpr Executor(isize const num_threads) : num_threads_{num_threads} {}
+
+    /// Creates an executor which runs on the given resource
+    constexpr Executor(ExecutionResource& resource) : resource_{&resource} {}
+
+    /// Returns the resource used by this executor or nullptr if it uses OpenMP or runs serially
+    ExecutionResource* resource() const { return resource_; }
+
+    /// Returns the maximum number of tasks that may run concurrently
+    isize concurrency() const
+    {
+        if (resource_)
+            return std::max<isize>(resource_->concurrency(), 1);
+
+#ifdef _OPENMP
+        return std::max<isize>(num_threads_, 1);
+#else
+        return 1;
+#endif
+    }
+
+    /// Returns the number of blocks used by parallel_for_blocks for the given number of items
+    isize num_blocks(isize const count) const
+    {
+        return std::max<isize>(std::min(concurrency(), count), 1);
+    }
+
+    /// Returns the grain size used by parallel_for_ranges when none is given. This leaves several
+    /// ranges per concurrent task to balance between.
+    isize default_grain_size(isize const count) const
+    {
+        constexpr isize ranges_per_task = 8;
+        return std::max<isize>(count / (concurrency() * ranges_per_task), 1);
+    }
+
+    /// Calls `fn(i)` for each i in [0, num_tasks). Tasks are scheduled dynamically so this is
+    /// suited to a modest number of tasks with uneven cost.
+    template <typename Fn>
+    void run(isize const num_tasks, Fn&& fn) const
+    {
+        static_assert(std::is_invocable_v<Fn, isize>);
+
+        if (num_tasks <= 1 || concurrency() <= 1)
+        {
+            for (isize i = 0; i < num_tasks; ++i)
+                fn(i);
+        }
+        else if (resource_)
+        {
+            resource_->run(num_tasks, &fn);
+        }
+        else
+        {
+            if (omp_in_parallel())
+            {
+                for (isize i = 0; i < num_tasks; ++i)
+                    fn(i);
+            }
+            else
+            {
+#pragma omp parallel for num_threads(std::min(num_threads_, num_tasks)) schedule(dynamic)
+                for (isize i = 0; i < num_tasks; ++i)
+                    fn(i);
+            }
+        }
+    }
+
+    /// Calls `fn(block, begin, end)` for each of num_blocks(count) contiguous blocks of the range
+    /// [0, count)
+    template <typename Fn>
+    void parallel_for_blocks(isize const count, Fn&& fn) const
+    {
+        static_assert(std::is_invocable_v<Fn, isize, isize, isize>);
+        isize const num_blocks = this->num_blocks(count);
+
+        run(num_blocks, [&](isize const b) {
+            fn(b, count * b / num_blocks, count * (b + 1) / num_blocks);
+        });
+    }
+
+    /// Calls `fn(i)` for each i in [0, count). The range is split into one contiguous block per
+    /// concurrent task.
+    template <typename Fn>
+    void parallel_for(isize const count, Fn&& fn) const
+    {
+        static_assert(std::is_invocable_v<Fn, isize>);
+
+        parallel_for_blocks(count, [&](isize, isize const begin, isize const end) {
+            for (isize i = begin; i < end; ++i)
+                fn(i);
+        });
+    }
+
+    /// Calls `fn(begin, end)` for disjoint ranges of at most grain_size items which cover [0,
+    /// count). Unlike parallel_for, ranges are handed out on demand (and split on demand by
+    /// resources which support it) so this is suited to loops whose per-item cost is uneven. A
+    /// grain size of 0 selects default_grain_size(count).
+    template <typename Fn>
+    void parallel_for_ranges(isize const count, Fn&& fn, isize grain_size = 0) const
+    {
+        static_assert(std::is_invocable_v<Fn, isize, isize>);
+        assert(grain_size >= 0);
+
+        if (count <= 0)
+            return;
+
+        if (grain_size == 0)
+            grain_size = default_grain_size(count);
+
+        if (resource_ && concurrency() > 1)
+        {
+            resource_->run_ranges(count, grain_size, &fn);
+        }
+        else
+        {
+            run((count + grain_size - 1) / grain_size, [&](isize const i) {
+                isize const begin = i * grain_size;
+                fn(begin, std::min(begin + grain_size, count));
+            });
+        }
+    }
+
+    /// Calls `fn(i)` for each i in [0, count). Items are processed in ranges handed out on demand
+    /// as in parallel_for_ranges.
+    template <typename Fn>
+    void parallel_for_dynamic(isize const count, Fn&& fn, isize const grain_size = 0) const
+    {
+        static_assert(std::is_invocable_v<Fn, isize>);
+
+        auto const loop_body = [&](isize const begin, isize const end) {
+            for (isize i = begin; i < end; ++i)
+                fn(i);
+        };
+
+        parallel_for_ranges(count, loop_body, grain_size);
+    }
+
+    /// Accumulates `map(acc, i)` for each i in [0, count) into one partial result per block then
+    /// combines partial results in block order via `reduce(acc, partial)`. Results are
+    /// deterministic for a given concurrency.
+    template <typename T, typename Map, typename Reduce>
+    T parallel_reduce(isize const count, T const& identity, Map&& map, Reduce&& reduce) const
+    {
+        static_assert(std::is_invocable_v<Map, T&, isize>);
+        static_assert(std::is_invocable_v<Reduce, T&, T const&>);
+
+        DynamicArray<T> partials(num_blocks(count), identity);
+
+        parallel_for_blocks(count, [&](isize const b, isize const begin, isize const end) {
+            T& acc = partials[b];
+            for (isize i = begin; i < end; ++i)
+                map(acc, i);
+        });
+
+        T result = std::move(partials[0]);
+        for (isize b = 1; b < size(partials); ++b)
+            reduce(result, partials[b]);
+
+        return result;
+    }
+
+  private:
+    ExecutionResource* resource_{};
+    isize num_threads_{1};
+};
+
+/// Collects tasks to be run together on an executor. Tasks are deferred: adding a task doesn't start
+/// it. All pending tasks are started by run which returns once they have completed.
+struct TaskBatch : AllocatorAware
+{
+    TaskBatch(Executor const exec = {}, Allocator const alloc = {}) :
+        exec_{exec},
+        tasks_(alloc)
+    {
+    }
+
+    TaskBatch(TaskBatch const& other) = delete;
+    TaskBatch& operator=(TaskBatch const& other) = delete;
+
+    ~TaskBatch() { assert(tasks_.empty()); }
+
+    /// Returns the allocator used by this instance
+    Allocator allocator() const { return tasks_.get_allocator(); }
+
+    /// Returns the number of tasks waiting to be run
+    isize num_pending() const { return tasks_.size(); }
+
+    /// Adds a task to the batch. The task isn't started until the next call to run.
+    template <typename Fn>
+    void add(Fn&& fn)
+    {
+        static_assert(std::is_invocable_v<Fn>);
+        tasks_.emplace_back(std::forward<Fn>(fn));
+    }
+
+    /// Runs all pending tasks and waits for them to complete
+    void run()
+    {
+        exec_.run(tasks_.size(), [&](isize const i) {
+            tasks_[i]();
+        });
+        tasks_.clear();
+    }
+
+  private:
+    Executor exec_;
+    DynamicArray<Function<void()>> tasks_;
+};
+
+} // namespace dr
@@ -44,6 +44,77 @@ Vec3<Real> nearest_point_plane(
     return point + project((plane_origin - point).eval(), plane_normal);
 }
 
+/// Returns the barycentric coords of the closest point on the given triangle
+template <typename Real>
+Vec3<Real> nearest_point_tri(
+    Vec3<Real> const& point,
+    Vec3<Real> const& tri_a,
+    Vec3<Real> const& tri_b,
+    Vec3<Real> const& tri_c)
+{
+    // Impl ref
+    // Real-Time Collision Detection, Ericson (section 5.1.5)
+
+    static_assert(is_real<Real>);
+
+    Vec3<Real> const ab = tri_b - tri_a;
+    Vec3<Real> const ac = tri_c - tri_a;
+
+    // Check vertex region of a
+    Vec3<Real> const ap = point - tri_a;
+    Real const d1 = ab.dot(ap);
+    Real const d2 = ac.dot(ap);
+
+    if (d1 <= Real{0.0} && d2 <= Real{0.0})
+        return {Real{1.0}, Real{0.0}, Real{0.0}};
+
+    // Check vertex region of b
+    Vec3<Real> const bp = point - tri_b;
+    Real const d3 = ab.dot(bp);
+    Real const d4 = ac.dot(bp);
+
+    if (d3 >= Real{0.0} && d4 <= d3)
+        return {Real{0.0}, Real{1.0}, Real{0.0}};
+
+    // Check edge region of ab
+    Real const vc = d1 * d4 - d3 * d2;
+    if (vc <= Real{0.0} && d1 >= Real{0.0} && d3 <= Real{0.0})
+    {
+        Real const t = d1 / (d1 - d3);
+        return {Real{1.0} - t, t, Real{0.0}};
+    }
+
+    // Check vertex region of c
+    Vec3<Real> const cp = point - tri_c;
+    Real const d5 = ab.dot(cp);
+    Real const d6 = ac.dot(cp);
+
+    if (d6 >= Real{0.0} && d5 <= d6)
+        return {Real{0.0}, Real{0.0}, Real{1.0}};
+
+    // Check edge region of ac
+    Real const vb = d5 * d2 - d1 * d6;
+    if (vb <= Real{0.0} && d2 >= Real{0.0} && d6 <= Real{0.0})
+    {
+        Real const t = d2 / (d2 - d6);
+        return {Real{1.0} - t, Real{0.0}, t};
+    }
+
+    // Check edge region of bc
+    Real const va = d3 * d6 - d5 * d4;
+    if (va <= Real{0.0} && (d4 - d3) >= Real{0.0} && (d5 - d6) >= Real{0.0})
+    {
+        Real const t = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+        return {Real{0.0}, Real{1.0} - t, t};
+    }
+
+    // Point projects inside the triangle
+    Real const denom = Real{1.0} / (va + vb + vc);
+    Real const v = vb * denom;
+    Real const w = vc * denom;
+    return {Real{1.0} - v - w, v, w};
+}
+
 /// Returns parameters of the closest pair of points on the given lines
 template <typename Real>
 Vec2<Real> nearest_line_line(
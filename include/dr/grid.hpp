@@ -1,5 +1,8 @@
 #pragma once
 
+#include <cassert>
+
+#include <dr/bitwise.hpp>
 #include <dr/math_types.hpp>
 
 namespace dr
@@ -38,6 +41,66 @@ Vec<Index, dim> index_to_grid(Index index, Vec<Index, dim> const& stride)
     return result;
 }
 
+/// Memory layouts for values defined on a grid
+enum GridLayout : u8
+{
+    GridLayout_RowMajor = 0, // See grid_to_index
+    GridLayout_Bricked, // See bricked_grid_to_index
+    _GridLayout_Count
+};
+
+/// Number of grid points along each axis of a brick in the bricked layout
+constexpr isize grid_brick_width = 8;
+
+/// Number of grid points in a brick in the bricked layout
+constexpr isize grid_brick_size = grid_brick_width * grid_brick_width * grid_brick_width;
+
+/// Returns the number of bricks along each axis needed to cover a grid of the given shape
+template <typename Index>
+Vec<Index, 3> grid_brick_count(Vec<Index, 3> const& shape)
+{
+    constexpr Index w = grid_brick_width;
+    return (shape.array() + (w - 1)) / w;
+}
+
+/// Returns the contribution of a single coordinate to the index of a grid point in the bricked
+/// layout. The index of a grid point is the sum of the contributions of each of its coordinates.
+template <typename Index>
+Index bricked_grid_offset(Index const coord, int const axis, Index const brick_stride)
+{
+    constexpr Index w = grid_brick_width;
+    constexpr Index n = grid_brick_size;
+
+    assert(coord >= 0);
+    return (coord / w) * brick_stride * n + Index(impl::morton_spread3(u64(coord % w)) << axis);
+}
+
+/// Maps a grid point to an index in the bricked layout. The grid is divided into bricks of
+/// grid_brick_width points along each axis. Bricks are stored contiguously in row-major order
+/// and points within each brick are stored in Morton order. Brick stride is given by
+/// grid_stride(grid_brick_count(shape)).
+template <typename Index>
+Index bricked_grid_to_index(Vec<Index, 3> const& point, Vec<Index, 3> const& brick_stride)
+{
+    return bricked_grid_offset(point[0], 0, brick_stride[0])
+        + bricked_grid_offset(point[1], 1, brick_stride[1])
+        + bricked_grid_offset(point[2], 2, brick_stride[2]);
+}
+
+/// Maps an index in the bricked layout to a grid point. Inverse of bricked_grid_to_index.
+template <typename Index>
+Vec<Index, 3> bricked_index_to_grid(Index const index, Vec<Index, 3> const& brick_stride)
+{
+    constexpr Index w = grid_brick_width;
+    constexpr Index n = grid_brick_size;
+
+    u32 local[3];
+    morton_decode(u64(index % n), local);
+
+    return index_to_grid(index / n, brick_stride) * w
+        + Vec<Index, 3>{Index(local[0]), Index(local[1]), Index(local[2])};
+}
+
 template <typename Scalar, int dim>
 struct Grid
 {
@@ -0,0 +1,339 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+
+#include <dr/basic_traits.hpp>
+#include <dr/executor.hpp>
+#include <dr/grid.hpp>
+#include <dr/math_types.hpp>
+#include <dr/span.hpp>
+#include <dr/spline.hpp>
+
+namespace dr
+{
+
+enum GridFilter : u8
+{
+    GridFilter_Linear = 0,
+    GridFilter_Cubic,
+    _GridFilter_Count
+};
+
+/// Scalar field defined at the vertices of a 3D grid. Values are stored in either the row-major
+/// or bricked layout. Points outside of the grid are clamped to its boundary.
+template <typename Real>
+struct GridField
+{
+    Grid3<Real> grid;
+    Span<Real const> values;
+    GridLayout layout{GridLayout_RowMajor};
+
+    /// Returns the number of values expected for the grid's shape and layout
+    isize num_values() const
+    {
+        if (layout == GridLayout_Bricked)
+            return grid_brick_count(grid.shape).prod() * grid_brick_size;
+        else
+            return grid.shape.prod();
+    }
+
+    /// Evaluates the field at the given point
+    Real sample(Vec3<Real> const& point, GridFilter filter) const;
+
+    /// Evaluates the field and its gradient at the given point
+    Real sample(Vec3<Real> const& point, GridFilter filter, Vec3<Real>& gradient) const;
+};
+
+namespace impl
+{
+
+/// Number of points evaluated together in each batch
+constexpr isize grid_sample_batch_size = 16;
+
+/// Number of points binned together in each chunk
+constexpr isize grid_sample_chunk_size = 1024;
+
+/// Width of the bins used to sort points within a chunk (in cells)
+constexpr isize grid_sample_bin_width = 8;
+
+template <typename Real>
+Vec3<isize> grid_cell(Grid3<Real> const& grid, Vec3<Real> const& grid_pt, Vec3<Real>& t)
+{
+    Vec3<isize> result;
+
+    for (int i = 0; i < 3; ++i)
+    {
+        isize const last = grid.shape[i] - 1;
+        Real const x = std::clamp(grid_pt[i], Real{0.0}, Real(last));
+        result[i] = std::min(isize(x), std::max<isize>(last - 1, 0));
+        t[i] = x - Real(result[i]);
+    }
+
+    return result;
+}
+
+/// Evaluates a batch of points using the given basis. Corner values are gathered into a
+/// structure-of-arrays layout so that accumulation vectorizes across the batch.
+template <typename Basis, bool with_gradient, isize batch_size, typename Real>
+void grid_sample_batch(
+    GridField<Real> const& field,
+    Span<Vec3<Real> const> const& points,
+    isize const* const point_indices,
+    isize const count,
+    Span<Real> const& values,
+    Span<Vec3<Real>> const& gradients)
+{
+    using Diff = typename Basis::template Diff<1>;
+    constexpr isize n = Basis::size;
+    constexpr isize offset = (n - 2) / 2;
+    assert(count <= batch_size);
+
+    Grid3<Real> const& grid = field.grid;
+    bool const is_bricked = (field.layout == GridLayout_Bricked);
+    Vec3<isize> const stride = is_bricked ? grid_stride(grid_brick_count(grid.shape))
+                                          : grid.stride();
+
+    Real b[3][n][batch_size]{};
+    Real db[3][n][batch_size]{};
+    Real coeffs[n * n * n][batch_size]{};
+
+    // Evaluate bases and gather corner values
+    for (isize k = 0; k < count; ++k)
+    {
+        Vec3<Real> t;
+        Vec3<isize> const cell = grid_cell(grid, grid.to_grid(points[point_indices[k]]), t);
+        isize corners[3][n];
+
+        for (int i = 0; i < 3; ++i)
+        {
+            Real tmp[n];
+            Basis::eval(t[i], tmp);
+
+            for (isize j = 0; j < n; ++j)
+                b[i][j][k] = tmp[j];
+
+            if constexpr (with_gradient)
+            {
+                Diff::eval(t[i], tmp);
+
+                for (isize j = 0; j < n; ++j)
+                    db[i][j][k] = tmp[j];
+            }
+
+            isize const last = grid.shape[i] - 1;
+            for (isize j = 0; j < n; ++j)
+            {
+                isize const x = std::clamp<isize>(cell[i] - offset + j, 0, last);
+                corners[i][j] = is_bricked ? bricked_grid_offset(x, i, stride[i]) : x * stride[i];
+            }
+        }
+
+        Real* c = &coeffs[0][k];
+        for (isize w = 0; w < n; ++w)
+        {
+            for (isize v = 0; v < n; ++v)
+            {
+                isize const vw = corners[1][v] + corners[2][w];
+                for (isize u = 0; u < n; ++u, c += batch_size)
+                    *c = field.values[corners[0][u] + vw];
+            }
+        }
+    }
+
+    // Accumulate
+    Real val[batch_size]{};
+    Real grad[3][batch_size]{};
+    Real const* c = coeffs[0];
+
+    for (isize w = 0; w < n; ++w)
+    {
+        for (isize v = 0; v < n; ++v)
+        {
+            for (isize u = 0; u < n; ++u, c += batch_size)
+            {
+                for (isize k = 0; k < batch_size; ++k)
+                {
+                    Real const b_vw = b[1][v][k] * b[2][w][k];
+                    val[k] += c[k] * b[0][u][k] * b_vw;
+
+                    if constexpr (with_gradient)
+                    {
+                        grad[0][k] += c[k] * db[0][u][k] * b_vw;
+                        grad[1][k] += c[k] * b[0][u][k] * db[1][v][k] * b[2][w][k];
+                        grad[2][k] += c[k] * b[0][u][k] * b[1][v][k] * db[2][w][k];
+                    }
+                }
+            }
+        }
+    }
+
+    for (isize k = 0; k < count; ++k)
+    {
+        isize const index = point_indices[k];
+        values[index] = val[k];
+
+        // Convert from grid to world coordinates
+        if constexpr (with_gradient)
+        {
+            gradients[index] = Vec3<Real>{grad[0][k], grad[1][k], grad[2][k]}.array()
+                / grid.spacing.array();
+        }
+    }
+}
+
+template <bool with_gradient, isize batch_size, typename Real>
+void grid_sample_batch(
+    GridField<Real> const& field,
+    GridFilter const filter,
+    Span<Vec3<Real> const> const& points,
+    isize const* const point_indices,
+    isize const count,
+    Span<Real> const& values,
+    Span<Vec3<Real>> const& gradients)
+{
+    switch (filter)
+    {
+        case GridFilter_Linear:
+        {
+            grid_sample_batch<LinearBasis, with_gradient, batch_size>(
+                field,
+                points,
+                point_indices,
+                count,
+                values,
+                gradients);
+            break;
+        }
+        case GridFilter_Cubic:
+        {
+            grid_sample_batch<CatmullRomBasis, with_gradient, batch_size>(
+                field,
+                points,
+                point_indices,
+                count,
+                values,
+                gradients);
+            break;
+        }
+        default:
+        {
+            assert(false);
+        }
+    }
+}
+
+} // namespace impl
+
+template <typename Real>
+Real GridField<Real>::sample(Vec3<Real> const& point, GridFilter const filter) const
+{
+    isize const index = 0;
+    Real result;
+    impl::grid_sample_batch<false, 1>(*this, filter, {&point, 1}, &index, 1, {&result, 1}, {});
+    return result;
+}
+
+template <typename Real>
+Real GridField<Real>::sample(
+    Vec3<Real> const& point,
+    GridFilter const filter,
+    Vec3<Real>& gradient) const
+{
+    isize const index = 0;
+    Real result;
+    impl::grid_sample_batch<true, 1>(
+        *this,
+        filter,
+        {&point, 1},
+        &index,
+        1,
+        {&result, 1},
+        {&gradient, 1});
+
+    return result;
+}
+
+/// Evaluates a grid field at the given points and optionally its gradient. Points are processed
+/// in chunks, each of which is sorted by grid cell before evaluation for cache-coherent access to
+/// field values.
+template <typename Real>
+void sample_field(
+    GridField<Real> const& field,
+    GridFilter const filter,
+    Span<Vec3<Real> const> const& points,
+    Span<Real> const& values,
+    Span<Vec3<Real>> const& gradients = {},
+    Executor const exec = {})
+{
+    static_assert(is_real<Real>);
+
+    constexpr isize chunk_size = impl::grid_sample_chunk_size;
+    constexpr isize batch_size = impl::grid_sample_batch_size;
+    constexpr isize bin_width = impl::grid_sample_bin_width;
+
+    assert(field.values.size() == field.num_values());
+    assert(values.size() == points.size());
+    assert(!gradients.is_valid() || gradients.size() == points.size());
+
+    isize const num_points = points.size();
+    isize const num_chunks = (num_points + chunk_size - 1) / chunk_size;
+
+    Grid3<Real> const& grid = field.grid;
+    Vec3<isize> const num_bins = (grid.shape.array() + (bin_width - 1)) / bin_width;
+    Vec3<isize> const bin_stride = grid_stride(num_bins);
+
+    auto const loop_body = [&](isize const chunk) {
+        isize const start = chunk * chunk_size;
+        isize const count = std::min(chunk_size, num_points - start);
+
+        // Sort points in the chunk by bin
+        isize keys[chunk_size];
+        isize order[chunk_size];
+
+        for (isize i = 0; i < count; ++i)
+        {
+            Vec3<Real> t;
+            Vec3<isize> const cell = impl::grid_cell(grid, grid.to_grid(points[start + i]), t);
+            keys[i] = grid_to_index((cell / bin_width).eval(), bin_stride);
+            order[i] = start + i;
+        }
+
+        std::sort(order, order + count, [&](isize const a, isize const b) {
+            return keys[a - start] < keys[b - start];
+        });
+
+        // Evaluate in batches
+        for (isize i = 0; i < count; i += batch_size)
+        {
+            isize const n = std::min(batch_size, count - i);
+
+            if (gradients.is_valid())
+            {
+                impl::grid_sample_batch<true, batch_size>(
+                    field,
+                    filter,
+                    points,
+                    order + i,
+                    n,
+                    values,
+                    gradients);
+            }
+            else
+            {
+                impl::grid_sample_batch<false, batch_size>(
+                    field,
+                    filter,
+                    points,
+                    order + i,
+                    n,
+                    values,
+                    gradients);
+            }
+        }
+    };
+
+    exec.parallel_for(num_chunks, loop_body);
+}
+
+} // namespace dr
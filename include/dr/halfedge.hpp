@@ -14,6 +14,8 @@
 namespace dr
 {
 
+struct MeshArchive;
+
 struct HalfedgeMesh : AllocatorAware
 {
     using Index = i32;
@@ -364,6 +366,8 @@ struct HalfedgeMesh : AllocatorAware
     HoleCirculator circulate_hole(Halfedge const he) const { return {*this, he}; }
 
   private:
+    friend struct MeshArchive;
+
     static constexpr Index invalid_index_{-1};
 
     DynamicArray<Index> hedge_next_;
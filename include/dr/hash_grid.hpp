@@ -2,6 +2,7 @@
 
 #include <type_traits>
 
+#include <dr/basic_traits.hpp>
 #include <dr/container_utils.hpp>
 #include <dr/dynamic_array.hpp>
 #include <dr/geometry_types.hpp>
@@ -12,6 +13,34 @@
 namespace dr
 {
 
+/// Hash function for integer grid cell coordinates
+struct GridCellHash
+{
+    // Impl ref
+    // http://matthias-mueller-fischer.ch/publications/tetraederCollision.pdf
+
+    static constexpr usize primes[]{73856093, 19349663, 83492791};
+
+    template <typename Index>
+    usize operator()(Vec<Index, 2> const& key) const
+    {
+        static_assert(is_integer<Index>);
+
+        // Multiply each coord with a large prime and xor together
+        return usize(key[0]) * primes[0] ^ usize(key[1]) * primes[1];
+    }
+
+    template <typename Index>
+    usize operator()(Vec<Index, 3> const& key) const
+    {
+        static_assert(is_integer<Index>);
+
+        // Multiply each coord with a large prime and xor together
+        return usize(key[0]) * primes[0] ^ usize(key[1]) * primes[1]
+            ^ usize(key[2]) * primes[2];
+    }
+};
+
 template <typename Real, int dim>
 struct HashGrid : AllocatorAware
 {
@@ -130,28 +159,7 @@ struct HashGrid : AllocatorAware
         Bucket& operator=(Bucket&& other) = default;
     };
 
-    struct KeyHash
-    {
-        // Impl ref
-        // http://matthias-mueller-fischer.ch/publications/tetraederCollision.pdf
-
-        static constexpr usize primes[]{73856093, 19349663, 83492791};
-
-        usize operator()(Vec<Index, 2> const& key) const
-        {
-            // Multiply each coord with a large prime and xor together
-            return usize(key[0]) * primes[0] ^ usize(key[1]) * primes[1];
-        }
-
-        usize operator()(Vec<Index, 3> const& key) const
-        {
-            // Multiply each coord with a large prime and xor together
-            return usize(key[0]) * primes[0] ^ usize(key[1]) * primes[1]
-                ^ usize(key[2]) * primes[2];
-        }
-    };
-
-    HashMap<Vec<Index, dim>, Bucket, KeyHash> buckets_;
+    HashMap<Vec<Index, dim>, Bucket, GridCellHash> buckets_;
     Real cell_size_{1.0};
     Real inv_cell_size_{1.0};
     isize size_{};
@@ -0,0 +1,441 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+
+#include <dr/algorithms.hpp>
+#include <dr/basic_traits.hpp>
+#include <dr/container_utils.hpp>
+#include <dr/dynamic_array.hpp>
+#include <dr/executor.hpp>
+#include <dr/grid.hpp>
+#include <dr/grid_field.hpp>
+#include <dr/math_types.hpp>
+#include <dr/memory.hpp>
+#include <dr/sliced_array.hpp>
+#include <dr/span.hpp>
+
+namespace dr
+{
+namespace impl
+{
+
+/// Number of cell layers along the z axis in each slab
+constexpr isize isosurface_slab_size = 8;
+
+/// Corners of each cube edge. Corner i is offset from the first corner by (i & 1, (i >> 1) & 1,
+/// (i >> 2) & 1) and each edge goes from its first corner in the positive direction of its axis.
+constexpr u8 marching_cubes_edges[12][2]{
+    {0, 1},
+    {2, 3},
+    {4, 5},
+    {6, 7},
+    {0, 2},
+    {1, 3},
+    {4, 6},
+    {5, 7},
+    {0, 4},
+    {1, 5},
+    {2, 6},
+    {3, 7},
+};
+
+/// Returns the triangles of the given marching cubes case as triples of cube edges. Bit i of the
+/// case is set if corner i is inside the isosurface.
+Span<u8 const> marching_cubes_tris(u8 cube_case);
+
+/// Returns the axis of the given cube edge
+constexpr int marching_cubes_edge_axis(u8 const edge) { return edge >> 2; }
+
+/// Helper for evaluating grid fields at grid points
+template <typename Real>
+struct IsosurfaceField
+{
+    GridField<Real> const& field;
+    Vec3<isize> stride;
+
+    IsosurfaceField(GridField<Real> const& field) :
+        field(field),
+        stride(
+            (field.layout == GridLayout_Bricked) ? grid_stride(grid_brick_count(field.grid.shape))
+                                                 : field.grid.stride())
+    {
+    }
+
+    Real operator()(isize const i, isize const j, isize const k) const
+    {
+        Vec3<isize> const p{i, j, k};
+
+        if (field.layout == GridLayout_Bricked)
+            return field.values[bricked_grid_to_index(p, stride)];
+        else
+            return field.values[grid_to_index(p, stride)];
+    }
+};
+
+/// Calls the given function with each grid edge which crosses the isosurface and has its first
+/// point in the given plane (i.e. constant z). Edges are visited in a fixed order.
+template <typename Real, typename Fn>
+void isosurface_plane_edges(
+    IsosurfaceField<Real> const& value,
+    Real const iso_value,
+    isize const k,
+    Fn&& fn)
+{
+    Vec3<isize> const& shape = value.field.grid.shape;
+
+    for (isize j = 0; j < shape[1]; ++j)
+    {
+        for (isize i = 0; i < shape[0]; ++i)
+        {
+            Real const v0 = value(i, j, k);
+            bool const in0 = v0 < iso_value;
+
+            if (i + 1 < shape[0])
+            {
+                Real const v1 = value(i + 1, j, k);
+                if (in0 != (v1 < iso_value))
+                    fn(i, j, 0, v0, v1);
+            }
+
+            if (j + 1 < shape[1])
+            {
+                Real const v1 = value(i, j + 1, k);
+                if (in0 != (v1 < iso_value))
+                    fn(i, j, 1, v0, v1);
+            }
+
+            if (k + 1 < shape[2])
+            {
+                Real const v1 = value(i, j, k + 1);
+                if (in0 != (v1 < iso_value))
+                    fn(i, j, 2, v0, v1);
+            }
+        }
+    }
+}
+
+/// Returns the marching cubes case of the given cell
+template <typename Real>
+u8 isosurface_cell_case(
+    IsosurfaceField<Real> const& value,
+    Real const iso_value,
+    isize const i,
+    isize const j,
+    isize const k)
+{
+    u8 result = 0;
+
+    for (u8 c = 0; c < 8; ++c)
+    {
+        if (value(i + (c & 1), j + ((c >> 1) & 1), k + ((c >> 2) & 1)) < iso_value)
+            result |= u8(1) << c;
+    }
+
+    return result;
+}
+
+/// Counts the number of vertices in each plane and the number of faces in each slab
+template <typename Real>
+void isosurface_count(
+    IsosurfaceField<Real> const& value,
+    Real const iso_value,
+    Span<isize> const& plane_counts,
+    Span<isize> const& slab_counts,
+    Executor const exec)
+{
+    Vec3<isize> const& shape = value.field.grid.shape;
+    isize const num_planes = plane_counts.size();
+    isize const num_slabs = slab_counts.size();
+
+    auto const count_plane = [&](isize const k) {
+        isize count = 0;
+        isosurface_plane_edges(value, iso_value, k, [&](auto&&...) {
+            ++count;
+        });
+        plane_counts[k] = count;
+    };
+
+    auto const count_slab = [&](isize const slab) {
+        isize const k_start = slab * isosurface_slab_size;
+        isize const k_end = std::min(k_start + isosurface_slab_size, shape[2] - 1);
+        isize count = 0;
+
+        for (isize k = k_start; k < k_end; ++k)
+        {
+            for (isize j = 0; j + 1 < shape[1]; ++j)
+            {
+                for (isize i = 0; i + 1 < shape[0]; ++i)
+                {
+                    u8 const cube_case = isosurface_cell_case(value, iso_value, i, j, k);
+                    count += marching_cubes_tris(cube_case).size() / 3;
+                }
+            }
+        }
+
+        slab_counts[slab] = count;
+    };
+
+    exec.parallel_for(num_planes, count_plane);
+    exec.parallel_for(num_slabs, count_slab);
+}
+
+/// Extracts the vertices and faces of a single slab. A slab owns the vertices on grid edges whose
+/// first point lies in one of its planes, excluding its first plane which belongs to the previous
+/// slab (except for the first slab). Faces therefore only reference vertices owned by the same or
+/// previous slabs.
+template <typename Real, typename Index>
+void isosurface_slab(
+    IsosurfaceField<Real> const& value,
+    Real const iso_value,
+    isize const slab,
+    Span<isize const> const& plane_offsets,
+    Span<Vec3<Real>> const& vertex_positions,
+    Span<Vec3<Index>> const& face_vertices,
+    DynamicArray<Index>& edge_vertices)
+{
+    Grid3<Real> const& grid = value.field.grid;
+    Vec3<isize> const& shape = grid.shape;
+
+    isize const k_start = slab * isosurface_slab_size;
+    isize const k_end = std::min(k_start + isosurface_slab_size, shape[2] - 1);
+    isize const vertex_offset = plane_offsets[(slab > 0) ? k_start + 1 : 0];
+
+    // Vertex index of each edge in the current pair of planes
+    isize const plane_size = shape[0] * shape[1] * 3;
+    edge_vertices.resize(plane_size * 2);
+    Index* planes[]{edge_vertices.data(), edge_vertices.data() + plane_size};
+
+    auto const assign_plane = [&](isize const k, Index* const plane) {
+        isize v = plane_offsets[k];
+        bool const is_owned = (k > k_start) || (slab == 0);
+
+        isosurface_plane_edges(
+            value,
+            iso_value,
+            k,
+            [&](isize const i, isize const j, int const axis, Real const v0, Real const v1) {
+                plane[(i + j * shape[0]) * 3 + axis] = Index(v);
+
+                if (is_owned)
+                {
+                    Vec3<Real> p{Real(i), Real(j), Real(k)};
+                    p[axis] += (iso_value - v0) / (v1 - v0);
+                    vertex_positions[v - vertex_offset] = grid.to_world(p);
+                }
+
+                ++v;
+            });
+    };
+
+    assign_plane(k_start, planes[0]);
+    isize f = 0;
+
+    for (isize k = k_start; k < k_end; ++k)
+    {
+        assign_plane(k + 1, planes[1]);
+
+        for (isize j = 0; j + 1 < shape[1]; ++j)
+        {
+            for (isize i = 0; i + 1 < shape[0]; ++i)
+            {
+                u8 const cube_case = isosurface_cell_case(value, iso_value, i, j, k);
+                Span<u8 const> const tris = marching_cubes_tris(cube_case);
+
+                for (isize t = 0; t < tris.size(); t += 3)
+                {
+                    Vec3<Index>& f_v = face_vertices[f++];
+
+                    for (isize n = 0; n < 3; ++n)
+                    {
+                        u8 const c = marching_cubes_edges[tris[t + n]][0];
+                        isize const ii = i + (c & 1);
+                        isize const jj = j + ((c >> 1) & 1);
+                        Index const* plane = planes[(c >> 2) & 1];
+
+                        int const axis = marching_cubes_edge_axis(tris[t + n]);
+                        f_v[n] = plane[(ii + jj * shape[0]) * 3 + axis];
+                    }
+                }
+            }
+        }
+
+        std::swap(planes[0], planes[1]);
+    }
+
+    assert(f == face_vertices.size());
+}
+
+} // namespace impl
+
+/// Extracts a triangle mesh approximating the isosurface of a grid field via marching cubes. Grid
+/// points with values less than the iso value are considered inside and faces are oriented with
+/// normals pointing outside. Vertices on grid edges shared by neighboring cells are merged based
+/// on the index of the edge so that the resulting mesh is connected. Slabs of cells along the z
+/// axis are processed in parallel.
+template <typename Real, typename Index>
+void extract_isosurface(
+    GridField<Real> const& field,
+    Real const iso_value,
+    DynamicArray<Vec3<Real>>& vertex_positions,
+    DynamicArray<Vec3<Index>>& face_vertices,
+    Executor const exec = {})
+{
+    static_assert(is_real<Real>);
+    static_assert(is_integer<Index> || is_natural<Index>);
+
+    assert(field.values.size() == field.num_values());
+
+    vertex_positions.clear();
+    face_vertices.clear();
+
+    Vec3<isize> const& shape = field.grid.shape;
+    if ((shape.array() < 2).any())
+        return;
+
+    constexpr isize slab_size = impl::isosurface_slab_size;
+    isize const num_slabs = (shape[2] - 1 + slab_size - 1) / slab_size;
+    impl::IsosurfaceField<Real> const value{field};
+
+    // Count vertices per plane and faces per slab then convert to offsets
+    DynamicArray<isize> plane_offsets(shape[2] + 1, 0, vertex_positions.get_allocator());
+    DynamicArray<isize> slab_offsets(num_slabs + 1, 0, vertex_positions.get_allocator());
+    {
+        impl::isosurface_count(
+            value,
+            iso_value,
+            as_span(plane_offsets).segment(1, shape[2]),
+            as_span(slab_offsets).segment(1, num_slabs),
+            exec);
+
+        inclusive_scan(
+            as_span(plane_offsets).as_const(),
+            as_span(plane_offsets),
+            {},
+            vertex_positions.get_allocator());
+
+        inclusive_scan(
+            as_span(slab_offsets).as_const(),
+            as_span(slab_offsets),
+            {},
+            vertex_positions.get_allocator());
+    }
+
+    vertex_positions.resize(plane_offsets.back());
+    face_vertices.resize(slab_offsets.back());
+
+    auto const loop_body = [&](isize const slab, DynamicArray<Index>& edge_vertices) {
+        isize const k_start = slab * slab_size;
+        isize const k_end = std::min(k_start + slab_size, shape[2] - 1);
+        isize const v_start = plane_offsets[(slab > 0) ? k_start + 1 : 0];
+        isize const v_end = plane_offsets[k_end + 1];
+
+        impl::isosurface_slab(
+            value,
+            iso_value,
+            slab,
+            as_span(plane_offsets).as_const(),
+            as_span(vertex_positions).segment(v_start, v_end - v_start),
+            as_span(face_vertices)
+                .segment(slab_offsets[slab], slab_offsets[slab + 1] - slab_offsets[slab]),
+            edge_vertices);
+    };
+
+    // Each task claims slabs dynamically and reuses its own edge buffer
+    std::atomic<isize> next_slab{0};
+
+    exec.run(exec.num_blocks(num_slabs), [&](isize) {
+        DynamicArray<Index> edge_vertices{vertex_positions.get_allocator()};
+
+        for (isize s = next_slab++; s < num_slabs; s = next_slab++)
+            loop_body(s, edge_vertices);
+    });
+}
+
+/// Streaming version of extract_isosurface which passes the mesh to the given callback one slab
+/// at a time rather than accumulating it. Slabs are passed in order and each call receives the
+/// vertices owned by the slab along with its faces. Face vertex indices refer to the full mesh and
+/// only reference vertices received by the current or previous calls. Up to exec.concurrency()
+/// slabs are held in memory at once.
+template <typename Index, typename Real, typename Callback>
+void extract_isosurface_slabs(
+    GridField<Real> const& field,
+    Real const iso_value,
+    Callback&& callback,
+    Executor const exec = {},
+    Allocator const alloc = {})
+{
+    static_assert(is_real<Real>);
+    static_assert(is_integer<Index> || is_natural<Index>);
+    static_assert(
+        std::is_invocable_v<Callback, Span<Vec3<Real> const>, Span<Vec3<Index> const>>);
+
+    assert(field.values.size() == field.num_values());
+
+    Vec3<isize> const& shape = field.grid.shape;
+    if ((shape.array() < 2).any())
+        return;
+
+    constexpr isize slab_size = impl::isosurface_slab_size;
+    isize const num_slabs = (shape[2] - 1 + slab_size - 1) / slab_size;
+    impl::IsosurfaceField<Real> const value{field};
+
+    // Vertex offsets must be known up front to assign global indices
+    DynamicArray<isize> plane_offsets(shape[2] + 1, 0, alloc);
+    DynamicArray<isize> slab_counts(num_slabs, 0, alloc);
+    {
+        impl::isosurface_count(
+            value,
+            iso_value,
+            as_span(plane_offsets).segment(1, shape[2]),
+            as_span(slab_counts),
+            exec);
+
+        inclusive_scan(as_span(plane_offsets).as_const(), as_span(plane_offsets), {}, alloc);
+    }
+
+    // Per-slab buffers for each slab in a batch. Inner arrays use the outer array's allocator.
+    isize const batch_size = exec.concurrency();
+    DynamicArray<DynamicArray<Vec3<Real>>> slab_vertex_positions(batch_size, alloc);
+    DynamicArray<DynamicArray<Vec3<Index>>> slab_face_vertices(batch_size, alloc);
+    DynamicArray<DynamicArray<Index>> slab_edge_vertices(batch_size, alloc);
+
+    auto const loop_body = [&](isize const slab, isize const buffer) {
+        isize const k_start = slab * slab_size;
+        isize const k_end = std::min(k_start + slab_size, shape[2] - 1);
+        isize const v_start = plane_offsets[(slab > 0) ? k_start + 1 : 0];
+        isize const v_end = plane_offsets[k_end + 1];
+
+        slab_vertex_positions[buffer].resize(v_end - v_start);
+        slab_face_vertices[buffer].resize(slab_counts[slab]);
+
+        impl::isosurface_slab(
+            value,
+            iso_value,
+            slab,
+            as_span(plane_offsets).as_const(),
+            as_span(slab_vertex_positions[buffer]),
+            as_span(slab_face_vertices[buffer]),
+            slab_edge_vertices[buffer]);
+    };
+
+    for (isize batch_start = 0; batch_start < num_slabs; batch_start += batch_size)
+    {
+        isize const batch_end = std::min(batch_start + batch_size, num_slabs);
+
+        exec.run(batch_end - batch_start, [&](isize const buffer) {
+            loop_body(batch_start + buffer, buffer);
+        });
+
+        for (isize s = batch_start; s < batch_end; ++s)
+        {
+            isize const buffer = s - batch_start;
+            callback(
+                as_span(slab_vertex_positions[buffer]).as_const(),
+                as_span(slab_face_vertices[buffer]).as_const());
+        }
+    }
+}
+
+} // namespace dr
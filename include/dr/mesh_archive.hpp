@@ -0,0 +1,278 @@
+#pragma once
+
+#include <cassert>
+#include <type_traits>
+#include <utility>
+
+#include <dr/basic_traits.hpp>
+#include <dr/constants.hpp>
+#include <dr/dynamic_array.hpp>
+#include <dr/halfedge.hpp>
+#include <dr/linalg_traits.hpp>
+#include <dr/memory.hpp>
+#include <dr/sliced_array.hpp>
+#include <dr/span.hpp>
+
+namespace dr
+{
+namespace impl
+{
+
+template <typename T, typename Enable = void>
+struct ArchiveElement;
+
+} // namespace impl
+
+/// Read-only view of a versioned binary archive containing named mesh arrays (vertex positions,
+/// face/cell vertices, attributes, etc.) The archive is memory-mapped on open and its sections are
+/// exposed as spans directly over the mapping without copying.
+struct MeshArchive
+{
+    enum Error : u8
+    {
+        Error_None = 0,
+        Error_OpenFailed,
+        Error_WriteFailed,
+        Error_InvalidHeader,
+        Error_UnsupportedVersion,
+        Error_InvalidSection,
+        Error_ChecksumMismatch,
+        _Error_Count
+    };
+
+    enum ValueType : u8
+    {
+        ValueType_Unknown = 0,
+        ValueType_I8,
+        ValueType_I16,
+        ValueType_I32,
+        ValueType_I64,
+        ValueType_U8,
+        ValueType_U16,
+        ValueType_U32,
+        ValueType_U64,
+        ValueType_F32,
+        ValueType_F64,
+        _ValueType_Count
+    };
+
+    /// Maximum length of a section name (including null terminator)
+    static constexpr isize max_name_size = 56;
+
+    /// Collects named arrays and writes them to an archive file. Arrays are referenced rather than
+    /// copied so they must outlive any calls to write.
+    struct Writer : AllocatorAware
+    {
+        Writer(Allocator const alloc = {}) : sections_(alloc) {}
+
+        Writer(Writer const& other, Allocator const alloc = {}) : sections_(other.sections_, alloc)
+        {
+        }
+
+        Writer(Writer&& other) noexcept = default;
+        Writer& operator=(Writer const& other) = default;
+        Writer& operator=(Writer&& other) = default;
+
+        /// Returns the allocator used by this instance
+        Allocator allocator() const { return sections_.get_allocator(); }
+
+        /// Adds an array of values as a named section
+        template <typename T>
+        void add(char const* name, Span<T const> const& values)
+        {
+            using Element = impl::ArchiveElement<T>;
+            add_bytes(
+                name,
+                Element::value_type,
+                Element::num_components,
+                values.size(),
+                as<u8>(values));
+        }
+
+        /// Adds a sliced array as a pair of named sections ("<name>.items" and
+        /// "<name>.slice_ends")
+        template <typename T, typename Index>
+        void add(char const* name, SlicedArray<T, Index> const& values)
+        {
+            char buf[max_name_size];
+            add(make_name(name, ".items", buf), as_span(values.items));
+            add(make_name(name, ".slice_ends", buf), as_span(values.slice_ends));
+        }
+
+        /// Adds the connectivity of a halfedge mesh as a set of named sections
+        void add(char const* name, HalfedgeMesh const& mesh);
+
+        /// Removes all sections from this writer
+        void clear() { sections_.clear(); }
+
+        /// Writes all sections to a file at the given path
+        Error write(char const* path) const;
+
+      private:
+        struct Section
+        {
+            char name[max_name_size];
+            ValueType value_type;
+            u8 num_components;
+            isize count;
+            Span<u8 const> bytes;
+        };
+
+        DynamicArray<Section> sections_;
+
+        void add_bytes(
+            char const* name,
+            ValueType value_type,
+            u8 num_components,
+            isize count,
+            Span<u8 const> const& bytes);
+    };
+
+    MeshArchive() = default;
+    MeshArchive(MeshArchive const& other) = delete;
+    MeshArchive& operator=(MeshArchive const& other) = delete;
+
+    MeshArchive(MeshArchive&& other) noexcept { swap(other); }
+
+    MeshArchive& operator=(MeshArchive&& other) noexcept
+    {
+        swap(other);
+        return *this;
+    }
+
+    ~MeshArchive() { close(); }
+
+    static char const* error_message(Error err);
+
+    /// Memory-maps the archive at the given path. Section checksums are optionally verified which
+    /// requires reading the entire file.
+    Error open(char const* path, bool verify_checksums = false);
+
+    /// Unmaps the archive. Any spans returned by this instance are invalidated.
+    void close();
+
+    /// Returns true if an archive is currently open
+    bool is_open() const { return data_ != nullptr; }
+
+    /// Returns the number of sections in the archive
+    isize num_sections() const;
+
+    /// Returns the name of the section at the given index
+    char const* section_name(isize index) const;
+
+    /// Returns a view of the named section or an invalid span if the section doesn't exist or its
+    /// element type doesn't match
+    template <typename T>
+    Span<T const> find(char const* name) const
+    {
+        using Element = impl::ArchiveElement<T>;
+        isize count{};
+        void const* const data = find_bytes(
+            name,
+            Element::value_type,
+            Element::num_components,
+            count);
+
+        return (data != nullptr) ? Span<T const>{static_cast<T const*>(data), count}
+                                 : Span<T const>{};
+    }
+
+    /// Copies a sliced array from a pair of named sections. Returns false if either section doesn't
+    /// exist or doesn't match.
+    template <typename T, typename Index>
+    bool read(char const* name, SlicedArray<T, Index>& result) const
+    {
+        char buf[max_name_size];
+        Span<T const> const items = find<T>(make_name(name, ".items", buf));
+        Span<Index const> const slice_ends = find<Index>(make_name(name, ".slice_ends", buf));
+
+        if (!items.is_valid() || !slice_ends.is_valid())
+            return false;
+
+        result.items.assign(begin(items), end(items));
+        result.slice_ends.assign(begin(slice_ends), end(slice_ends));
+        return true;
+    }
+
+    /// Copies the connectivity of a halfedge mesh from a set of named sections. Returns false if
+    /// any required sections don't exist or don't match, or if their sizes or indices are
+    /// inconsistent. The result is left unchanged in this case.
+    bool read(char const* name, HalfedgeMesh& result) const;
+
+  private:
+    void const* data_{};
+    usize size_{};
+    void* handle_{};
+
+    static char const* make_name(
+        char const* prefix,
+        char const* suffix,
+        char (&result)[max_name_size]);
+
+    void const* find_bytes(
+        char const* name,
+        ValueType value_type,
+        u8 num_components,
+        isize& count) const;
+
+    void swap(MeshArchive& other)
+    {
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+        std::swap(handle_, other.handle_);
+    }
+};
+
+namespace impl
+{
+
+template <typename Scalar>
+constexpr MeshArchive::ValueType archive_value_type()
+{
+    using T = std::decay_t<Scalar>;
+
+    if constexpr (std::is_same_v<T, i8>)
+        return MeshArchive::ValueType_I8;
+    else if constexpr (std::is_same_v<T, i16>)
+        return MeshArchive::ValueType_I16;
+    else if constexpr (std::is_same_v<T, i32>)
+        return MeshArchive::ValueType_I32;
+    else if constexpr (std::is_same_v<T, i64>)
+        return MeshArchive::ValueType_I64;
+    else if constexpr (std::is_same_v<T, u8>)
+        return MeshArchive::ValueType_U8;
+    else if constexpr (std::is_same_v<T, u16>)
+        return MeshArchive::ValueType_U16;
+    else if constexpr (std::is_same_v<T, u32>)
+        return MeshArchive::ValueType_U32;
+    else if constexpr (std::is_same_v<T, u64>)
+        return MeshArchive::ValueType_U64;
+    else if constexpr (std::is_same_v<T, f32>)
+        return MeshArchive::ValueType_F32;
+    else if constexpr (std::is_same_v<T, f64>)
+        return MeshArchive::ValueType_F64;
+    else
+        static_assert(always_false<T>, "Unsupported scalar type");
+}
+
+template <typename T, typename Enable>
+struct ArchiveElement
+{
+    static constexpr MeshArchive::ValueType value_type{archive_value_type<T>()};
+    static constexpr u8 num_components{1};
+};
+
+template <typename T>
+struct ArchiveElement<T, std::enable_if_t<is_matrix<T>>>
+{
+    static_assert(T::SizeAtCompileTime > 0 && T::SizeAtCompileTime < 256);
+    static_assert(sizeof(T) == sizeof(typename T::Scalar) * T::SizeAtCompileTime);
+
+    static constexpr MeshArchive::ValueType value_type{
+        archive_value_type<typename T::Scalar>()};
+    static constexpr u8 num_components{T::SizeAtCompileTime};
+};
+
+} // namespace impl
+
+} // namespace dr
@@ -1,30 +1,38 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cmath>
 
+#include <dr/dynamic_array.hpp>
+#include <dr/executor.hpp>
 #include <dr/geometry.hpp>
 #include <dr/linalg_reshape.hpp>
 #include <dr/linalg_types.hpp>
 #include <dr/math.hpp>
+#include <dr/mesh_coloring.hpp>
+#include <dr/sliced_array.hpp>
 #include <dr/span.hpp>
 
 namespace dr
 {
 
-/// Computes the vector area of each vertex dual cell in a triange mesh
+namespace impl
+{
+
 template <typename Real, typename Index>
 void vertex_vector_areas(
     Span<Vec3<Real> const> const& vertex_positions,
     Span<Vec3<Index> const> const& face_vertices,
-    Span<Vec3<Real>> const& result)
+    SlicedArray<Index> const* const face_colors,
+    Span<Vec3<Real>> const& result,
+    Executor const exec)
 {
     assert(result.size() == vertex_positions.size());
     std::fill(begin(result), end(result), Vec3<Real>::Zero());
 
-    for (isize f = 0; f < face_vertices.size(); ++f)
-    {
+    for_each_element(face_vertices.size(), face_colors, exec, [&](isize const f) {
         auto const& f_v = face_vertices[f];
         constexpr Real inv3{1.0 / 3.0};
 
@@ -38,7 +46,37 @@ void vertex_vector_areas(
         result[f_v[0]] += area;
         result[f_v[1]] += area;
         result[f_v[2]] += area;
-    }
+    });
+}
+
+} // namespace impl
+
+/// Computes the vector area of each vertex dual cell in a triange mesh
+template <typename Real, typename Index>
+void vertex_vector_areas(
+    Span<Vec3<Real> const> const& vertex_positions,
+    Span<Vec3<Index> const> const& face_vertices,
+    Span<Vec3<Real>> const& result)
+{
+    impl::vertex_vector_areas<Real, Index>(vertex_positions, face_vertices, nullptr, result, {});
+}
+
+/// Computes the vector area of each vertex dual cell in a triange mesh. Faces are processed in
+/// parallel one color at a time using the given face coloring (see color_elements).
+template <typename Real, typename Index>
+void vertex_vector_areas(
+    Span<Vec3<Real> const> const& vertex_positions,
+    Span<Vec3<Index> const> const& face_vertices,
+    SlicedArray<Index> const& face_colors,
+    Span<Vec3<Real>> const& result,
+    Executor const exec = {})
+{
+    impl::vertex_vector_areas<Real, Index>(
+        vertex_positions,
+        face_vertices,
+        &face_colors,
+        result,
+        exec);
 }
 
 /// Computes the area-weighted normal of each vertex in a triange mesh
@@ -102,29 +140,17 @@ void face_vector_areas(
     Span<Vec3<Real> const> const& vertex_positions,
     Span<Vec3<Index> const> const& face_vertices,
     Span<Vec3<Real>> const& result,
-    isize const num_threads = 1)
+    Executor const exec = {})
 {
     assert(result.size() == face_vertices.size());
 
-    auto const loop_body = [&](isize const f) {
+    exec.parallel_for(face_vertices.size(), [&](isize const f) {
         auto const& f_v = face_vertices[f];
         result[f] = vector_area(
             vertex_positions[f_v[0]],
             vertex_positions[f_v[1]],
             vertex_positions[f_v[2]]);
-    };
-
-    if (num_threads > 1)
-    {
-#pragma omp parallel for num_threads(num_threads) schedule(static)
-        for (isize f = 0; f < face_vertices.size(); ++f)
-            loop_body(f);
-    }
-    else
-    {
-        for (isize f = 0; f < face_vertices.size(); ++f)
-            loop_body(f);
-    }
+    });
 }
 
 /// Computes the normal of each face in a triangle mesh
@@ -133,10 +159,10 @@ void face_normals(
     Span<Vec3<Real> const> const& vertex_positions,
     Span<Vec3<Index> const> const& face_vertices,
     Span<Vec3<Real>> const& result,
-    isize const num_threads = 1)
+    Executor const exec = {})
 {
     assert(result.size() == face_vertices.size());
-    face_vector_areas(vertex_positions, face_vertices, result, num_threads);
+    face_vector_areas(vertex_positions, face_vertices, result, exec);
     as_mat(result).colwise().normalize();
 }
 
@@ -305,57 +331,53 @@ namespace impl
 {
 
 template <typename Real, typename Value, typename EvalFace>
-Value interpolate_mean_value(EvalFace&& eval_face, isize const num_faces, isize const num_threads)
+Value interpolate_mean_value(EvalFace&& eval_face, isize const num_faces, Executor const exec)
 {
-    Value sum{};
-    Real weight_sum{};
-
-    if (num_threads > 1)
+    struct Partial
     {
+        Value sum{};
+        Real weight_sum{};
         bool done = false;
+    };
 
-#pragma omp parallel num_threads(num_threads)
-        {
-            struct
-            {
-                Value sum{};
-                Real weight_sum{};
-                bool done = false;
-            } local;
+    // Faces are split into fixed chunks which are handed out on demand. Chunk boundaries don't
+    // depend on scheduling so partial results are combined in the same order on every run.
+    isize const chunk_size = exec.default_grain_size(num_faces);
+    isize const num_chunks = std::max<isize>((num_faces + chunk_size - 1) / chunk_size, 1);
+    DynamicArray<Partial> partials(num_chunks);
 
-#pragma omp for schedule(static)
-            for (isize i = 0; i < num_faces; ++i)
-            {
-                if (!local.done)
-                    local.done = eval_face(i, local.sum, local.weight_sum);
-            }
+    // Set once any chunk finishes early so that others can stop
+    std::atomic<bool> any_done{false};
 
-#pragma omp critical
+    auto const eval_chunk = [&](isize const c) {
+        Partial& local = partials[c];
+        isize const end = std::min((c + 1) * chunk_size, num_faces);
+
+        for (isize i = c * chunk_size; i < end && !any_done.load(std::memory_order_relaxed); ++i)
+        {
+            if (eval_face(i, local.sum, local.weight_sum))
             {
-                if (!done)
-                {
-                    if (local.done)
-                    {
-                        sum = local.sum;
-                        weight_sum = local.weight_sum;
-                        done = true;
-                    }
-                    else
-                    {
-                        sum += local.sum;
-                        weight_sum += local.weight_sum;
-                    }
-                }
+                local.done = true;
+                any_done.store(true, std::memory_order_relaxed);
+                break;
             }
         }
-    }
-    else
+    };
+
+    // Chunks after an early exit are skipped so work is balanced dynamically
+    exec.parallel_for_dynamic(num_chunks, eval_chunk, 1);
+
+    // Partial results are combined in chunk order
+    Value sum{};
+    Real weight_sum{};
+
+    for (Partial const& local : partials)
     {
-        for (isize i = 0; i < num_faces; ++i)
-        {
-            if (eval_face(i, sum, weight_sum))
-                break;
-        }
+        if (local.done)
+            return local.sum / local.weight_sum;
+
+        sum += local.sum;
+        weight_sum += local.weight_sum;
     }
 
     return sum / weight_sum;
@@ -371,7 +393,7 @@ Value interpolate_mean_value_robust(
     Span<Vec3<Index> const> const& face_vertices,
     Vec3<Real> const& point,
     Real const tolerance = default_epsilon<Real>,
-    isize const num_threads = 1)
+    Executor const exec = {})
 {
     // https://www.cse.wustl.edu/~taoju/research/meanvalue.pdf (section 3.3)
 
@@ -472,7 +494,7 @@ Value interpolate_mean_value_robust(
         return false;
     };
 
-    return impl::interpolate_mean_value<Real, Value>(eval_face, face_vertices.size(), num_threads);
+    return impl::interpolate_mean_value<Real, Value>(eval_face, face_vertices.size(), exec);
 }
 
 /// Returns the interpolated value at a point inside a triangle mesh using mean value coordinates.
@@ -488,7 +510,7 @@ Value interpolate_mean_value_naive(
     Span<Vec3<Index> const> const& face_vertices,
     Vec3<Real> const& point,
     Real const tolerance = default_epsilon<Real>,
-    isize const num_threads = 1)
+    Executor const exec = {})
 {
     // https://www.cse.wustl.edu/~taoju/research/meanvalue.pdf (section 3.2)
 
@@ -554,7 +576,7 @@ Value interpolate_mean_value_naive(
         return false;
     };
 
-    return impl::interpolate_mean_value<Real, Value>(eval_face, face_vertices.size(), num_threads);
+    return impl::interpolate_mean_value<Real, Value>(eval_face, face_vertices.size(), exec);
 }
 
 } // namespace dr
\ No newline at end of file
@@ -0,0 +1,228 @@
+#pragma once
+
+/*
+    Fused cleanup of imported triangle meshes
+*/
+
+#include <cassert>
+#include <cstring>
+#include <type_traits>
+
+#include <dr/basic_traits.hpp>
+#include <dr/container_utils.hpp>
+#include <dr/dynamic_array.hpp>
+#include <dr/executor.hpp>
+#include <dr/math_types.hpp>
+#include <dr/memory.hpp>
+#include <dr/mesh_incidence.hpp>
+#include <dr/mesh_repair.hpp>
+#include <dr/span.hpp>
+
+namespace dr
+{
+
+/// Type-erased view of a per-element attribute array
+struct MeshAttributeSpan
+{
+    u8* data;
+    isize size;
+    isize stride;
+
+    /// Creates a view of the given attribute values
+    template <typename T>
+    static MeshAttributeSpan from(Span<T> const& values)
+    {
+        static_assert(std::is_trivially_copyable_v<T> && !std::is_const_v<T>);
+        return {reinterpret_cast<u8*>(values.data()), values.size(), isize(sizeof(T))};
+    }
+
+    /// Copies the element at the given source index to the given destination index
+    void copy(isize const src, isize const dst) const
+    {
+        assert(src >= 0 && src < size && dst >= 0 && dst < size);
+
+        if (src != dst)
+            std::memcpy(data + dst * stride, data + src * stride, usize(stride));
+    }
+};
+
+/// Cleans up triangle meshes by welding nearby vertices, removing degenerate and duplicate faces,
+/// and removing unused vertices. Per-vertex and per-face attributes are compacted along with the
+/// mesh. Rather than running each step as a separate pass over the mesh, faces are remapped,
+/// filtered, and compacted in a single pass after welding and vertices (along with their
+/// attributes) are compacted in a single pass at the end. Scratch buffers are retained between
+/// calls.
+template <typename Real, typename Index>
+struct MeshCleaner : AllocatorAware
+{
+    static_assert(is_real<Real>);
+    static_assert(is_integer<Index> || is_natural<Index>);
+
+    /// Number of vertices and faces remaining after cleanup
+    struct Result
+    {
+        isize num_vertices;
+        isize num_faces;
+    };
+
+    /// Vertices within this distance of each other are merged
+    Real weld_tolerance{0.0};
+
+    /// If true, faces which reference the same vertex more than once after welding are removed
+    bool remove_degenerate_faces{true};
+
+    /// If true, faces which reference the same vertices as a preceding face with the same
+    /// orientation are removed
+    bool remove_duplicate_faces{true};
+
+    /// If true, vertices which aren't referenced by any faces are removed
+    bool remove_unused_vertices{true};
+
+    MeshCleaner(Allocator const alloc = {}) :
+        point_to_unique_(alloc),
+        unique_points_(alloc),
+        unique_new_indices_(alloc),
+        vertex_new_indices_(alloc),
+        face_keys_(alloc)
+    {
+    }
+
+    MeshCleaner(MeshCleaner const& other, Allocator const alloc = {}) :
+        weld_tolerance(other.weld_tolerance),
+        remove_degenerate_faces(other.remove_degenerate_faces),
+        remove_duplicate_faces(other.remove_duplicate_faces),
+        remove_unused_vertices(other.remove_unused_vertices),
+        point_to_unique_(alloc),
+        unique_points_(alloc),
+        unique_new_indices_(alloc),
+        vertex_new_indices_(other.vertex_new_indices_, alloc),
+        face_keys_(alloc)
+    {
+    }
+
+    MeshCleaner(MeshCleaner&& other) noexcept = default;
+    MeshCleaner& operator=(MeshCleaner const& other) = default;
+    MeshCleaner& operator=(MeshCleaner&& other) = default;
+
+    /// Returns the allocator used by this object
+    Allocator allocator() const { return vertex_new_indices_.get_allocator(); }
+
+    /// Returns the new index of each vertex from the last call to clean. Vertices which were
+    /// removed map to an invalid index.
+    Span<Index const> vertex_new_indices() const { return as_span(vertex_new_indices_); }
+
+    /// Cleans up the given mesh in place. Remaining vertices and faces (along with their
+    /// attributes) are moved to the front of their respective arrays and keep their relative
+    /// order.
+    Result clean(
+        Span<Vec3<Real>> const& vertex_positions,
+        Span<Vec3<Index>> const& face_vertices,
+        Span<MeshAttributeSpan const> const& vertex_attributes = {},
+        Span<MeshAttributeSpan const> const& face_attributes = {},
+        Executor const exec = {})
+    {
+        constexpr Index invalid_idx{~0};
+        isize const num_verts = vertex_positions.size();
+
+        for (auto const& attr : vertex_attributes)
+            assert(attr.size == num_verts);
+
+        for (auto const& attr : face_attributes)
+            assert(attr.size == face_vertices.size());
+
+        // Weld vertices
+        point_to_unique_.resize(num_verts);
+        find_unique_points(
+            vertex_positions.as_const(),
+            weld_tolerance,
+            unique_points_,
+            as_span(point_to_unique_),
+            exec,
+            allocator());
+
+        isize const num_unique = size(unique_points_);
+
+        // Remap, filter, and compact faces. Unique vertices which are used by the remaining faces
+        // are marked along the way.
+        unique_new_indices_.assign(num_unique, remove_unused_vertices ? Index{0} : Index{1});
+        face_keys_.clear();
+
+        isize num_faces = 0;
+        for (isize f = 0; f < face_vertices.size(); ++f)
+        {
+            Vec3<Index> f_v = face_vertices[f];
+            f_v[0] = point_to_unique_[f_v[0]];
+            f_v[1] = point_to_unique_[f_v[1]];
+            f_v[2] = point_to_unique_[f_v[2]];
+
+            if (remove_degenerate_faces)
+            {
+                if (f_v[0] == f_v[1] || f_v[1] == f_v[2] || f_v[2] == f_v[0])
+                    continue;
+            }
+
+            if (remove_duplicate_faces)
+            {
+                if (!face_keys_.try_emplace(f_v, Index(num_faces)).second)
+                    continue;
+            }
+
+            unique_new_indices_[f_v[0]] = 1;
+            unique_new_indices_[f_v[1]] = 1;
+            unique_new_indices_[f_v[2]] = 1;
+
+            face_vertices[num_faces] = f_v;
+            for (auto const& attr : face_attributes)
+                attr.copy(f, num_faces);
+
+            ++num_faces;
+        }
+
+        // Assign new indices to used unique vertices and compact vertices along with their
+        // attributes. Since unique points are in increasing order, this can be done in place.
+        isize num_new = 0;
+        for (isize u = 0; u < num_unique; ++u)
+        {
+            if (unique_new_indices_[u] == 0)
+            {
+                unique_new_indices_[u] = invalid_idx;
+                continue;
+            }
+
+            isize const v = unique_points_[u];
+            vertex_positions[num_new] = vertex_positions[v];
+
+            for (auto const& attr : vertex_attributes)
+                attr.copy(v, num_new);
+
+            unique_new_indices_[u] = Index(num_new++);
+        }
+
+        // Update face vertices if any unique vertices were removed
+        if (num_new < num_unique)
+        {
+            for (isize f = 0; f < num_faces; ++f)
+            {
+                Vec3<Index>& f_v = face_vertices[f];
+                f_v[0] = unique_new_indices_[f_v[0]];
+                f_v[1] = unique_new_indices_[f_v[1]];
+                f_v[2] = unique_new_indices_[f_v[2]];
+            }
+        }
+
+        vertex_new_indices_.resize(num_verts);
+        for (isize i = 0; i < num_verts; ++i)
+            vertex_new_indices_[i] = unique_new_indices_[point_to_unique_[i]];
+
+        return {num_new, num_faces};
+    }
+
+  private:
+    DynamicArray<Index> point_to_unique_;
+    DynamicArray<Index> unique_points_;
+    DynamicArray<Index> unique_new_indices_;
+    DynamicArray<Index> vertex_new_indices_;
+    impl::MeshIncidence::Map<Index, 3> face_keys_;
+};
+
+} // namespace dr
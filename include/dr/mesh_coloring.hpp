@@ -0,0 +1,218 @@
+#pragma once
+
+/*
+    Coloring of mesh elements for parallel scatter. Elements of the same color share no vertices so
+    their contributions can be accumulated into per-vertex arrays concurrently (without atomics) by
+    processing one color at a time.
+*/
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <type_traits>
+
+#include <dr/basic_traits.hpp>
+#include <dr/basic_types.hpp>
+#include <dr/bitwise.hpp>
+#include <dr/container_utils.hpp>
+#include <dr/dynamic_array.hpp>
+#include <dr/executor.hpp>
+#include <dr/hash.hpp>
+#include <dr/linalg_reshape.hpp>
+#include <dr/math_types.hpp>
+#include <dr/sliced_array.hpp>
+#include <dr/span.hpp>
+
+namespace dr
+{
+
+/// Colors the given mesh elements such that no two elements of the same color share a vertex.
+/// Elements of each color are written to a separate slice of the result in increasing order.
+///
+/// Colors are assigned in rounds (Jones-Plassmann). In each round, every uncolored element whose
+/// pseudo-random priority exceeds those of its uncolored neighbors takes the smallest color not
+/// used by its neighbors. Elements are processed in parallel within each round and the result
+/// doesn't depend on the executor. The result only depends on element vertices so it can be
+/// cached and reused for as long as the topology is unchanged.
+template <typename Index, int size>
+void color_elements(
+    Span<Vec<Index, size> const> const& element_vertices,
+    SlicedArray<Index>& result,
+    Index num_vertices = -1,
+    Executor const exec = {},
+    Allocator const alloc = {})
+{
+    static_assert(is_integer<Index> || is_natural<Index>);
+
+    isize const num_elems = element_vertices.size();
+    assert(num_elems <= isize(std::numeric_limits<Index>::max()));
+
+    if (num_vertices == Index(-1))
+        num_vertices = (num_elems > 0) ? as_mat(element_vertices).maxCoeff() + 1 : 0;
+
+    // Elements incident to each vertex
+    SlicedArray<Index, isize> vertex_elems{alloc};
+    {
+        DynamicArray<isize> counts(num_vertices, 0, alloc);
+        for (auto const& e_v : element_vertices)
+        {
+            for (int j = 0; j < size; ++j)
+                ++counts[e_v[j]];
+        }
+
+        vertex_elems.assign_sizes(as_span(counts).as_const(), exec);
+
+        // Counts are reused as insertion points
+        for (isize v = 0; v < num_vertices; ++v)
+            counts[v] = (v > 0) ? vertex_elems.slice_ends[v - 1] : 0;
+
+        for (isize i = 0; i < num_elems; ++i)
+        {
+            for (int j = 0; j < size; ++j)
+                vertex_elems.items[counts[element_vertices[i][j]]++] = Index(i);
+        }
+    }
+
+    DynamicArray<u64> priorities(num_elems, alloc);
+    exec.parallel_for(num_elems, [&](isize const i) {
+        priorities[i] = hash(u64(i));
+    });
+
+    // Ties are broken by index so that the order is strict
+    auto const precedes = [&](isize const a, isize const b) -> bool {
+        return (priorities[a] != priorities[b]) ? priorities[a] > priorities[b] : a < b;
+    };
+
+    constexpr Index no_color = Index(-1);
+    DynamicArray<Index> colors(num_elems, no_color, alloc);
+
+    // Returns the smallest color not used by any neighbor of the given element or no color if an
+    // uncolored neighbor precedes it
+    auto const try_color = [&](isize const i) -> Index {
+        auto const& e_v = element_vertices[i];
+
+        // Colors used by neighbors are gathered in windows of 64
+        for (Index base = 0;; base += 64)
+        {
+            u64 used = 0;
+
+            for (int j = 0; j < size; ++j)
+            {
+                for (Index const k : vertex_elems[e_v[j]])
+                {
+                    if (isize(k) == i)
+                        continue;
+
+                    Index const c = colors[k];
+                    if (c == no_color)
+                    {
+                        if (precedes(k, i))
+                            return no_color;
+                    }
+                    else if (c >= base && c - base < 64)
+                    {
+                        used |= u64{1} << (c - base);
+                    }
+                }
+            }
+
+            if (~used != 0)
+                return base + Index(trailing_zeros(~used));
+        }
+    };
+
+    DynamicArray<Index> pending(num_elems, alloc);
+    for (isize i = 0; i < num_elems; ++i)
+        pending[i] = Index(i);
+
+    DynamicArray<Index> next(num_elems, alloc);
+    Index num_colors = 0;
+
+    while (!pending.empty())
+    {
+        isize const num_pending = pending.size();
+
+        // Decisions are buffered so that each round only observes the previous one. Elements
+        // colored in the same round are never adjacent since only one of any two adjacent
+        // elements can precede the other.
+        exec.parallel_for_dynamic(num_pending, [&](isize const k) {
+            next[k] = try_color(pending[k]);
+        });
+
+        isize num_remaining = 0;
+        for (isize k = 0; k < num_pending; ++k)
+        {
+            if (next[k] == no_color)
+            {
+                pending[num_remaining++] = pending[k];
+            }
+            else
+            {
+                colors[pending[k]] = next[k];
+                num_colors = std::max<Index>(num_colors, next[k] + 1);
+            }
+        }
+
+        pending.resize(num_remaining);
+    }
+
+    // Group elements by color
+    {
+        DynamicArray<i32> counts(num_colors, 0, alloc);
+        for (Index const c : colors)
+            ++counts[c];
+
+        result.assign_sizes(as_span(counts).as_const());
+
+        // Counts are reused as insertion points
+        for (Index c = 0; c < num_colors; ++c)
+            counts[c] = (c > 0) ? result.slice_ends[c - 1] : 0;
+
+        for (isize i = 0; i < num_elems; ++i)
+            result.items[counts[colors[i]]++] = Index(i);
+    }
+}
+
+/// Calls `fn(i)` for each element in the given coloring (see color_elements). Colors are processed
+/// in order and elements of the same color are processed in parallel.
+template <typename Index, typename Fn>
+void for_each_colored(SlicedArray<Index> const& element_colors, Fn&& fn, Executor const exec = {})
+{
+    static_assert(std::is_invocable_v<Fn, Index>);
+
+    for (isize c = 0; c < element_colors.num_slices(); ++c)
+    {
+        Span<Index const> const elems = element_colors[c];
+
+        exec.parallel_for(elems.size(), [&](isize const i) {
+            fn(elems[i]);
+        });
+    }
+}
+
+namespace impl
+{
+
+/// Calls `fn(i)` for each of the given number of elements. Elements are processed one color at a
+/// time if a coloring is given and serially otherwise.
+template <typename Index, typename Fn>
+void for_each_element(
+    isize const count,
+    SlicedArray<Index> const* const element_colors,
+    Executor const exec,
+    Fn&& fn)
+{
+    if (element_colors)
+    {
+        assert(element_colors->num_items() == count);
+        for_each_colored(*element_colors, fn, exec);
+    }
+    else
+    {
+        for (isize i = 0; i < count; ++i)
+            fn(Index(i));
+    }
+}
+
+} // namespace impl
+} // namespace dr
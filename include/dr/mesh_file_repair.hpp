@@ -0,0 +1,80 @@
+#pragma once
+
+/*
+    Repair of mesh files which are too large to fit in memory
+*/
+
+#include <dr/basic_types.hpp>
+#include <dr/executor.hpp>
+#include <dr/memory.hpp>
+#include <dr/mesh_io.hpp>
+
+namespace dr
+{
+
+struct MeshFileRepair
+{
+    struct Options
+    {
+        /// Directory where temporary files are created
+        char const* temp_dir{"."};
+
+        /// Prefix of temporary file names. Concurrent repairs sharing a directory must use
+        /// different prefixes.
+        char const* temp_prefix{"dr_mesh_repair"};
+
+        /// Format of the repaired mesh file
+        MeshIO::Format format{MeshIO::Format_PlyBinaryLE};
+
+        /// Vertices within this distance of each other are merged
+        f64 weld_tolerance{0.0};
+
+        /// Maximum number of face corners per spatial tile. Bounds the memory used when welding
+        /// vertices within each tile.
+        isize max_corners_per_tile{isize{1} << 22};
+
+        /// Number of vertex positions held in memory at once when resolving face corners
+        isize max_vertices_per_block{isize{1} << 22};
+
+        /// Number of faces held in memory at once when assembling renumbered faces
+        isize max_faces_per_block{isize{1} << 22};
+
+        /// Number of bytes buffered for each temporary file before it's written to disk
+        isize buffer_size{isize{1} << 16};
+
+        /// Number of bytes read from the input file at once
+        isize read_chunk_size{MeshIO::default_chunk_size};
+
+        /// Executor used for parsing and welding
+        Executor executor{};
+    };
+
+    struct Stats
+    {
+        isize num_input_vertices;
+        isize num_input_faces;
+        isize num_vertices;
+        isize num_faces;
+        isize num_tiles;
+        isize max_tile_corners;
+    };
+};
+
+/// Welds vertices of the mesh file at src_path and writes the renumbered mesh to dst_path using a
+/// bounded amount of memory. Polygons are triangulated as fans. Triangle corners are streamed from
+/// disk into spatial tiles and welded within each tile. Tiles are split adaptively until each
+/// holds at most max_corners_per_tile corners (tiles of coincident corners are welded in chunks
+/// instead). Tiles are welded in order and vertices within tolerance of a tile are passed on to it
+/// if it's unprocessed (halo exchange). Each input vertex is merged with an output vertex within
+/// tolerance of it and output vertices are farther than tolerance from each other. Where chains of
+/// vertices within tolerance cross tile borders, vertices may be merged differently than if the
+/// whole mesh was welded at once. Faces which become degenerate are removed along with vertices
+/// which aren't referenced by any faces.
+MeshIO::Error repair_mesh_file(
+    char const* src_path,
+    char const* dst_path,
+    MeshFileRepair::Options const& options = {},
+    MeshFileRepair::Stats* stats = nullptr,
+    Allocator alloc = {});
+
+} // namespace dr
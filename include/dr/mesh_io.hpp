@@ -0,0 +1,312 @@
+#pragma once
+
+#include <cassert>
+#include <cstdio>
+#include <type_traits>
+
+#include <dr/basic_types.hpp>
+#include <dr/dynamic_array.hpp>
+#include <dr/executor.hpp>
+#include <dr/math_types.hpp>
+#include <dr/memory.hpp>
+#include <dr/sliced_array.hpp>
+#include <dr/span.hpp>
+
+namespace dr
+{
+
+/// Streaming readers and writers for OBJ and PLY (ASCII and binary) mesh files
+struct MeshIO
+{
+    enum Error : u8
+    {
+        Error_None = 0,
+        Error_OpenFailed,
+        Error_ReadFailed,
+        Error_WriteFailed,
+        Error_InvalidHeader,
+        Error_InvalidData,
+        _Error_Count
+    };
+
+    enum Format : u8
+    {
+        Format_Unknown = 0,
+        Format_Obj,
+        Format_PlyAscii,
+        Format_PlyBinaryLE,
+        Format_PlyBinaryBE,
+        _Format_Count
+    };
+
+    /// Default number of bytes read from a file at once
+    static constexpr isize default_chunk_size = isize{1} << 24;
+
+    /// Vertex positions and face vertices read from a contiguous portion of a file. Face vertices
+    /// index into the vertices of the whole file, not just those in the chunk.
+    template <typename Real, typename Index>
+    struct Chunk : AllocatorAware
+    {
+        DynamicArray<Vec3<Real>> vertex_positions;
+        SlicedArray<Index> face_vertices;
+
+        Chunk(Allocator const alloc = {}) :
+            vertex_positions(alloc),
+            face_vertices(alloc)
+        {
+        }
+
+        Chunk(Chunk const& other, Allocator const alloc = {}) :
+            vertex_positions(other.vertex_positions, alloc),
+            face_vertices(other.face_vertices, alloc)
+        {
+        }
+
+        Chunk(Chunk&& other) noexcept = default;
+        Chunk& operator=(Chunk const& other) = default;
+        Chunk& operator=(Chunk&& other) = default;
+
+        /// Returns the allocator used by this instance
+        Allocator allocator() const { return vertex_positions.get_allocator(); }
+
+        /// Returns true if the chunk contains no vertices or faces
+        bool empty() const { return vertex_positions.empty() && face_vertices.slice_ends.empty(); }
+
+        /// Removes all vertices and faces from the chunk
+        void clear()
+        {
+            vertex_positions.clear();
+            face_vertices.clear();
+        }
+    };
+
+    /// Reads a mesh file in fixed-size chunks. Files larger than available memory can be processed
+    /// incrementally by consuming each chunk before reading the next.
+    struct Reader : AllocatorAware
+    {
+        Reader(Allocator const alloc = {}) :
+            buffer_(alloc),
+            ply_elements_(alloc),
+            ply_properties_(alloc)
+        {
+        }
+
+        Reader(Reader const& other) = delete;
+        Reader& operator=(Reader const& other) = delete;
+
+        ~Reader() { close(); }
+
+        /// Returns the allocator used by this instance
+        Allocator allocator() const { return buffer_.get_allocator(); }
+
+        /// Opens the file at the given path. The format is detected from the file contents.
+        Error open(char const* path, isize chunk_size = default_chunk_size);
+
+        /// Closes the current file if one is open
+        void close();
+
+        /// Returns true if a file is currently open
+        bool is_open() const { return file_ != nullptr; }
+
+        /// Returns the format of the current file
+        Format format() const { return format_; }
+
+        /// Returns the error encountered by the last call to open or read if any
+        Error error() const { return error_; }
+
+        /// Returns the number of vertices declared in the file header or -1 if the format doesn't
+        /// declare one
+        isize num_vertices_hint() const;
+
+        /// Returns the number of faces declared in the file header or -1 if the format doesn't
+        /// declare one
+        isize num_faces_hint() const;
+
+        /// Reads the next chunk of the file, replacing the contents of result. Returns false once
+        /// the end of the file has been reached or if an error occurred (see error). ASCII files
+        /// are parsed in parallel by splitting each chunk at line boundaries in which case the
+        /// allocator's memory resource must be thread-safe.
+        template <typename Real, typename Index>
+        bool read(Chunk<Real, Index>& result, Executor exec = {});
+
+      private:
+        struct PlyElement
+        {
+            u8 kind;
+            i32 property_start;
+            i32 property_end;
+            i64 count;
+            i64 row_end;
+        };
+
+        struct PlyProperty
+        {
+            u8 type;
+            u8 count_type;
+            u8 role;
+        };
+
+        std::FILE* file_{};
+        isize chunk_size_{};
+        DynamicArray<u8> buffer_;
+        isize buffer_start_{};
+        isize buffer_end_{};
+        bool at_eof_{};
+        Format format_{};
+        Error error_{};
+
+        // Number of vertices read so far (used to resolve relative indices in OBJ files)
+        i64 num_vertices_read_{};
+
+        DynamicArray<PlyElement> ply_elements_;
+        DynamicArray<PlyProperty> ply_properties_;
+        i64 ply_row_{};
+
+        bool refill();
+        void grow();
+        Error parse_ply_header();
+
+        template <typename Real, typename Index>
+        bool read_text(Chunk<Real, Index>& result, Executor exec);
+
+        template <typename Real, typename Index>
+        bool read_binary(Chunk<Real, Index>& result, Executor exec);
+    };
+
+    /// Writes a mesh file incrementally. PLY files declare element counts in their header so the
+    /// total number of vertices and faces must be given up front. All vertices must be written
+    /// before any faces.
+    struct Writer : AllocatorAware
+    {
+        Writer(Allocator const alloc = {}) : buffer_(alloc) {}
+
+        Writer(Writer const& other) = delete;
+        Writer& operator=(Writer const& other) = delete;
+
+        ~Writer() { close(); }
+
+        /// Returns the allocator used by this instance
+        Allocator allocator() const { return buffer_.get_allocator(); }
+
+        /// Creates a file at the given path and writes its header
+        template <typename Real>
+        Error open(
+            char const* const path,
+            Format const format,
+            isize const num_vertices,
+            isize const num_faces)
+        {
+            static_assert(std::is_same_v<Real, f32> || std::is_same_v<Real, f64>);
+            return open_impl(path, format, sizeof(Real), num_vertices, num_faces);
+        }
+
+        /// Flushes and closes the current file if one is open
+        Error close();
+
+        /// Returns true if a file is currently open
+        bool is_open() const { return file_ != nullptr; }
+
+        /// Appends vertex positions to the file. ASCII output is formatted in parallel.
+        template <typename Real>
+        Error write_vertices(Span<Vec3<Real> const> const& vertex_positions, Executor exec = {});
+
+        /// Appends faces to the file. ASCII output is formatted in parallel. Binary PLY files store
+        /// the size of each face in a byte so larger faces result in Error_InvalidData.
+        template <typename Index>
+        Error write_faces(SlicedArray<Index> const& face_vertices, Executor exec = {});
+
+      private:
+        std::FILE* file_{};
+        Format format_{};
+        u8 real_size_{};
+        isize num_vertices_{};
+        isize num_vertices_written_{};
+        isize num_faces_{};
+        isize num_faces_written_{};
+        DynamicArray<u8> buffer_;
+
+        Error open_impl(
+            char const* path,
+            Format format,
+            u8 real_size,
+            isize num_vertices,
+            isize num_faces);
+
+        Error write_bytes(void const* data, isize size);
+    };
+
+    static char const* error_message(Error err);
+};
+
+/// Reads all vertex positions and faces from a mesh file, appending them to the given arrays
+template <typename Real, typename Index>
+MeshIO::Error read_mesh(
+    char const* const path,
+    DynamicArray<Vec3<Real>>& vertex_positions,
+    SlicedArray<Index>& face_vertices,
+    Executor const exec = {})
+{
+    MeshIO::Reader reader{vertex_positions.get_allocator()};
+    if (MeshIO::Error const err = reader.open(path); err != MeshIO::Error_None)
+        return err;
+
+    // Reserve space for declared element counts if available
+    {
+        isize const num_verts = reader.num_vertices_hint();
+        if (num_verts > 0)
+            vertex_positions.reserve(vertex_positions.size() + num_verts);
+
+        isize const num_faces = reader.num_faces_hint();
+        if (num_faces > 0)
+            face_vertices.slice_ends.reserve(face_vertices.slice_ends.size() + num_faces);
+    }
+
+    Index const vertex_offset = size_as<Index>(vertex_positions);
+    MeshIO::Chunk<Real, Index> chunk{vertex_positions.get_allocator()};
+
+    while (reader.read(chunk, exec))
+    {
+        vertex_positions.insert(
+            vertex_positions.end(),
+            chunk.vertex_positions.begin(),
+            chunk.vertex_positions.end());
+
+        auto const item_offset = face_vertices.num_items();
+        for (Index const v : chunk.face_vertices.items)
+            face_vertices.items.push_back(v + vertex_offset);
+
+        for (auto const end : chunk.face_vertices.slice_ends)
+            face_vertices.slice_ends.push_back(end + item_offset);
+    }
+
+    return reader.error();
+}
+
+/// Writes vertex positions and faces to a mesh file in the given format
+template <typename Real, typename Index>
+MeshIO::Error write_mesh(
+    char const* const path,
+    MeshIO::Format const format,
+    Span<Vec3<Real> const> const& vertex_positions,
+    SlicedArray<Index> const& face_vertices,
+    Executor const exec = {})
+{
+    MeshIO::Writer writer{face_vertices.allocator()};
+
+    MeshIO::Error err = writer.open<Real>(
+        path,
+        format,
+        vertex_positions.size(),
+        face_vertices.num_slices());
+
+    if (err == MeshIO::Error_None)
+        err = writer.write_vertices(vertex_positions, exec);
+
+    if (err == MeshIO::Error_None)
+        err = writer.write_faces(face_vertices, exec);
+
+    MeshIO::Error const close_err = writer.close();
+    return (err == MeshIO::Error_None) ? close_err : err;
+}
+
+} // namespace dr
@@ -0,0 +1,434 @@
+#pragma once
+
+/*
+    Matrix-free differential operators on triangle meshes with precomputed per-face geometry
+*/
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include <Eigen/SparseCore>
+
+#include <dr/basic_traits.hpp>
+#include <dr/container_utils.hpp>
+#include <dr/dynamic_array.hpp>
+#include <dr/executor.hpp>
+#include <dr/geometry.hpp>
+#include <dr/linalg_reshape.hpp>
+#include <dr/linalg_types.hpp>
+#include <dr/math_types.hpp>
+#include <dr/memory.hpp>
+#include <dr/mesh_coloring.hpp>
+#include <dr/sliced_array.hpp>
+#include <dr/span.hpp>
+
+namespace dr
+{
+
+/// Caches per-face geometric factors of a triangle mesh (cotangent weights, gradients of linear
+/// basis functions and areas) so that the Laplacian, gradient and divergence can be applied
+/// repeatedly without recomputing them, e.g. within an iterative solver.
+///
+/// Factors are stored as separate arrays per component (SoA) with faces grouped by color (see
+/// color_elements). Applying an operator streams through these arrays one color at a time and
+/// processes faces of the same color in parallel.
+///
+/// Apply functions accept multiple right-hand sides at once. Values of all right-hand sides are
+/// interleaved per element i.e. the j-th value of element i is at index i * num_rhs + j.
+template <typename Real, typename Index = i32>
+struct MeshOperatorCache : AllocatorAware
+{
+    static_assert(is_real<Real>);
+    static_assert(is_integer<Index> || is_natural<Index>);
+
+    MeshOperatorCache(Allocator const alloc = {}) :
+        face_colors_(alloc),
+        face_ids_(alloc),
+        face_verts_{
+            DynamicArray<Index>(alloc),
+            DynamicArray<Index>(alloc),
+            DynamicArray<Index>(alloc),
+        },
+        cotans_{
+            DynamicArray<Real>(alloc),
+            DynamicArray<Real>(alloc),
+            DynamicArray<Real>(alloc),
+        },
+        grads_{
+            {DynamicArray<Real>(alloc), DynamicArray<Real>(alloc), DynamicArray<Real>(alloc)},
+            {DynamicArray<Real>(alloc), DynamicArray<Real>(alloc), DynamicArray<Real>(alloc)},
+        },
+        areas_(alloc)
+    {
+    }
+
+    MeshOperatorCache(MeshOperatorCache const& other, Allocator const alloc = {}) :
+        face_colors_{other.face_colors_, alloc},
+        face_ids_{other.face_ids_, alloc},
+        face_verts_{
+            {other.face_verts_[0], alloc},
+            {other.face_verts_[1], alloc},
+            {other.face_verts_[2], alloc},
+        },
+        cotans_{
+            {other.cotans_[0], alloc},
+            {other.cotans_[1], alloc},
+            {other.cotans_[2], alloc},
+        },
+        grads_{
+            {
+                {other.grads_[0][0], alloc},
+                {other.grads_[0][1], alloc},
+                {other.grads_[0][2], alloc},
+            },
+            {
+                {other.grads_[1][0], alloc},
+                {other.grads_[1][1], alloc},
+                {other.grads_[1][2], alloc},
+            },
+        },
+        areas_{other.areas_, alloc},
+        num_verts_{other.num_verts_}
+    {
+    }
+
+    MeshOperatorCache(MeshOperatorCache&& other) noexcept = default;
+    MeshOperatorCache& operator=(MeshOperatorCache const& other) = default;
+    MeshOperatorCache& operator=(MeshOperatorCache&& other) = default;
+
+    /// Returns the allocator used by this instance
+    Allocator allocator() const { return face_ids_.get_allocator(); }
+
+    /// Returns the number of vertices in the cached mesh
+    isize num_vertices() const { return num_verts_; }
+
+    /// Returns the number of faces in the cached mesh
+    isize num_faces() const { return size(face_ids_); }
+
+    /// Caches the topology and geometry of the given triangle mesh
+    void init(
+        Span<Vec3<Real> const> const& vertex_positions,
+        Span<Vec3<Index> const> const& face_vertices,
+        Executor const exec = {})
+    {
+        num_verts_ = vertex_positions.size();
+        color_elements(face_vertices, face_colors_, Index(num_verts_), exec, allocator());
+
+        // Faces are stored in color order
+        isize const num_faces = face_vertices.size();
+        face_ids_.assign(begin(face_colors_.items), end(face_colors_.items));
+
+        for (int i = 0; i < 3; ++i)
+            face_verts_[i].resize(num_faces);
+
+        exec.parallel_for(num_faces, [&](isize const k) {
+            auto const& f_v = face_vertices[face_ids_[k]];
+            face_verts_[0][k] = f_v[0];
+            face_verts_[1][k] = f_v[1];
+            face_verts_[2][k] = f_v[2];
+        });
+
+        update(vertex_positions, exec);
+    }
+
+    /// Recomputes cached geometry for new vertex positions. The topology of the mesh is assumed to
+    /// be unchanged since the last call to init.
+    void update(Span<Vec3<Real> const> const& vertex_positions, Executor const exec = {})
+    {
+        assert(vertex_positions.size() == num_verts_);
+
+        isize const num_faces = this->num_faces();
+
+        for (int i = 0; i < 3; ++i)
+        {
+            cotans_[i].resize(num_faces);
+            grads_[0][i].resize(num_faces);
+            grads_[1][i].resize(num_faces);
+        }
+
+        areas_.resize(num_faces);
+
+        exec.parallel_for(num_faces, [&](isize const k) {
+            Vec3<Real> const& p0 = vertex_positions[face_verts_[0][k]];
+            Vec3<Real> const& p1 = vertex_positions[face_verts_[1][k]];
+            Vec3<Real> const& p2 = vertex_positions[face_verts_[2][k]];
+
+            Real w[3];
+            cotan_weights<Real>(p1 - p0, p2 - p1, p0 - p2, w[0], w[1], w[2]);
+
+            // Gradients of the linear basis functions of the second and third vertices. The
+            // gradient of the first is the negated sum of the others.
+            Vec3<Real> const dp[]{p1 - p0, p2 - p0};
+            Vec3<Real> const cross = dp[0].cross(dp[1]);
+            Real const sqr_norm = cross.squaredNorm();
+            Vec3<Real> const norm = cross / sqr_norm;
+            Vec3<Real> const g[]{dp[1].cross(norm), norm.cross(dp[0])};
+
+            for (int i = 0; i < 3; ++i)
+            {
+                cotans_[i][k] = w[i];
+                grads_[0][i][k] = g[0][i];
+                grads_[1][i][k] = g[1][i];
+            }
+
+            areas_[k] = Real{0.5} * std::sqrt(sqr_norm);
+        });
+    }
+
+    /// Returns the area of each face in color order (see face_ids)
+    Span<Real const> face_areas() const { return as_span(areas_); }
+
+    /// Returns the index of each face in color order
+    Span<Index const> face_ids() const { return as_span(face_ids_); }
+
+    /// Returns the coloring of faces used to apply operators in parallel
+    SlicedArray<Index> const& face_colors() const { return face_colors_; }
+
+    /// Evaluates the Laplacian of functions defined on mesh vertices. Returns integrated
+    /// quantities associated with each vertex dual cell. Equivalent to eval_laplacian.
+    void apply_laplacian(
+        Span<Real const> const& vertex_values,
+        Span<Real> const& result,
+        isize const num_rhs = 1,
+        Executor const exec = {}) const
+    {
+        assert(vertex_values.size() == num_verts_ * num_rhs);
+        assert(result.size() == vertex_values.size());
+        assert(vertex_values.data() != result.data());
+
+        std::fill(begin(result), end(result), Real{0.0});
+
+        for_each_color(exec, [&](isize const k) {
+            isize const v[]{
+                isize(face_verts_[0][k]) * num_rhs,
+                isize(face_verts_[1][k]) * num_rhs,
+                isize(face_verts_[2][k]) * num_rhs,
+            };
+
+            Real const w[]{cotans_[0][k], cotans_[1][k], cotans_[2][k]};
+
+            for (isize j = 0; j < num_rhs; ++j)
+            {
+                Real const f[]{
+                    vertex_values[v[0] + j],
+                    vertex_values[v[1] + j],
+                    vertex_values[v[2] + j],
+                };
+
+                Real const w_df[]{w[0] * (f[1] - f[0]), w[1] * (f[2] - f[1]), w[2] * (f[0] - f[2])};
+
+                result[v[0] + j] += w_df[0] - w_df[2];
+                result[v[1] + j] += w_df[1] - w_df[0];
+                result[v[2] + j] += w_df[2] - w_df[1];
+            }
+        });
+    }
+
+    /// Evaluates the gradient of functions defined on mesh vertices. Returns covectors associated
+    /// with each face. Equivalent to eval_gradient.
+    void apply_gradient(
+        Span<Real const> const& vertex_values,
+        Span<Covec3<Real>> const& result,
+        isize const num_rhs = 1,
+        Executor const exec = {}) const
+    {
+        assert(vertex_values.size() == num_verts_ * num_rhs);
+        assert(result.size() == num_faces() * num_rhs);
+
+        // Gradients don't scatter so faces can be processed in any order
+        exec.parallel_for(num_faces(), [&](isize const k) {
+            isize const v[]{
+                isize(face_verts_[0][k]) * num_rhs,
+                isize(face_verts_[1][k]) * num_rhs,
+                isize(face_verts_[2][k]) * num_rhs,
+            };
+
+            Covec3<Real> const g[]{
+                {grads_[0][0][k], grads_[0][1][k], grads_[0][2][k]},
+                {grads_[1][0][k], grads_[1][1][k], grads_[1][2][k]},
+            };
+
+            isize const dst = isize(face_ids_[k]) * num_rhs;
+
+            for (isize j = 0; j < num_rhs; ++j)
+            {
+                Real const f0 = vertex_values[v[0] + j];
+                result[dst + j] = (vertex_values[v[1] + j] - f0) * g[0]
+                    + (vertex_values[v[2] + j] - f0) * g[1];
+            }
+        });
+    }
+
+    /// Evaluates the divergence of vector-valued functions defined on mesh faces. Returns
+    /// integrated quantities associated with each vertex dual cell. Equivalent to
+    /// eval_divergence.
+    void apply_divergence(
+        Span<Vec3<Real> const> const& face_vectors,
+        Span<Real> const& result,
+        isize const num_rhs = 1,
+        Executor const exec = {}) const
+    {
+        assert(face_vectors.size() == num_faces() * num_rhs);
+        assert(result.size() == num_verts_ * num_rhs);
+
+        std::fill(begin(result), end(result), Real{0.0});
+
+        // NOTE: The integrated divergence at each vertex of a face is the negated, area-weighted
+        // projection of the face vector onto the gradient of the vertex's basis function
+        for_each_color(exec, [&](isize const k) {
+            isize const v[]{
+                isize(face_verts_[0][k]) * num_rhs,
+                isize(face_verts_[1][k]) * num_rhs,
+                isize(face_verts_[2][k]) * num_rhs,
+            };
+
+            Real const a = areas_[k];
+            Vec3<Real> const g[]{
+                {grads_[0][0][k], grads_[0][1][k], grads_[0][2][k]},
+                {grads_[1][0][k], grads_[1][1][k], grads_[1][2][k]},
+            };
+
+            isize const src = isize(face_ids_[k]) * num_rhs;
+
+            for (isize j = 0; j < num_rhs; ++j)
+            {
+                Vec3<Real> const& f = face_vectors[src + j];
+                Real const div[]{a * g[0].dot(f), a * g[1].dot(f)};
+
+                result[v[0] + j] += div[0] + div[1];
+                result[v[1] + j] -= div[0];
+                result[v[2] + j] -= div[1];
+            }
+        });
+    }
+
+  private:
+    SlicedArray<Index> face_colors_;
+    DynamicArray<Index> face_ids_;
+    DynamicArray<Index> face_verts_[3];
+    DynamicArray<Real> cotans_[3];
+    DynamicArray<Real> grads_[2][3];
+    DynamicArray<Real> areas_;
+    isize num_verts_{};
+
+    // Calls `fn(k)` for each face in color order. Faces of the same color run in parallel.
+    template <typename Fn>
+    void for_each_color(Executor const exec, Fn&& fn) const
+    {
+        for (isize c = 0; c < face_colors_.num_slices(); ++c)
+        {
+            isize const begin = (c > 0) ? face_colors_.slice_ends[c - 1] : 0;
+            isize const end = face_colors_.slice_ends[c];
+
+            exec.parallel_for(end - begin, [&](isize const i) {
+                fn(begin + i);
+            });
+        }
+    }
+};
+
+/// Matrix-free linear operator representing shift * I - L where L is the cotangent Laplacian of a
+/// cached mesh. This is symmetric positive definite for shift > 0 so it can be passed to Eigen's
+/// iterative solvers, e.g.
+///
+///     Eigen::ConjugateGradient<
+///         MeshLaplacianOperator<Real>,
+///         Eigen::Lower | Eigen::Upper,
+///         Eigen::IdentityPreconditioner>
+///
+template <typename Real, typename Index = i32>
+struct MeshLaplacianOperator : Eigen::EigenBase<MeshLaplacianOperator<Real, Index>>
+{
+    using Scalar = Real;
+    using RealScalar = Real;
+    using StorageIndex = int;
+
+    enum
+    {
+        ColsAtCompileTime = Eigen::Dynamic,
+        MaxColsAtCompileTime = Eigen::Dynamic,
+        IsRowMajor = false
+    };
+
+    MeshLaplacianOperator(
+        MeshOperatorCache<Real, Index> const& cache,
+        Real const shift = Real{0.0},
+        Executor const exec = {}) :
+        cache_{&cache},
+        shift_{shift},
+        exec_{exec}
+    {
+    }
+
+    Eigen::Index rows() const { return cache_->num_vertices(); }
+
+    Eigen::Index cols() const { return cache_->num_vertices(); }
+
+    template <typename Rhs>
+    Eigen::Product<MeshLaplacianOperator, Rhs, Eigen::AliasFreeProduct> operator*(
+        Eigen::MatrixBase<Rhs> const& x) const
+    {
+        return {*this, x.derived()};
+    }
+
+    /// Returns the cache of mesh geometry used by this operator
+    MeshOperatorCache<Real, Index> const& cache() const { return *cache_; }
+
+    /// Returns the multiple of the identity added to the negated Laplacian
+    Real shift() const { return shift_; }
+
+    /// Computes the product of this operator with the given vector
+    void apply(Span<Real const> const& x, Span<Real> const& result) const
+    {
+        cache_->apply_laplacian(x, result, 1, exec_);
+        as_vec(result) = shift_ * as_vec(x) - as_vec(result);
+    }
+
+  private:
+    MeshOperatorCache<Real, Index> const* cache_;
+    Real shift_;
+    Executor exec_;
+};
+
+} // namespace dr
+
+namespace Eigen
+{
+namespace internal
+{
+
+template <typename Real, typename Index>
+struct traits<dr::MeshLaplacianOperator<Real, Index>> : traits<SparseMatrix<Real>>
+{
+};
+
+template <typename Real, typename Index, typename Rhs>
+struct generic_product_impl<
+    dr::MeshLaplacianOperator<Real, Index>,
+    Rhs,
+    SparseShape,
+    DenseShape,
+    GemvProduct>
+    : generic_product_impl_base<
+          dr::MeshLaplacianOperator<Real, Index>,
+          Rhs,
+          generic_product_impl<dr::MeshLaplacianOperator<Real, Index>, Rhs>>
+{
+    template <typename Dest>
+    static void scaleAndAddTo(
+        Dest& dst,
+        dr::MeshLaplacianOperator<Real, Index> const& lhs,
+        Rhs const& rhs,
+        Real const& alpha)
+    {
+        // Operands are evaluated into contiguous storage
+        dr::Vec<Real> const x = rhs;
+        dr::Vec<Real> y(x.size());
+        lhs.apply(dr::as_span(x), dr::as_span(y));
+        dst.noalias() += alpha * y;
+    }
+};
+
+} // namespace internal
+} // namespace Eigen
@@ -3,10 +3,13 @@
 #include <cassert>
 
 #include <dr/dynamic_array.hpp>
+#include <dr/executor.hpp>
 #include <dr/geometry.hpp>
 #include <dr/linalg_reshape.hpp>
 #include <dr/linalg_types.hpp>
 #include <dr/math_types.hpp>
+#include <dr/mesh_coloring.hpp>
+#include <dr/sliced_array.hpp>
 #include <dr/span.hpp>
 #include <dr/sparse_linalg_types.hpp>
 
@@ -163,13 +166,12 @@ void eval_gradient(
     Span<Real const> const& vertex_scalars,
     Span<Vec3<Index> const> const& face_vertices,
     Span<Covec3<Real>> const& result,
-    isize const num_threads = 1)
+    Executor const exec = {})
 {
     static_assert(is_real<Real>);
     static_assert(is_integer<Index> || is_natural<Index>);
 
     assert(result.size() == face_vertices.size());
-    assert(num_threads > 0);
 
     auto const loop_body = [&](isize const f) {
         auto const f_v = face_vertices[f];
@@ -182,17 +184,7 @@ void eval_gradient(
             vertex_scalars[f_v[2]]);
     };
 
-    if (num_threads > 1)
-    {
-#pragma omp parallel for num_threads(num_threads) schedule(static)
-        for (isize f = 0; f < face_vertices.size(); ++f)
-            loop_body(f);
-    }
-    else
-    {
-        for (isize f = 0; f < face_vertices.size(); ++f)
-            loop_body(f);
-    }
+    exec.parallel_for(face_vertices.size(), loop_body);
 }
 
 /// Evaluates the Jacobian of a vector-valued function defined on mesh vertices. Returns a matrix
@@ -203,13 +195,12 @@ void eval_jacobian(
     Span<Vec3<Real> const> const& vertex_vectors,
     Span<Vec3<Index> const> const& face_vertices,
     Span<Mat3<Real>> const& result,
-    isize const num_threads = 1)
+    Executor const exec = {})
 {
     static_assert(is_real<Real>);
     static_assert(is_integer<Index> || is_natural<Index>);
 
     assert(result.size() == face_vertices.size());
-    assert(num_threads > 0);
 
     auto const loop_body = [&](isize const f) {
         auto const& f_v = face_vertices[f];
@@ -222,27 +213,20 @@ void eval_jacobian(
             vertex_vectors[f_v[2]]);
     };
 
-    if (num_threads > 1)
-    {
-#pragma omp parallel for num_threads(num_threads) schedule(static)
-        for (isize f = 0; f < face_vertices.size(); ++f)
-            loop_body(f);
-    }
-    else
-    {
-        for (isize f = 0; f < face_vertices.size(); ++f)
-            loop_body(f);
-    }
+    exec.parallel_for(face_vertices.size(), loop_body);
 }
 
-/// Evaluates the divergence of a vector-valued function defined on mesh faces. Returns an
-/// integrated scalar quantity associated with each vertex dual cell.
+namespace impl
+{
+
 template <typename Real, typename Index>
-void eval_divergence(
+void eval_divergence_faces(
     Span<Vec3<Real> const> const& vertex_positions,
     Span<Vec3<Index> const> const& face_vertices,
+    SlicedArray<Index> const* const face_colors,
     Span<Vec3<Real> const> const& face_vectors,
-    Span<Real> const& result)
+    Span<Real> const& result,
+    Executor const exec)
 {
     static_assert(is_real<Real>);
     static_assert(is_integer<Index> || is_natural<Index>);
@@ -251,8 +235,7 @@ void eval_divergence(
     assert(face_vertices.size() == face_vectors.size());
     as_vec(result).setZero();
 
-    for (isize f = 0; f < face_vertices.size(); ++f)
-    {
+    for_each_element(face_vertices.size(), face_colors, exec, [&](isize const f) {
         auto const& f_v = face_vertices[f];
 
         Real div[3]{};
@@ -268,17 +251,17 @@ void eval_divergence(
         result[f_v[0]] += div[0];
         result[f_v[1]] += div[1];
         result[f_v[2]] += div[2];
-    }
+    });
 }
 
-/// Evaluates the Laplacian of a scalar function defined on mesh vertices. Returns an integrated
-/// scalar quantity associated with each vertex dual cell.
 template <typename Real, typename Index>
-void eval_laplacian(
+void eval_laplacian_faces(
     Span<Vec3<Real> const> const& vertex_positions,
     Span<Real const> const& vertex_scalars,
     Span<Vec3<Index> const> const& face_vertices,
-    Span<Real> const& result)
+    SlicedArray<Index> const* const face_colors,
+    Span<Real> const& result,
+    Executor const exec)
 {
     static_assert(is_real<Real>);
     static_assert(is_integer<Index> || is_natural<Index>);
@@ -286,8 +269,7 @@ void eval_laplacian(
     assert(result.size() == vertex_positions.size());
     as_vec(result).setZero();
 
-    for (isize f = 0; f < face_vertices.size(); ++f)
-    {
+    for_each_element(face_vertices.size(), face_colors, exec, [&](isize const f) {
         auto const& f_v = face_vertices[f];
 
         Real lap[3];
@@ -305,17 +287,17 @@ void eval_laplacian(
         result[f_v[0]] += lap[0];
         result[f_v[1]] += lap[1];
         result[f_v[2]] += lap[2];
-    }
+    });
 }
 
-/// Evaluates the Laplacian of a vector-valued function defined on mesh vertices. Returns an
-/// integrated vector quantity associated with each vertex dual cell.
 template <typename Real, typename Index, int dim>
-void eval_laplacian(
+void eval_laplacian_faces(
     Span<Vec3<Real> const> const& vertex_positions,
     Span<Vec<Real, dim> const> const& vertex_vectors,
     Span<Vec3<Index> const> const& face_vertices,
-    Span<Vec<Real, dim>> const& result)
+    SlicedArray<Index> const* const face_colors,
+    Span<Vec<Real, dim>> const& result,
+    Executor const exec)
 {
     static_assert(is_real<Real>);
     static_assert(is_integer<Index> || is_natural<Index>);
@@ -323,8 +305,7 @@ void eval_laplacian(
     assert(result.size() == vertex_positions.size());
     as_vec(result).setZero();
 
-    for (isize f = 0; f < face_vertices.size(); ++f)
-    {
+    for_each_element(face_vertices.size(), face_colors, exec, [&](isize const f) {
         auto const& f_v = face_vertices[f];
 
         Vec<Real, dim> lap[3];
@@ -342,7 +323,123 @@ void eval_laplacian(
         result[f_v[0]] += lap[0];
         result[f_v[1]] += lap[1];
         result[f_v[2]] += lap[2];
-    }
+    });
+}
+
+} // namespace impl
+
+/// Evaluates the divergence of a vector-valued function defined on mesh faces. Returns an
+/// integrated scalar quantity associated with each vertex dual cell.
+template <typename Real, typename Index>
+void eval_divergence(
+    Span<Vec3<Real> const> const& vertex_positions,
+    Span<Vec3<Index> const> const& face_vertices,
+    Span<Vec3<Real> const> const& face_vectors,
+    Span<Real> const& result)
+{
+    impl::eval_divergence_faces<Real, Index>(
+        vertex_positions,
+        face_vertices,
+        nullptr,
+        face_vectors,
+        result,
+        {});
+}
+
+/// Evaluates the divergence of a vector-valued function defined on mesh faces. Faces are processed
+/// in parallel one color at a time using the given face coloring (see color_elements).
+template <typename Real, typename Index>
+void eval_divergence(
+    Span<Vec3<Real> const> const& vertex_positions,
+    Span<Vec3<Index> const> const& face_vertices,
+    SlicedArray<Index> const& face_colors,
+    Span<Vec3<Real> const> const& face_vectors,
+    Span<Real> const& result,
+    Executor const exec = {})
+{
+    impl::eval_divergence_faces<Real, Index>(
+        vertex_positions,
+        face_vertices,
+        &face_colors,
+        face_vectors,
+        result,
+        exec);
+}
+
+/// Evaluates the Laplacian of a scalar function defined on mesh vertices. Returns an integrated
+/// scalar quantity associated with each vertex dual cell.
+template <typename Real, typename Index>
+void eval_laplacian(
+    Span<Vec3<Real> const> const& vertex_positions,
+    Span<Real const> const& vertex_scalars,
+    Span<Vec3<Index> const> const& face_vertices,
+    Span<Real> const& result)
+{
+    impl::eval_laplacian_faces<Real, Index>(
+        vertex_positions,
+        vertex_scalars,
+        face_vertices,
+        nullptr,
+        result,
+        {});
+}
+
+/// Evaluates the Laplacian of a scalar function defined on mesh vertices. Faces are processed in
+/// parallel one color at a time using the given face coloring (see color_elements).
+template <typename Real, typename Index>
+void eval_laplacian(
+    Span<Vec3<Real> const> const& vertex_positions,
+    Span<Real const> const& vertex_scalars,
+    Span<Vec3<Index> const> const& face_vertices,
+    SlicedArray<Index> const& face_colors,
+    Span<Real> const& result,
+    Executor const exec = {})
+{
+    impl::eval_laplacian_faces<Real, Index>(
+        vertex_positions,
+        vertex_scalars,
+        face_vertices,
+        &face_colors,
+        result,
+        exec);
+}
+
+/// Evaluates the Laplacian of a vector-valued function defined on mesh vertices. Returns an
+/// integrated vector quantity associated with each vertex dual cell.
+template <typename Real, typename Index, int dim>
+void eval_laplacian(
+    Span<Vec3<Real> const> const& vertex_positions,
+    Span<Vec<Real, dim> const> const& vertex_vectors,
+    Span<Vec3<Index> const> const& face_vertices,
+    Span<Vec<Real, dim>> const& result)
+{
+    impl::eval_laplacian_faces<Real, Index, dim>(
+        vertex_positions,
+        vertex_vectors,
+        face_vertices,
+        nullptr,
+        result,
+        {});
+}
+
+/// Evaluates the Laplacian of a vector-valued function defined on mesh vertices. Faces are
+/// processed in parallel one color at a time using the given face coloring (see color_elements).
+template <typename Real, typename Index, int dim>
+void eval_laplacian(
+    Span<Vec3<Real> const> const& vertex_positions,
+    Span<Vec<Real, dim> const> const& vertex_vectors,
+    Span<Vec3<Index> const> const& face_vertices,
+    SlicedArray<Index> const& face_colors,
+    Span<Vec<Real, dim>> const& result,
+    Executor const exec = {})
+{
+    impl::eval_laplacian_faces<Real, Index, dim>(
+        vertex_positions,
+        vertex_vectors,
+        face_vertices,
+        &face_colors,
+        result,
+        exec);
 }
 
 } // namespace dr
\ No newline at end of file
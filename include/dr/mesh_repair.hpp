@@ -1,13 +1,83 @@
 #pragma once
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <dr/algorithms.hpp>
 #include <dr/basic_traits.hpp>
+#include <dr/container_utils.hpp>
 #include <dr/dynamic_array.hpp>
+#include <dr/executor.hpp>
 #include <dr/hash_grid.hpp>
 #include <dr/math.hpp>
+#include <dr/memory.hpp>
+#include <dr/sliced_array.hpp>
 #include <dr/span.hpp>
 
 namespace dr
 {
+namespace impl
+{
+
+/// Maximum number of rounds of parallel point welding before the remaining points are processed
+/// sequentially
+constexpr isize weld_max_rounds = 8;
+
+/// Sorts the given values by sorting equal-sized blocks in parallel then merging pairs of adjacent
+/// blocks in parallel
+template <typename T, typename Compare>
+void sort_blocks_then_merge(Span<T> const& values, Compare&& compare, Executor const exec)
+{
+    isize const n = values.size();
+    T* const first = values.data();
+
+    isize const num_blocks = exec.concurrency();
+    if (num_blocks <= 1)
+    {
+        std::sort(first, first + n, compare);
+        return;
+    }
+
+    auto const block_start = [&](isize const block) -> T* {
+        return first + (n * std::min(block, num_blocks)) / num_blocks;
+    };
+
+    exec.run(num_blocks, [&](isize const block) {
+        std::sort(block_start(block), block_start(block + 1), compare);
+    });
+
+    for (isize width = 1; width < num_blocks; width *= 2)
+    {
+        isize const num_merges = (num_blocks + 2 * width - 1) / (2 * width);
+
+        exec.run(num_merges, [&](isize const i) {
+            isize const block = i * 2 * width;
+            std::inplace_merge(
+                block_start(block),
+                block_start(block + width),
+                block_start(block + 2 * width),
+                compare);
+        });
+    }
+}
+
+/// Returns a key for the given grid cell. Coordinates are truncated so distinct cells may share
+/// a key which only results in extra candidates being checked.
+template <int dim>
+u64 weld_cell_key(Vec<i64, dim> const& cell)
+{
+    constexpr int bits = 64 / dim;
+    constexpr u64 mask = (u64{1} << bits) - 1;
+
+    u64 result = 0;
+    for (int i = 0; i < dim; ++i)
+        result |= (u64(cell[i]) & mask) << (i * bits);
+
+    return result;
+}
+
+} // namespace impl
 
 /// Iteratively gathers points within a given range. Returns true if converged.
 template <typename Real, int dim>
@@ -72,6 +142,106 @@ bool gather_points(
     return false;
 }
 
+/// Iteratively gathers points within a given range. Returns true if converged.
+///
+/// Unlike gather_points, each iteration reads from the previous positions and writes to a separate
+/// buffer (i.e. Jacobi rather than Gauss-Seidel) so the result doesn't depend on point order and
+/// points can be updated in parallel. The grid is built once with cells sized for the largest
+/// radius and only rebuilt once points have moved more than a fraction of a cell. Until then,
+/// searches are expanded by the distance points have moved since the last build.
+template <typename Real, int dim>
+bool gather_points_jacobi(
+    Span<Vec<Real, dim>> const& points,
+    HashGrid<Real, dim>& grid,
+    Real const radius_start,
+    Real const radius_end,
+    isize const max_iters = 5,
+    Executor const exec = {},
+    Allocator const alloc = {})
+{
+    static_assert(is_real<Real>);
+
+    constexpr Real rad_scale{8.0};
+    constexpr Real rebuild_frac{0.25};
+
+    isize const n = points.size();
+    Real const cell_size = max(radius_start, radius_end) * rad_scale;
+
+    DynamicArray<Vec<Real, dim>> next(n, alloc);
+
+    // Upper bound on the distance any point has moved since the grid was last built
+    Real drift = std::numeric_limits<Real>::infinity();
+
+    // Returns true if converged
+    auto const step = [&](Real const radius) -> bool {
+        if (drift > rebuild_frac * cell_size)
+        {
+            grid.set_cell_size(cell_size);
+
+            for (isize i = 0; i < n; ++i)
+                grid.insert(points[i], i);
+
+            drift = Real{0.0};
+        }
+
+        Real const search_radius = radius + drift;
+
+        // Sets each point to the weighted average of others within range. Returns the squared
+        // distance moved.
+        auto const update = [&](isize const i) -> Real {
+            Vec<Real, dim> const p = points[i];
+
+            Vec<Real, dim> p_sum{p};
+            Real w_sum = Real{1.0};
+
+            grid.find({p.array() - search_radius, p.array() + search_radius}, [&](i32 const j) {
+                if (j == i)
+                    return;
+
+                Vec<Real, dim> const p_adj = points[j];
+                Real const dist = (p - p_adj).norm();
+                Real const w = smooth_step(radius, Real{0.5} * radius, dist);
+                p_sum += p_adj * w;
+                w_sum += w;
+            });
+
+            next[i] = p_sum / w_sum;
+            return (next[i] - p).squaredNorm();
+        };
+
+        Real const max_sqr_dist = exec.parallel_reduce(
+            n,
+            Real{0.0},
+            [&](Real& acc, isize const i) {
+                acc = max(acc, update(i));
+            },
+            [](Real& acc, Real const& other) {
+                acc = max(acc, other);
+            });
+
+        exec.parallel_for(n, [&](isize const i) {
+            points[i] = next[i];
+        });
+
+        drift += std::sqrt(max_sqr_dist);
+
+        // Converged if largest move was within tolerance
+        constexpr Real rel_tol{1.0e-3};
+        Real const tol = radius * rel_tol;
+        return max_sqr_dist <= tol * tol;
+    };
+
+    Real const t = Real{1.0} / (max_iters - 1);
+    for (int i = 0; i < max_iters; ++i)
+    {
+        Real const radius = lerp(radius_start, radius_end, t * i);
+        if (step(radius))
+            return true;
+    }
+
+    return false;
+}
+
 /// Finds unique points based on a given (Euclidean) distance tolerance. Returns the index of each
 /// unique point along with the mapping from original points to unique points.
 template <typename Real, typename Index, int dim>
@@ -97,21 +267,23 @@ void find_unique_points(
     {
         Vec<Real, dim> const p = points[i];
 
-        constexpr Index invalid_idx{~0};
-        Index unique_idx = invalid_idx;
+        // Search for existing points within range. Ties are broken in favor of the lowest index.
+        bool found = false;
+        Index unique_idx{};
+
+        grid.find({p.array() - tolerance, p.array() + tolerance}, [&](i32 const j) {
+            if ((points[j] - p).squaredNorm() > sqr_tol)
+                return;
 
-        // Search for existing points within range
-        grid.find({p.array() - tolerance, p.array() + tolerance}, [&](i32 const j) -> bool {
-            if ((points[j] - p).squaredNorm() <= sqr_tol)
+            if (!found || point_to_unique[j] < unique_idx)
             {
                 unique_idx = point_to_unique[j];
-                return false;
+                found = true;
             }
-            return true;
         });
 
         // If the point is unique, store its index and add it to the grid
-        if (unique_idx == invalid_idx)
+        if (!found)
         {
             unique_idx = num_unique++;
             unique_points.push_back(i);
@@ -122,6 +294,178 @@ void find_unique_points(
     }
 }
 
+/// Statistics reported by the parallel version of find_unique_points
+struct FindUniquePointsStats
+{
+    /// Number of parallel rounds used to resolve points
+    isize num_rounds;
+
+    /// Number of points left after the last round which were resolved sequentially
+    isize num_sequential;
+};
+
+/// Finds unique points based on a given (Euclidean) distance tolerance. Returns the index of each
+/// unique point along with the mapping from original points to unique points. Results are
+/// identical to the sequential version above.
+///
+/// Points are bucketed by grid cell via a parallel sort. A point is unique if no unique point with
+/// a lower index lies within tolerance, otherwise it maps to the lowest such point. Each point only
+/// depends on lower indexed points in its neighboring cells so points are resolved in parallel
+/// rounds. A point is decided in a round once no undecided lower neighbor could precede the lowest
+/// unique one found so far, so clusters of coincident points are resolved in two rounds. Any points
+/// left after a fixed number of rounds (i.e. long chains of nearby points) are resolved
+/// sequentially.
+template <typename Real, typename Index, int dim>
+FindUniquePointsStats find_unique_points(
+    Span<Vec<Real, dim> const> const& points,
+    Real const tolerance,
+    DynamicArray<Index>& unique_points,
+    Span<Index> const& point_to_unique,
+    Executor const exec = {},
+    Allocator const alloc = {})
+{
+    static_assert(is_real<Real>);
+    static_assert(is_integer<Index> || is_natural<Index>);
+
+    struct CellPoint
+    {
+        u64 key;
+        isize index;
+    };
+
+    isize const n = points.size();
+    assert(point_to_unique.size() == n);
+
+    Real const sqr_tol = tolerance * tolerance;
+    Real const inv_cell_size = (tolerance > Real{0.0}) ? Real{1.0} / tolerance : Real{1.0};
+
+    auto const to_cell = [&](Vec<Real, dim> const& p) -> Vec<i64, dim> {
+        return (p.array() * inv_cell_size).floor().template cast<i64>();
+    };
+
+    // Bucket points by cell. Cells are at least as large as the tolerance so any points within
+    // tolerance of each other are in the same or adjacent cells.
+    DynamicArray<CellPoint> cell_points(n, alloc);
+    exec.parallel_for(n, [&](isize const i) {
+        cell_points[i] = {impl::weld_cell_key(to_cell(points[i])), i};
+    });
+
+    impl::sort_blocks_then_merge(
+        as_span(cell_points),
+        [](CellPoint const& a, CellPoint const& b) -> bool {
+            return (a.key != b.key) ? a.key < b.key : a.index < b.index;
+        },
+        exec);
+
+    // Unique points map to themselves, decided points map to a lower index, undecided points map
+    // to an invalid index
+    constexpr isize invalid_idx = -1;
+    DynamicArray<isize> rep(n, invalid_idx, alloc);
+
+    // Returns the representative of the given point or an invalid index if it depends on an
+    // undecided lower neighbor
+    auto const resolve = [&](isize const i) -> isize {
+        Vec<Real, dim> const& p = points[i];
+        Vec<i64, dim> const cell = to_cell(p);
+
+        // Lowest unique and lowest undecided neighbors within tolerance
+        isize min_unique = i;
+        isize min_undecided = i;
+
+        constexpr isize num_adj = (dim == 2) ? 9 : 27;
+        for (isize k = 0; k < num_adj; ++k)
+        {
+            Vec<i64, dim> adj = cell;
+            for (isize d = 0, code = k; d < dim; ++d, code /= 3)
+                adj[d] += code % 3 - 1;
+
+            u64 const key = impl::weld_cell_key(adj);
+            CellPoint const* it = std::lower_bound(
+                cell_points.data(),
+                cell_points.data() + n,
+                key,
+                [](CellPoint const& a, u64 const b) { return a.key < b; });
+
+            // Only points with lower indices are relevant
+            for (; it != cell_points.data() + n && it->key == key && it->index < i; ++it)
+            {
+                isize const j = it->index;
+                if ((points[j] - p).squaredNorm() > sqr_tol)
+                    continue;
+
+                if (rep[j] == invalid_idx)
+                    min_undecided = std::min(min_undecided, j);
+                else if (rep[j] == j)
+                    min_unique = std::min(min_unique, j);
+            }
+        }
+
+        // An undecided neighbor only matters if it could become a lower unique point
+        return (min_undecided < min_unique) ? invalid_idx : min_unique;
+    };
+
+    DynamicArray<isize> pending(n, alloc);
+    for (isize i = 0; i < n; ++i)
+        pending[i] = i;
+
+    DynamicArray<isize> next(n, alloc);
+    FindUniquePointsStats stats{};
+
+    for (; stats.num_rounds < impl::weld_max_rounds && size(pending) > 0; ++stats.num_rounds)
+    {
+        isize const num_pending = size(pending);
+
+        // Decisions are buffered so that each round only observes the previous one. The cost of
+        // each decision depends on the number of nearby points so work is balanced dynamically.
+        exec.parallel_for_dynamic(num_pending, [&](isize const k) {
+            next[k] = resolve(pending[k]);
+        });
+
+        isize num_remaining = 0;
+        for (isize k = 0; k < num_pending; ++k)
+        {
+            if (next[k] == invalid_idx)
+                pending[num_remaining++] = pending[k];
+            else
+                rep[pending[k]] = next[k];
+        }
+
+        pending.resize(num_remaining);
+    }
+
+    // Resolve any remaining points in order
+    stats.num_sequential = size(pending);
+    for (isize const i : pending)
+    {
+        rep[i] = resolve(i);
+        assert(rep[i] != invalid_idx);
+    }
+
+    // Assign consecutive indices to unique points
+    DynamicArray<Index> unique_ends(n, alloc);
+    exec.parallel_for(n, [&](isize const i) {
+        unique_ends[i] = Index(rep[i] == i);
+    });
+
+    inclusive_scan(
+        as_span(unique_ends).as_const(),
+        as_span(unique_ends),
+        exec,
+        alloc);
+
+    unique_points.resize((n > 0) ? isize(unique_ends[n - 1]) : 0);
+
+    exec.parallel_for(n, [&](isize const i) {
+        Index const unique_idx = unique_ends[rep[i]] - 1;
+        point_to_unique[i] = unique_idx;
+
+        if (rep[i] == i)
+            unique_points[unique_idx] = Index(i);
+    });
+
+    return stats;
+}
+
 /// Removes values associated with non-unique vertices from the given array. Returns the truncated
 /// array of values associated with unique vertices. To allow for in-place removal, the given array
 /// of unique vertices is assumed to be monotonic increasing.
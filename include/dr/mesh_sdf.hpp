@@ -0,0 +1,398 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#include <dr/basic_traits.hpp>
+#include <dr/container_utils.hpp>
+#include <dr/dynamic_array.hpp>
+#include <dr/executor.hpp>
+#include <dr/geometry.hpp>
+#include <dr/grid.hpp>
+#include <dr/math.hpp>
+#include <dr/math_types.hpp>
+#include <dr/memory.hpp>
+#include <dr/sliced_array.hpp>
+#include <dr/span.hpp>
+
+namespace dr
+{
+namespace impl
+{
+
+/// Width of the slabs used to process faces in parallel (in grid points)
+constexpr isize sdf_slab_width = 4;
+
+/// Returns the range of grid points within the given padding of a face's bounding box. Only the
+/// first num_axes axes are considered. Returns false if the range is empty.
+template <typename Real, typename Index>
+bool sdf_face_range(
+    Span<Vec3<Real> const> const& vertex_positions,
+    Vec3<Index> const& f_v,
+    Grid3<Real> const& grid,
+    Real const padding,
+    int const num_axes,
+    Vec3<isize>& start,
+    Vec3<isize>& end)
+{
+    Vec3<Real> const p0 = grid.to_grid(vertex_positions[f_v[0]]);
+    Vec3<Real> const p1 = grid.to_grid(vertex_positions[f_v[1]]);
+    Vec3<Real> const p2 = grid.to_grid(vertex_positions[f_v[2]]);
+
+    for (int i = 0; i < num_axes; ++i)
+    {
+        Real const lo = std::min({p0[i], p1[i], p2[i]}) - padding;
+        Real const hi = std::max({p0[i], p1[i], p2[i]}) + padding;
+
+        start[i] = std::max<isize>(isize(std::ceil(lo)), 0);
+        end[i] = std::min<isize>(isize(std::floor(hi)) + 1, grid.shape[i]);
+
+        if (start[i] >= end[i])
+            return false;
+    }
+
+    return true;
+}
+
+/// Sorts faces into slabs of grid points along the given axis. Faces are added to each slab that
+/// their padded bounding box overlaps (see sdf_face_range).
+template <typename Real, typename Index>
+void sdf_bin_faces(
+    Span<Vec3<Real> const> const& vertex_positions,
+    Span<Vec3<Index> const> const& face_vertices,
+    Grid3<Real> const& grid,
+    Real const padding,
+    int const num_axes,
+    int const axis,
+    SlicedArray<isize, isize>& result)
+{
+    constexpr isize w = sdf_slab_width;
+    isize const num_slabs = (grid.shape[axis] + w - 1) / w;
+
+    DynamicArray<isize> counts(num_slabs, 0, result.allocator());
+    Vec3<isize> start;
+    Vec3<isize> end;
+
+    for (auto const& f_v : face_vertices)
+    {
+        if (sdf_face_range(vertex_positions, f_v, grid, padding, num_axes, start, end))
+        {
+            for (isize i = start[axis] / w; i <= (end[axis] - 1) / w; ++i)
+                ++counts[i];
+        }
+    }
+
+    result.assign_sizes(as_span(counts).as_const());
+    std::fill(counts.begin(), counts.end(), 0);
+
+    for (isize f = 0; f < face_vertices.size(); ++f)
+    {
+        if (sdf_face_range(vertex_positions, face_vertices[f], grid, padding, num_axes, start, end))
+        {
+            for (isize i = start[axis] / w; i <= (end[axis] - 1) / w; ++i)
+                result[i][counts[i]++] = f;
+        }
+    }
+}
+
+/// Returns the distance from a point to a face
+template <typename Real, typename Index>
+Real sdf_face_distance(
+    Span<Vec3<Real> const> const& vertex_positions,
+    Vec3<Index> const& f_v,
+    Vec3<Real> const& point)
+{
+    Vec3<Real> const& a = vertex_positions[f_v[0]];
+    Vec3<Real> const& b = vertex_positions[f_v[1]];
+    Vec3<Real> const& c = vertex_positions[f_v[2]];
+
+    Vec3<Real> const w = nearest_point_tri(point, a, b, c);
+    return (point - (a * w[0] + b * w[1] + c * w[2])).norm();
+}
+
+/// Clips a row of grid points to those within the given distance of a plane. The signed distance
+/// from the plane changes by the given step between adjacent points in the row and is dist_start
+/// at the start of the row. Returns false if the clipped row is empty.
+template <typename Real>
+bool sdf_clip_row(
+    Real const dist_start,
+    Real const step,
+    Real const max_dist,
+    isize& start,
+    isize& end)
+{
+    if (step == Real{0.0})
+        return abs(dist_start) <= max_dist;
+
+    Real t0 = (-max_dist - dist_start) / step;
+    Real t1 = (max_dist - dist_start) / step;
+
+    if (t0 > t1)
+        std::swap(t0, t1);
+
+    t0 = std::max(std::ceil(t0), Real{0.0});
+    t1 = std::min(std::floor(t1), Real(end - start - 1));
+
+    if (t0 > t1)
+        return false;
+
+    end = start + isize(t1) + 1;
+    start += isize(t0);
+    return true;
+}
+
+/// Returns true if the given edge is a top or left edge of a counter-clockwise triangle. Used to
+/// break ties when a point lies exactly on an edge shared by two triangles.
+template <typename Real>
+bool sdf_is_top_left(Vec2<Real> const& a, Vec2<Real> const& b)
+{
+    return (b[1] < a[1]) || (b[1] == a[1] && b[0] < a[0]);
+}
+
+} // namespace impl
+
+/// Computes the signed distance from each point of a grid to a closed triangle mesh. Values are
+/// negative inside the mesh and written to the result in row-major order (see grid_to_index).
+///
+/// Distances are first evaluated exactly within a narrow band around each face. The nearest face
+/// of each point in the band is then propagated to the rest of the grid by sweeping back and forth
+/// along each axis. Propagated distances can be slightly overestimated near the medial axis where
+/// the nearest face changes. Sign is given by the parity of ray crossings along the z axis so the
+/// mesh is assumed to be closed. The total cost is linear in the number of grid points plus, for
+/// each face, the number of grid points near it and the number of rows of grid points along the x
+/// axis which cross its bounding box.
+template <typename Real, typename Index>
+void signed_distance_field(
+    Span<Vec3<Real> const> const& vertex_positions,
+    Span<Vec3<Index> const> const& face_vertices,
+    Grid3<Real> const& grid,
+    Span<Real> const& result,
+    Executor const exec = {},
+    Allocator const alloc = {})
+{
+    static_assert(is_real<Real>);
+    static_assert(is_integer<Index> || is_natural<Index>);
+
+    constexpr isize w = impl::sdf_slab_width;
+    constexpr Index invalid_idx{~0};
+    constexpr Real band_width{1.0};
+    constexpr Real inf = std::numeric_limits<Real>::infinity();
+
+    assert(result.size() == grid.shape.prod());
+    std::fill(begin(result), end(result), inf);
+
+    Vec3<isize> const stride = grid.stride();
+    DynamicArray<Index> nearest(grid.shape.prod(), invalid_idx, alloc);
+    SlicedArray<isize, isize> slab_faces{alloc};
+
+    // Evaluate distances in a narrow band around each face. Faces are binned by slab along the z
+    // axis so that each slab can be processed independently. Within a face's bounding box, each
+    // row of grid points is clipped to those near the face's plane so that large oblique faces
+    // don't visit every point in their bounding box.
+    {
+        impl::sdf_bin_faces(vertex_positions, face_vertices, grid, band_width, 3, 2, slab_faces);
+        Real const max_plane_dist = band_width * grid.spacing.norm();
+
+        exec.run(slab_faces.num_slices(), [&](isize const slab) {
+            Vec3<isize> start;
+            Vec3<isize> end;
+
+            for (isize const f : slab_faces[slab])
+            {
+                auto const& f_v = face_vertices[f];
+                impl::sdf_face_range(vertex_positions, f_v, grid, band_width, 3, start, end);
+
+                // Degenerate faces have no plane to clip against
+                Vec3<Real> const& a = vertex_positions[f_v[0]];
+                Vec3<Real> normal =
+                    (vertex_positions[f_v[1]] - a).cross(vertex_positions[f_v[2]] - a);
+
+                if (Real const n = normal.norm(); n > Real{0.0})
+                    normal /= n;
+
+                Real const step = normal[0] * grid.spacing[0];
+
+                isize const k_end = std::min(end[2], (slab + 1) * w);
+                for (isize k = std::max(start[2], slab * w); k < k_end; ++k)
+                {
+                    for (isize j = start[1]; j < end[1]; ++j)
+                    {
+                        isize i_start = start[0];
+                        isize i_end = end[0];
+                        Real const dist_start =
+                            normal.dot(grid.to_world(Vec3<isize>{i_start, j, k}) - a);
+
+                        if (!impl::sdf_clip_row(dist_start, step, max_plane_dist, i_start, i_end))
+                            continue;
+
+                        for (isize i = i_start; i < i_end; ++i)
+                        {
+                            Vec3<isize> const p{i, j, k};
+                            isize const index = grid_to_index(p, stride);
+                            Real const d = impl::sdf_face_distance(
+                                vertex_positions,
+                                f_v,
+                                grid.to_world(p));
+
+                            if (d < result[index])
+                            {
+                                result[index] = d;
+                                nearest[index] = Index(f);
+                            }
+                        }
+                    }
+                }
+            }
+        });
+    }
+
+    // Propagate nearest faces to the rest of the grid. Each sweep runs along lines of grid points
+    // parallel to one axis which are independent of each other.
+    for (isize iter = 0; iter < 2; ++iter)
+    {
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            int const axis_u = (axis + 1) % 3;
+            int const axis_v = (axis + 2) % 3;
+            isize const n = grid.shape[axis];
+
+            for (isize const dir : {1, -1})
+            {
+                isize const step = stride[axis] * dir;
+
+                auto const sweep_line = [&](isize const line) {
+                    Vec3<isize> p;
+                    p[axis] = (dir > 0) ? 0 : n - 1;
+                    p[axis_u] = line % grid.shape[axis_u];
+                    p[axis_v] = line / grid.shape[axis_u];
+
+                    isize index = grid_to_index(p, stride);
+
+                    for (isize i = 1; i < n; ++i)
+                    {
+                        Index const f = nearest[index];
+                        p[axis] += dir;
+                        index += step;
+
+                        if (f == invalid_idx || f == nearest[index])
+                            continue;
+
+                        Real const d = impl::sdf_face_distance(
+                            vertex_positions,
+                            face_vertices[f],
+                            grid.to_world(p));
+
+                        if (d < result[index])
+                        {
+                            result[index] = d;
+                            nearest[index] = f;
+                        }
+                    }
+                };
+
+                isize const num_lines = grid.shape[axis_u] * grid.shape[axis_v];
+                exec.run(num_lines, sweep_line);
+            }
+        }
+    }
+
+    // Determine sign via the parity of ray crossings along the z axis. Each face toggles the
+    // parity of the first grid point above it in each column it covers. Faces are binned by slab
+    // along the y axis so that each slab can be processed independently.
+    {
+        DynamicArray<u8> parity(grid.shape.prod(), u8{0}, alloc);
+        impl::sdf_bin_faces(vertex_positions, face_vertices, grid, Real{0.0}, 2, 1, slab_faces);
+
+        exec.run(slab_faces.num_slices(), [&](isize const slab) {
+            Vec3<isize> start;
+            Vec3<isize> end;
+
+            for (isize const f : slab_faces[slab])
+            {
+                auto const& f_v = face_vertices[f];
+                impl::sdf_face_range(vertex_positions, f_v, grid, Real{0.0}, 2, start, end);
+
+                Vec3<Real> const p0 = grid.to_grid(vertex_positions[f_v[0]]);
+                Vec3<Real> p1 = grid.to_grid(vertex_positions[f_v[1]]);
+                Vec3<Real> p2 = grid.to_grid(vertex_positions[f_v[2]]);
+
+                // Skip faces which are degenerate when projected onto the xy plane
+                Real area = cross<Real>(
+                    (p1 - p0).template head<2>(),
+                    (p2 - p0).template head<2>());
+
+                if (area == Real{0.0})
+                    continue;
+
+                // Ensure counter-clockwise orientation in the xy plane
+                if (area < Real{0.0})
+                {
+                    std::swap(p1, p2);
+                    area = -area;
+                }
+
+                Vec2<Real> const q[]{
+                    p0.template head<2>(),
+                    p1.template head<2>(),
+                    p2.template head<2>(),
+                };
+                bool const top_left[]{
+                    impl::sdf_is_top_left(q[1], q[2]),
+                    impl::sdf_is_top_left(q[2], q[0]),
+                    impl::sdf_is_top_left(q[0], q[1]),
+                };
+
+                isize const j_end = std::min(end[1], (slab + 1) * w);
+                for (isize j = std::max(start[1], slab * w); j < j_end; ++j)
+                {
+                    for (isize i = start[0]; i < end[0]; ++i)
+                    {
+                        Vec2<Real> const p{Real(i), Real(j)};
+                        Real const b[]{
+                            cross<Real>(q[2] - q[1], p - q[1]),
+                            cross<Real>(q[0] - q[2], p - q[2]),
+                            cross<Real>(q[1] - q[0], p - q[0]),
+                        };
+
+                        bool is_inside = true;
+                        for (int k = 0; k < 3; ++k)
+                        {
+                            if (b[k] < Real{0.0} || (b[k] == Real{0.0} && !top_left[k]))
+                            {
+                                is_inside = false;
+                                break;
+                            }
+                        }
+
+                        if (!is_inside)
+                            continue;
+
+                        Real const z = (b[0] * p0[2] + b[1] * p1[2] + b[2] * p2[2]) / area;
+                        isize const k = std::max<isize>(isize(std::ceil(z)), 0);
+
+                        if (k < grid.shape[2])
+                            parity[grid_to_index(Vec3<isize>{i, j, k}, stride)] ^= 1;
+                    }
+                }
+            }
+        });
+
+        exec.run(grid.shape[0] * grid.shape[1], [&](isize const column) {
+            u8 is_inside = 0;
+
+            for (isize k = 0; k < grid.shape[2]; ++k)
+            {
+                isize const index = column + k * stride[2];
+                is_inside ^= parity[index];
+
+                if (is_inside)
+                    result[index] = -result[index];
+            }
+        });
+    }
+}
+
+} // namespace dr
@@ -0,0 +1,249 @@
+#pragma once
+
+/*
+    Deformation of meshes by blending many transformations per vertex
+*/
+
+#include <cassert>
+
+#include <dr/basic_traits.hpp>
+#include <dr/container_utils.hpp>
+#include <dr/dynamic_array.hpp>
+#include <dr/executor.hpp>
+#include <dr/math_types.hpp>
+#include <dr/memory.hpp>
+#include <dr/sliced_array.hpp>
+#include <dr/span.hpp>
+#include <dr/transform.hpp>
+
+namespace dr
+{
+
+enum SkinningMode : u8
+{
+    SkinningMode_LinearBlend = 0,
+    SkinningMode_DualQuat,
+    _SkinningMode_Count
+};
+
+/// Weighted influence of a transformation on a vertex
+template <typename Real, typename Index = i32>
+struct SkinWeight
+{
+    Index transform;
+    Real weight;
+};
+
+namespace impl
+{
+
+template <typename Real>
+Real skin_scale(Rigid3<Real> const& /*xform*/)
+{
+    return Real{1.0};
+}
+
+template <typename Real>
+Real skin_scale(Conformal3<Real> const& xform)
+{
+    return xform.scale;
+}
+
+/// Returns the unit dual quaternion representation of the given rotation and translation. The real
+/// part is stored in the first 4 coefficients and the dual part in the last 4 (each as x, y, z, w).
+template <typename Real>
+Vec<Real, 8> skin_dual_quat(Rotation3<Real> const& rotation, Vec3<Real> const& translation)
+{
+    Quat<Real> const& q = rotation.q;
+    Vec3<Real> const& t = translation;
+    Quat<Real> const d = Quat<Real>{Real{0.0}, t[0], t[1], t[2]} * q;
+
+    Vec<Real, 8> result;
+    result.template head<4>() = q.coeffs();
+    result.template tail<4>() = Real{0.5} * d.coeffs();
+    return result;
+}
+
+template <typename Transform, typename Real, typename Index>
+void skin(
+    Span<Transform const> const& transforms,
+    SlicedArray<SkinWeight<Real, Index>, Index> const& influences,
+    Span<Vec3<Real> const> const& rest_positions,
+    Span<Vec3<Real>> const& result_positions,
+    Span<Vec3<Real> const> const& rest_normals,
+    Span<Vec3<Real>> const& result_normals,
+    SkinningMode const mode,
+    Executor const exec,
+    Allocator const alloc)
+{
+    static_assert(is_real<Real>);
+    static_assert(is_integer<Index> || is_natural<Index>);
+
+    isize const num_verts = rest_positions.size();
+    bool const has_normals = rest_normals.size() > 0;
+
+    assert(influences.num_slices() == num_verts);
+    assert(result_positions.size() == num_verts);
+    assert(!has_normals || rest_normals.size() == num_verts);
+    assert(result_normals.size() == rest_normals.size());
+
+    auto const copy_rest = [&](isize const v) {
+        result_positions[v] = rest_positions[v];
+
+        if (has_normals)
+            result_normals[v] = rest_normals[v];
+    };
+
+    switch (mode)
+    {
+        case SkinningMode_LinearBlend:
+        {
+            // Precompute the matrix of each transformation
+            DynamicArray<Mat<Real, 3, 4>> matrices(transforms.size(), alloc);
+            for (isize i = 0; i < transforms.size(); ++i)
+            {
+                Affine3<Real> const xform = transforms[i];
+                matrices[i] << xform.linear, xform.translation;
+            }
+
+            exec.parallel_for(num_verts, [&](isize const v) {
+                auto const weights = influences[Index(v)];
+
+                if (weights.size() == 0)
+                {
+                    copy_rest(v);
+                    return;
+                }
+
+                Mat<Real, 3, 4> m = Mat<Real, 3, 4>::Zero();
+                for (auto const& [xform, w] : weights)
+                    m += w * matrices[xform];
+
+                result_positions[v] = m * rest_positions[v].homogeneous();
+
+                // The blended linear part isn't orthogonal in general so normals are transformed by
+                // its inverse transpose
+                if (has_normals)
+                {
+                    Mat3<Real> const n = m.template leftCols<3>().inverse().transpose();
+                    result_normals[v] = (n * rest_normals[v]).normalized();
+                }
+            });
+
+            break;
+        }
+        case SkinningMode_DualQuat:
+        {
+            // Precompute the dual quaternion and scale of each transformation
+            DynamicArray<Vec<Real, 8>> dual_quats(transforms.size(), alloc);
+            DynamicArray<Real> scales(transforms.size(), alloc);
+
+            for (isize i = 0; i < transforms.size(); ++i)
+            {
+                dual_quats[i] = skin_dual_quat(transforms[i].rotation, transforms[i].translation);
+                scales[i] = skin_scale(transforms[i]);
+            }
+
+            exec.parallel_for(num_verts, [&](isize const v) {
+                auto const weights = influences[Index(v)];
+
+                if (weights.size() == 0)
+                {
+                    copy_rest(v);
+                    return;
+                }
+
+                // Blend in the same hemisphere as the first influence to take the shortest path
+                Vec4<Real> const pivot = dual_quats[weights[0].transform].template head<4>();
+                Vec<Real, 8> b = Vec<Real, 8>::Zero();
+                Real s{0.0};
+
+                for (auto const& [xform, w] : weights)
+                {
+                    Vec<Real, 8> const& dq = dual_quats[xform];
+                    b += (dq.template head<4>().dot(pivot) < Real{0.0}) ? -w * dq : w * dq;
+                    s += w * scales[xform];
+                }
+
+                Real const b_norm = b.template head<4>().norm();
+                Quat<Real> const q{Vec4<Real>{b.template head<4>() / b_norm}};
+                Quat<Real> const d{Vec4<Real>{b.template tail<4>() / b_norm}};
+
+                Mat3<Real> const r = q.toRotationMatrix();
+                Vec3<Real> const t = Real{2.0} * (d * q.conjugate()).vec();
+
+                result_positions[v] = r * (s * rest_positions[v]) + t;
+
+                if (has_normals)
+                    result_normals[v] = r * rest_normals[v];
+            });
+
+            break;
+        }
+        default:
+        {
+            assert(false);
+        }
+    }
+}
+
+} // namespace impl
+
+/// Deforms vertex positions by blending the transformations which influence each vertex.
+/// Influences of each vertex are stored in the corresponding slice and their weights are assumed
+/// to sum to one. Vertices without influences are left at rest.
+///
+/// Transformations are converted to matrices (linear blend) or dual quaternions (dual quaternion
+/// blend) once up front so that the per-vertex work is a fixed-size weighted sum followed by a
+/// single transformation. Dual quaternion blending preserves volume around joints. Scale is
+/// blended linearly and applied before rotation.
+template <typename Transform, typename Real, typename Index>
+void skin(
+    Span<Transform const> const& transforms,
+    SlicedArray<SkinWeight<Real, Index>, Index> const& influences,
+    Span<Vec3<Real> const> const& rest_positions,
+    Span<Vec3<Real>> const& result_positions,
+    SkinningMode const mode = SkinningMode_LinearBlend,
+    Executor const exec = {},
+    Allocator const alloc = {})
+{
+    impl::skin(
+        transforms,
+        influences,
+        rest_positions,
+        result_positions,
+        Span<Vec3<Real> const>{},
+        Span<Vec3<Real>>{},
+        mode,
+        exec,
+        alloc);
+}
+
+/// Deforms vertex positions and unit normals by blending the transformations which influence each
+/// vertex (see above). Normals are transformed by the inverse transpose of the blended linear part
+/// (linear blend) or by the blended rotation (dual quaternion blend) and renormalized.
+template <typename Transform, typename Real, typename Index>
+void skin(
+    Span<Transform const> const& transforms,
+    SlicedArray<SkinWeight<Real, Index>, Index> const& influences,
+    Span<Vec3<Real> const> const& rest_positions,
+    Span<Vec3<Real>> const& result_positions,
+    Span<Vec3<Real> const> const& rest_normals,
+    Span<Vec3<Real>> const& result_normals,
+    SkinningMode const mode = SkinningMode_LinearBlend,
+    Executor const exec = {},
+    Allocator const alloc = {})
+{
+    impl::skin(
+        transforms,
+        influences,
+        rest_positions,
+        result_positions,
+        rest_normals,
+        result_normals,
+        mode,
+        exec,
+        alloc);
+}
+
+} // namespace dr
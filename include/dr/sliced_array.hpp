@@ -2,10 +2,13 @@
 
 #include <cassert>
 #include <initializer_list>
+#include <type_traits>
 
+#include <dr/algorithms.hpp>
 #include <dr/basic_types.hpp>
 #include <dr/container_utils.hpp>
 #include <dr/dynamic_array.hpp>
+#include <dr/executor.hpp>
 #include <dr/memory.hpp>
 #include <dr/span.hpp>
 
@@ -101,6 +104,17 @@ struct SlicedArray : AllocatorAware
         slice_ends.clear();
     }
 
+    /// Resizes the array to hold slices of the given sizes. Existing items are discarded and new
+    /// items are value-initialized. Once sized, slices can be filled concurrently via operator[].
+    void assign_sizes(Span<Index const> const& slice_sizes, Executor const exec = {})
+    {
+        slice_ends.resize(slice_sizes.size());
+        inclusive_scan(slice_sizes, as_span(slice_ends), exec, allocator());
+
+        items.clear();
+        items.resize(slice_ends.empty() ? 0 : slice_ends.back());
+    }
+
     /// Reserves storage for the specified number of items and slices
     void reserve(Index const item_capacity, Index const slice_capacity)
     {
@@ -128,4 +142,41 @@ struct SlicedArray : AllocatorAware
     }
 };
 
-} // namespace dr
\ No newline at end of file
+/// Builds a sliced array from a kernel which emits a variable number of items per slice. This is
+/// done in two passes: the first calls `count(i)` to get the size of each slice and the second
+/// calls `fill(i, slice)` to assign its items. Since the cost of each slice tends to vary, both
+/// passes are balanced dynamically.
+template <typename T, typename Index, typename Count, typename Fill>
+void count_then_fill(
+    Index const num_slices,
+    Count&& count,
+    Fill&& fill,
+    SlicedArray<T, Index>& result,
+    Executor const exec = {})
+{
+    static_assert(std::is_invocable_r_v<Index, Count, Index>);
+    static_assert(std::is_invocable_v<Fill, Index, Span<T>>);
+
+    auto& slice_ends = result.slice_ends;
+    slice_ends.resize(num_slices);
+
+    exec.parallel_for_dynamic(num_slices, [&](isize const i) {
+        slice_ends[i] = count(Index(i));
+    });
+
+    // Slice sizes are converted to slice ends in-place
+    inclusive_scan(
+        as_span(slice_ends).as_const(),
+        as_span(slice_ends),
+        exec,
+        result.allocator());
+
+    result.items.clear();
+    result.items.resize(slice_ends.empty() ? 0 : slice_ends.back());
+
+    exec.parallel_for_dynamic(num_slices, [&](isize const i) {
+        fill(Index(i), result[Index(i)]);
+    });
+}
+
+} // namespace dr
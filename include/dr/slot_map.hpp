@@ -1,11 +1,15 @@
 #pragma once
 
+#include <atomic>
+#include <new>
 #include <utility>
 
 #include <dr/basic_types.hpp>
+#include <dr/bitwise.hpp>
 #include <dr/container_utils.hpp>
 #include <dr/dynamic_array.hpp>
 #include <dr/memory.hpp>
+#include <dr/span.hpp>
 
 namespace dr
 {
@@ -56,6 +60,7 @@ struct SlotMap : AllocatorAware
             // Use existing slot
             Slot& slot = slots_[index];
             slot.item = make_item(std::forward<Args>(args)...);
+            slot.status.flags &= ~Index{Flag_Free};
 
             return {index, slot.status.version};
         }
@@ -85,7 +90,7 @@ struct SlotMap : AllocatorAware
     }
 
     /// Returns true if the handle refers to a valid item
-    bool is_valid(Handle const handle)
+    bool is_valid(Handle const handle) const
     {
         return slots_[handle.index].status.version == handle.version;
     }
@@ -100,11 +105,14 @@ struct SlotMap : AllocatorAware
     }
 
     /// Returns the item associated with the given handle or null if the handle isn't valid
-    T const* operator[](Handle const handle) const { return const_cast<T&>(*this)[handle]; }
+    T const* operator[](Handle const handle) const
+    {
+        return const_cast<SlotMap<T, Index, version_bits>&>(*this)[handle];
+    }
 
     /// Returns the handle to the item at the given index if one exists. Otherwise, returns an
     /// invalid handle.
-    Handle handle_at(Index const index)
+    Handle handle_at(Index const index) const
     {
         auto const& slot = slots_[index];
         return (slot.status.flags & Flag_Free) //
@@ -113,10 +121,27 @@ struct SlotMap : AllocatorAware
     }
 
     /// Returns the number of items in the map
-    isize num_items() { return isize(slots_.size() - free_indices_.size()); }
+    isize num_items() const { return isize(slots_.size() - free_indices_.size()); }
 
     /// Returns the number of slots in the map
-    isize num_slots() { return isize(slots_.size()); }
+    isize num_slots() const { return isize(slots_.size()); }
+
+    /// Removes all items from the map. Any existing handles are invalidated.
+    void clear()
+    {
+        for (Index i = 0; i < Index(slots_.size()); ++i)
+        {
+            if ((slots_[i].status.flags & Flag_Free) == 0)
+                remove(handle_at(i));
+        }
+    }
+
+    /// Reserves storage for the specified number of slots
+    void reserve(isize const slot_capacity)
+    {
+        slots_.reserve(slot_capacity);
+        free_indices_.reserve(slot_capacity);
+    }
 
   private:
     static constexpr auto flag_bits = index_bits;
@@ -151,4 +176,448 @@ struct SlotMap : AllocatorAware
     DynamicArray<Index> free_indices_;
 };
 
+/// Variant of SlotMap which stores items contiguously. Items are relocated on removal so pointers
+/// to items are only stable until the next call to remove.
+template <typename T, typename Index = u64, int version_bits = (8 * sizeof(Index) / 2)>
+struct DenseSlotMap : AllocatorAware
+{
+    static constexpr int index_bits = (8 * sizeof(Index)) - version_bits;
+    static_assert(index_bits > 0 && version_bits > 0);
+
+    struct Handle
+    {
+        Index index : index_bits;
+        Index version : version_bits;
+    };
+
+    DenseSlotMap(Allocator const alloc = {}) :
+        items_(alloc),
+        item_slots_(alloc),
+        slots_(alloc),
+        free_indices_(alloc)
+    {
+    }
+
+    DenseSlotMap(DenseSlotMap const& other, Allocator const alloc = {}) :
+        items_(other.items_, alloc),
+        item_slots_(other.item_slots_, alloc),
+        slots_(other.slots_, alloc),
+        free_indices_(other.free_indices_, alloc)
+    {
+    }
+
+    DenseSlotMap(DenseSlotMap&& other) noexcept = default;
+    DenseSlotMap& operator=(DenseSlotMap const& other) = default;
+    DenseSlotMap& operator=(DenseSlotMap&& other) = default;
+
+    /// Returns the allocator used by this container
+    Allocator allocator() const { return items_.get_allocator(); }
+
+    /// Inserts a new item into the map by constructing it in-place. Returns a valid handle to the
+    /// new item.
+    template <typename... Args>
+    Handle insert(Args&&... args)
+    {
+        Index index;
+        Index const item = Index(items_.size());
+
+        if (free_indices_.empty())
+        {
+            index = Index(slots_.size());
+            slots_.push_back({item, Index{1}});
+        }
+        else
+        {
+            // Use existing slot
+            index = free_indices_.back();
+            free_indices_.pop_back();
+            slots_[index].item = item;
+        }
+
+        // NOTE: Allocator-aware items share this container's allocator via uses-allocator
+        // construction
+        items_.emplace_back(std::forward<Args>(args)...);
+        item_slots_.push_back(index);
+
+        return {index, slots_[index].version};
+    }
+
+    /// Removes the item at the given handle if it's valid. Returns true on success.
+    bool remove(Handle const handle)
+    {
+        constexpr Index max_version = (Index{1} << version_bits) - Index{1};
+
+        if (!is_valid(handle))
+            return false;
+
+        Slot& slot = slots_[handle.index];
+
+        // Move the last item into the removed item's position
+        Index const last = Index(items_.size() - 1);
+        if (slot.item != last)
+        {
+            items_[slot.item] = std::move(items_[last]);
+            item_slots_[slot.item] = item_slots_[last];
+            slots_[item_slots_[last]].item = slot.item;
+        }
+
+        items_.pop_back();
+        item_slots_.pop_back();
+
+        // Mark slot as free
+        slot.item = invalid_item_;
+
+        // Reuse the slot if its version isn't maxed out
+        if (++slot.version < max_version)
+            free_indices_.push_back(handle.index);
+
+        return true;
+    }
+
+    /// Returns true if the handle refers to a valid item
+    bool is_valid(Handle const handle) const
+    {
+        if (Index(handle.index) >= Index(slots_.size()))
+            return false;
+
+        Slot const& slot = slots_[handle.index];
+        return slot.item != invalid_item_ && slot.version == handle.version;
+    }
+
+    /// Returns the item associated with the given handle or null if the handle isn't valid
+    T* operator[](Handle const handle)
+    {
+        return is_valid(handle) ? &items_[slots_[handle.index].item] : nullptr;
+    }
+
+    /// Returns the item associated with the given handle or null if the handle isn't valid
+    T const* operator[](Handle const handle) const
+    {
+        return const_cast<DenseSlotMap<T, Index, version_bits>&>(*this)[handle];
+    }
+
+    /// Returns the handle to the item at the given position in the packed item array
+    Handle handle_at(isize const item) const
+    {
+        Index const index = item_slots_[item];
+        return {index, slots_[index].version};
+    }
+
+    /// Returns a view of all items in the map. Items are packed but unordered.
+    Span<T> items() { return as_span(items_); }
+
+    /// Returns a view of all items in the map. Items are packed but unordered.
+    Span<T const> items() const { return as_span(items_); }
+
+    /// Returns the number of items in the map
+    isize num_items() const { return isize(items_.size()); }
+
+    /// Returns the number of slots in the map
+    isize num_slots() const { return isize(slots_.size()); }
+
+    /// Removes all items from the map. Any existing handles are invalidated.
+    void clear()
+    {
+        while (!items_.empty())
+            remove(handle_at(num_items() - 1));
+    }
+
+    /// Reserves storage for the specified number of items
+    void reserve(isize const capacity)
+    {
+        items_.reserve(capacity);
+        item_slots_.reserve(capacity);
+        slots_.reserve(capacity);
+        free_indices_.reserve(capacity);
+    }
+
+  private:
+    static constexpr Index invalid_item_{~Index{0}};
+
+    struct Slot
+    {
+        Index item;
+        Index version;
+    };
+
+    DynamicArray<T> items_;
+    DynamicArray<Index> item_slots_;
+    DynamicArray<Slot> slots_;
+    DynamicArray<Index> free_indices_;
+};
+
+/// Variant of SlotMap which supports concurrent insertion, removal, and lookup. Slots are stored in
+/// chunks of geometrically increasing size which are never reallocated so references to items
+/// remain stable while other threads insert.
+///
+/// NOTE: Lookup is wait-free but does not extend the lifetime of the returned item. Callers are
+/// responsible for ensuring an item isn't accessed while it's being removed by another thread.
+///
+template <
+    typename T,
+    typename Index = u64,
+    int version_bits = (8 * sizeof(Index) / 2),
+    int min_chunk_bits = 6>
+struct ConcurrentSlotMap
+{
+    static constexpr int index_bits = (8 * sizeof(Index)) - version_bits;
+    static_assert(index_bits > 0 && version_bits > 0);
+    static_assert(is_natural<Index>);
+
+    struct Handle
+    {
+        Index index : index_bits;
+        Index version : version_bits;
+    };
+
+    ConcurrentSlotMap(Allocator const alloc = {}) : alloc_{alloc} {}
+
+    ConcurrentSlotMap(ConcurrentSlotMap const& other) = delete;
+    ConcurrentSlotMap& operator=(ConcurrentSlotMap const& other) = delete;
+
+    ~ConcurrentSlotMap()
+    {
+        for (int i = 0; i < max_chunks_; ++i)
+        {
+            Slot* const chunk = chunks_[i].load(std::memory_order_relaxed);
+            if (chunk == nullptr)
+                continue;
+
+            isize const n = chunk_size(i);
+            for (isize j = 0; j < n; ++j)
+            {
+                if (chunk[j].state.load(std::memory_order_relaxed) & live_bit_)
+                    chunk[j].item()->~T();
+            }
+
+            alloc_.deallocate_object(chunk, usize(n));
+        }
+    }
+
+    /// Returns the allocator used by this container
+    Allocator allocator() const { return alloc_; }
+
+    /// Inserts a new item into the map by constructing it in-place. Returns a valid handle to the
+    /// new item. Safe to call concurrently.
+    template <typename... Args>
+    Handle insert(Args&&... args)
+    {
+        Index index = pop_free();
+
+        if (index == invalid_index_)
+            index = Index(num_slots_.fetch_add(1, std::memory_order_relaxed));
+
+        Slot& slot = get_or_make_slot(index);
+        Index const version = slot.state.load(std::memory_order_relaxed) >> 1;
+        make_item(slot.item(), std::forward<Args>(args)...);
+
+        // Publish the item to readers
+        slot.state.store((version << 1) | live_bit_, std::memory_order_release);
+        num_items_.fetch_add(1, std::memory_order_relaxed);
+
+        return {index, version};
+    }
+
+    /// Removes the item at the given handle if it's valid. Returns true on success. Safe to call
+    /// concurrently.
+    bool remove(Handle const handle)
+    {
+        constexpr Index max_version = (Index{1} << version_bits) - Index{1};
+
+        Slot* const slot = find_slot(handle.index);
+        if (slot == nullptr)
+            return false;
+
+        // Claim the item by bumping the slot's version. Only one thread can succeed.
+        Index expected = (Index(handle.version) << 1) | live_bit_;
+        Index const version = Index(handle.version) + Index{1};
+        if (!slot->state.compare_exchange_strong(
+                expected,
+                version << 1,
+                std::memory_order_acq_rel,
+                std::memory_order_relaxed))
+            return false;
+
+        slot->item()->~T();
+        num_items_.fetch_sub(1, std::memory_order_relaxed);
+
+        // Reuse the slot if its version isn't maxed out
+        if (version < max_version)
+            push_free(handle.index, version);
+
+        return true;
+    }
+
+    /// Returns true if the handle refers to a valid item
+    bool is_valid(Handle const handle) const
+    {
+        Slot const* const slot = find_slot(handle.index);
+        return slot != nullptr
+            && slot->state.load(std::memory_order_acquire)
+            == ((Index(handle.version) << 1) | live_bit_);
+    }
+
+    /// Returns the item associated with the given handle or null if the handle isn't valid
+    T* operator[](Handle const handle)
+    {
+        Slot* const slot = find_slot(handle.index);
+        if (slot != nullptr
+            && slot->state.load(std::memory_order_acquire)
+                == ((Index(handle.version) << 1) | live_bit_))
+            return slot->item();
+
+        return nullptr;
+    }
+
+    /// Returns the item associated with the given handle or null if the handle isn't valid
+    T const* operator[](Handle const handle) const
+    {
+        return const_cast<ConcurrentSlotMap<T, Index, version_bits, min_chunk_bits>&>(
+            *this)[handle];
+    }
+
+    /// Returns the number of items in the map
+    isize num_items() const { return num_items_.load(std::memory_order_relaxed); }
+
+    /// Returns the number of slots in the map
+    isize num_slots() const { return num_slots_.load(std::memory_order_relaxed); }
+
+  private:
+    static constexpr Index live_bit_{1};
+    static constexpr Index invalid_index_{(Index{1} << index_bits) - Index{1}};
+    static constexpr int max_chunks_ = index_bits - min_chunk_bits + 1;
+    static_assert(max_chunks_ > 0);
+
+    struct Slot
+    {
+        // Packed as (version << 1) | live
+        std::atomic<Index> state{Index{1} << 1};
+
+        // Packed as (version << index_bits) | index
+        std::atomic<Index> next_free{invalid_index_};
+
+        alignas(T) unsigned char storage[sizeof(T)];
+
+        T* item() { return std::launder(reinterpret_cast<T*>(storage)); }
+    };
+
+    static constexpr isize chunk_size(int const chunk)
+    {
+        return isize{1} << (chunk + min_chunk_bits);
+    }
+
+    // Returns the chunk containing the given slot index along with the slot's offset within it.
+    // Chunk i holds 2^(i + min_chunk_bits) slots.
+    static int to_chunk(Index const index, isize& offset)
+    {
+        constexpr Index base{Index{1} << min_chunk_bits};
+        Index const shifted = index + base;
+        u8 const log2 = log2_floor(shifted);
+        offset = isize(shifted - (Index{1} << log2));
+        return log2 - min_chunk_bits;
+    }
+
+    static Index pack(Index const index, Index const version)
+    {
+        return (version << index_bits) | index;
+    }
+
+    static Index unpack_index(Index const packed) { return packed & invalid_index_; }
+
+    template <typename... Args>
+    void make_item(T* const ptr, Args&&... args)
+    {
+        // If T is allocator-aware, share this container's allocator
+        if constexpr (is_allocator_aware<T>)
+            new (ptr) T(std::forward<Args>(args)..., alloc_);
+        else
+            new (ptr) T(std::forward<Args>(args)...);
+    }
+
+    Slot* find_slot(Index const index) const
+    {
+        if (index >= invalid_index_)
+            return nullptr;
+
+        isize offset;
+        int const chunk = to_chunk(index, offset);
+        Slot* const slots = chunks_[chunk].load(std::memory_order_acquire);
+
+        return (slots != nullptr) ? slots + offset : nullptr;
+    }
+
+    Slot& get_or_make_slot(Index const index)
+    {
+        assert(index < invalid_index_);
+
+        isize offset;
+        int const chunk = to_chunk(index, offset);
+        Slot* slots = chunks_[chunk].load(std::memory_order_acquire);
+
+        if (slots == nullptr)
+        {
+            // Allocate the chunk. If another thread beats us to it, use theirs instead.
+            isize const n = chunk_size(chunk);
+            Slot* const new_slots = alloc_.allocate_object<Slot>(usize(n));
+            for (isize i = 0; i < n; ++i)
+                new (new_slots + i) Slot{};
+
+            if (chunks_[chunk].compare_exchange_strong(
+                    slots,
+                    new_slots,
+                    std::memory_order_acq_rel,
+                    std::memory_order_acquire))
+                slots = new_slots;
+            else
+                alloc_.deallocate_object(new_slots, usize(n));
+        }
+
+        return slots[offset];
+    }
+
+    void push_free(Index const index, Index const version)
+    {
+        Slot& slot = *find_slot(index);
+        Index const new_head = pack(index, version);
+        Index head = free_head_.load(std::memory_order_relaxed);
+
+        do
+        {
+            slot.next_free.store(head, std::memory_order_relaxed);
+        } while (!free_head_.compare_exchange_weak(
+            head,
+            new_head,
+            std::memory_order_release,
+            std::memory_order_relaxed));
+    }
+
+    Index pop_free()
+    {
+        Index head = free_head_.load(std::memory_order_acquire);
+
+        while (unpack_index(head) != invalid_index_)
+        {
+            // NOTE: Slots are re-pushed with an incremented version so a stale head will fail the
+            // exchange below (ABA protection)
+            Slot const& slot = *find_slot(unpack_index(head));
+            Index const next = slot.next_free.load(std::memory_order_relaxed);
+
+            if (free_head_.compare_exchange_weak(
+                    head,
+                    next,
+                    std::memory_order_acquire,
+                    std::memory_order_acquire))
+                return unpack_index(head);
+        }
+
+        return invalid_index_;
+    }
+
+    Allocator alloc_;
+    std::atomic<Slot*> chunks_[max_chunks_]{};
+    std::atomic<Index> free_head_{invalid_index_};
+    std::atomic<isize> num_slots_{};
+    std::atomic<isize> num_items_{};
+};
+
 }; // namespace dr
\ No newline at end of file
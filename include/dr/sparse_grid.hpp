@@ -0,0 +1,447 @@
+#pragma once
+
+#include <cassert>
+#include <cmath>
+#include <utility>
+
+#include <dr/basic_traits.hpp>
+#include <dr/bitwise.hpp>
+#include <dr/container_utils.hpp>
+#include <dr/dynamic_array.hpp>
+#include <dr/executor.hpp>
+#include <dr/grid.hpp>
+#include <dr/grid_field.hpp>
+#include <dr/hash_grid.hpp>
+#include <dr/hash_map.hpp>
+#include <dr/math_types.hpp>
+#include <dr/memory.hpp>
+#include <dr/span.hpp>
+#include <dr/spline.hpp>
+
+namespace dr
+{
+
+/// Sparse 3D array of values over an unbounded integer grid. Space is divided into leaves of
+/// grid_brick_width points along each axis which are only allocated once one of their values is
+/// activated. Leaves are found via a hash map keyed on leaf coordinates and values within each
+/// leaf are stored in Morton order (see bricked_grid_to_index). Values which aren't active take
+/// on the background value. Memory scales with the number of allocated leaves so a narrow band
+/// around a surface costs memory proportional to its area rather than the enclosed volume.
+template <typename T>
+struct SparseGrid : AllocatorAware
+{
+    using Index = i32;
+
+    /// Number of words in the active mask of each leaf
+    static constexpr isize mask_size = grid_brick_size / 64;
+
+    SparseGrid(Allocator const alloc = {}) :
+        leaf_map_(alloc),
+        leaf_keys_(alloc),
+        values_(alloc),
+        masks_(alloc)
+    {
+    }
+
+    SparseGrid(T const& background, Allocator const alloc = {}) :
+        leaf_map_(alloc),
+        leaf_keys_(alloc),
+        values_(alloc),
+        masks_(alloc),
+        background_(background)
+    {
+    }
+
+    SparseGrid(SparseGrid const& other, Allocator const alloc = {}) :
+        leaf_map_(other.leaf_map_, alloc),
+        leaf_keys_(other.leaf_keys_, alloc),
+        values_(other.values_, alloc),
+        masks_(other.masks_, alloc),
+        background_(other.background_)
+    {
+    }
+
+    SparseGrid(SparseGrid&& other) noexcept = default;
+    SparseGrid& operator=(SparseGrid const& other) = default;
+    SparseGrid& operator=(SparseGrid&& other) = default;
+
+    /// Returns the allocator used by this container
+    Allocator allocator() const { return values_.get_allocator(); }
+
+    /// Returns the value of grid points which aren't active
+    T const& background() const { return background_; }
+
+    /// Returns the number of allocated leaves
+    isize num_leaves() const { return size(leaf_keys_); }
+
+    /// Returns the number of active grid points
+    isize num_active() const
+    {
+        isize result = 0;
+
+        for (u64 const m : masks_)
+            result += bit_sum(m);
+
+        return result;
+    }
+
+    /// Removes all values from the grid
+    void clear()
+    {
+        leaf_map_.clear();
+        leaf_keys_.clear();
+        values_.clear();
+        masks_.clear();
+    }
+
+    /// Returns the value at the given grid point
+    T const& operator[](Vec3<isize> const& grid_pt) const
+    {
+        isize const leaf = find_leaf(grid_pt);
+        return (leaf < 0) ? background_ : values_[leaf * grid_brick_size + to_leaf_offset(grid_pt)];
+    }
+
+    /// Returns a pointer to the value at the given grid point or nullptr if it isn't active
+    T* find(Vec3<isize> const& grid_pt)
+    {
+        isize const leaf = find_leaf(grid_pt);
+        if (leaf < 0)
+            return nullptr;
+
+        isize const offset = to_leaf_offset(grid_pt);
+        return is_active(leaf, offset) ? &values_[leaf * grid_brick_size + offset] : nullptr;
+    }
+
+    /// Returns a pointer to the value at the given grid point or nullptr if it isn't active
+    T const* find(Vec3<isize> const& grid_pt) const
+    {
+        return const_cast<SparseGrid<T>&>(*this).find(grid_pt);
+    }
+
+    /// Returns true if the given grid point is active
+    bool is_active(Vec3<isize> const& grid_pt) const
+    {
+        isize const leaf = find_leaf(grid_pt);
+        return (leaf >= 0) && is_active(leaf, to_leaf_offset(grid_pt));
+    }
+
+    /// Marks the given grid point as active and returns a reference to its value. Allocates the
+    /// containing leaf if necessary.
+    T& activate(Vec3<isize> const& grid_pt)
+    {
+        isize const leaf = get_or_insert_leaf(to_leaf_key(grid_pt));
+        isize const offset = to_leaf_offset(grid_pt);
+        masks_[leaf * mask_size + (offset >> 6)] |= u64{1} << (offset & 63);
+        return values_[leaf * grid_brick_size + offset];
+    }
+
+    /// Sets the value at the given grid point and marks it as active
+    void set(Vec3<isize> const& grid_pt, T const& value) { activate(grid_pt) = value; }
+
+    /// Marks the given grid point as inactive and resets its value to the background value.
+    /// Leaves are kept allocated until the next call to prune.
+    void deactivate(Vec3<isize> const& grid_pt)
+    {
+        isize const leaf = find_leaf(grid_pt);
+        if (leaf < 0)
+            return;
+
+        isize const offset = to_leaf_offset(grid_pt);
+        masks_[leaf * mask_size + (offset >> 6)] &= ~(u64{1} << (offset & 63));
+        values_[leaf * grid_brick_size + offset] = background_;
+    }
+
+    /// Frees leaves which don't contain any active grid points. Leaf indices are invalidated.
+    void prune()
+    {
+        for (isize i = num_leaves() - 1; i >= 0; --i)
+        {
+            if (!is_empty(i))
+                continue;
+
+            // Move the last leaf into the removed one
+            isize const last = num_leaves() - 1;
+            leaf_map_.erase(leaf_keys_[i]);
+
+            if (i != last)
+            {
+                leaf_keys_[i] = leaf_keys_[last];
+                leaf_map_[leaf_keys_[i]] = Index(i);
+
+                T* const dst = &values_[i * grid_brick_size];
+                T* const src = &values_[last * grid_brick_size];
+
+                for (isize j = 0; j < grid_brick_size; ++j)
+                    dst[j] = std::move(src[j]);
+
+                for (isize j = 0; j < mask_size; ++j)
+                    masks_[i * mask_size + j] = masks_[last * mask_size + j];
+            }
+
+            leaf_keys_.pop_back();
+            values_.resize(last * grid_brick_size);
+            masks_.resize(last * mask_size);
+        }
+    }
+
+    /// Returns the index of the leaf containing the given grid point or -1 if it isn't allocated
+    isize find_leaf(Vec3<isize> const& grid_pt) const
+    {
+        auto const it = leaf_map_.find(to_leaf_key(grid_pt));
+        return (it != leaf_map_.end()) ? it->second : -1;
+    }
+
+    /// Returns the first grid point in the given leaf
+    Vec3<isize> leaf_origin(isize const leaf) const
+    {
+        return leaf_keys_[leaf].template cast<isize>() * grid_brick_width;
+    }
+
+    /// Returns the values of the given leaf in Morton order
+    Span<T> leaf_values(isize const leaf)
+    {
+        assert(leaf >= 0 && leaf < num_leaves());
+        return as_span(values_).segment(leaf * grid_brick_size, grid_brick_size);
+    }
+
+    /// Returns the values of the given leaf in Morton order
+    Span<T const> leaf_values(isize const leaf) const
+    {
+        return const_cast<SparseGrid<T>&>(*this).leaf_values(leaf);
+    }
+
+    /// Returns the active mask of the given leaf. Bit i is set if value i is active.
+    Span<u64 const> leaf_mask(isize const leaf) const
+    {
+        assert(leaf >= 0 && leaf < num_leaves());
+        return as_span(masks_).segment(leaf * mask_size, mask_size);
+    }
+
+    /// Calls the given function with the index of each allocated leaf. Leaves may be processed in
+    /// parallel depending on the given executor in which case the function must not allocate or
+    /// free leaves.
+    template <typename Fn>
+    void for_each_leaf(Fn&& fn, Executor const exec = {}) const
+    {
+        exec.parallel_for(num_leaves(), fn);
+    }
+
+    /// Calls the given function with the grid point and value of each active grid point
+    template <typename Fn>
+    void for_each_active(Fn&& fn, Executor const exec = {})
+    {
+        for_each_active_impl(*this, fn, exec);
+    }
+
+    /// Calls the given function with the grid point and value of each active grid point
+    template <typename Fn>
+    void for_each_active(Fn&& fn, Executor const exec = {}) const
+    {
+        for_each_active_impl(*this, fn, exec);
+    }
+
+    /// Evaluates the grid at the given point in grid coordinates (see Grid::to_grid). Inactive
+    /// grid points contribute the background value.
+    T sample(Vec3<T> const& grid_pt, GridFilter const filter) const
+    {
+        return sample_impl<false>(grid_pt, filter, nullptr);
+    }
+
+    /// Evaluates the grid and its gradient at the given point in grid coordinates (see
+    /// Grid::to_grid). The gradient is also given in grid coordinates.
+    T sample(Vec3<T> const& grid_pt, GridFilter const filter, Vec3<T>& gradient) const
+    {
+        return sample_impl<true>(grid_pt, filter, &gradient);
+    }
+
+  private:
+    HashMap<Vec3<Index>, Index, GridCellHash> leaf_map_;
+    DynamicArray<Vec3<Index>> leaf_keys_;
+    DynamicArray<T> values_;
+    DynamicArray<u64> masks_;
+    T background_{};
+
+    static constexpr int leaf_shift = 3;
+    static_assert((isize{1} << leaf_shift) == grid_brick_width);
+
+    static Vec3<Index> to_leaf_key(Vec3<isize> const& grid_pt)
+    {
+        // NOTE: Arithmetic shift rounds towards negative infinity
+        return {
+            Index(grid_pt[0] >> leaf_shift),
+            Index(grid_pt[1] >> leaf_shift),
+            Index(grid_pt[2] >> leaf_shift),
+        };
+    }
+
+    static isize to_leaf_offset(Vec3<isize> const& grid_pt)
+    {
+        constexpr isize m = grid_brick_width - 1;
+        return isize(morton_encode(u32(grid_pt[0] & m), u32(grid_pt[1] & m), u32(grid_pt[2] & m)));
+    }
+
+    bool is_active(isize const leaf, isize const offset) const
+    {
+        return (masks_[leaf * mask_size + (offset >> 6)] >> (offset & 63)) & 1;
+    }
+
+    bool is_empty(isize const leaf) const
+    {
+        for (isize i = 0; i < mask_size; ++i)
+        {
+            if (masks_[leaf * mask_size + i] != 0)
+                return false;
+        }
+
+        return true;
+    }
+
+    isize get_or_insert_leaf(Vec3<Index> const& key)
+    {
+        auto const [it, inserted] = leaf_map_.try_emplace(key, Index(num_leaves()));
+
+        if (inserted)
+        {
+            leaf_keys_.push_back(key);
+            values_.resize(size(values_) + grid_brick_size, background_);
+            masks_.resize(size(masks_) + mask_size, 0);
+        }
+
+        return it->second;
+    }
+
+    template <typename Self, typename Fn>
+    static void for_each_active_impl(Self& self, Fn& fn, Executor const exec)
+    {
+        self.for_each_leaf(
+            [&](isize const leaf) {
+                Vec3<isize> const origin = self.leaf_origin(leaf);
+                auto const values = self.leaf_values(leaf);
+                auto const mask = self.leaf_mask(leaf);
+
+                for (isize i = 0; i < mask_size; ++i)
+                {
+                    for (u64 bits = mask[i]; bits != 0; bits &= bits - 1)
+                    {
+                        isize const offset = i * 64 + trailing_zeros(bits);
+
+                        u32 local[3];
+                        morton_decode(u64(offset), local);
+
+                        Vec3<isize> const grid_pt{
+                            origin[0] + local[0],
+                            origin[1] + local[1],
+                            origin[2] + local[2]};
+
+                        fn(grid_pt, values[offset]);
+                    }
+                }
+            },
+            exec);
+    }
+
+    template <bool with_gradient>
+    T sample_impl(Vec3<T> const& grid_pt, GridFilter const filter, Vec3<T>* const gradient) const
+    {
+        switch (filter)
+        {
+            case GridFilter_Linear:
+            {
+                return sample_impl<LinearBasis, with_gradient>(grid_pt, gradient);
+            }
+            case GridFilter_Cubic:
+            {
+                return sample_impl<CatmullRomBasis, with_gradient>(grid_pt, gradient);
+            }
+            default:
+            {
+                assert(false);
+                return background_;
+            }
+        }
+    }
+
+    template <typename Basis, bool with_gradient>
+    T sample_impl(Vec3<T> const& grid_pt, Vec3<T>* const gradient) const
+    {
+        static_assert(is_real<T>);
+
+        using Diff = typename Basis::template Diff<1>;
+        constexpr isize n = Basis::size;
+        constexpr isize offset = (n - 2) / 2;
+
+        Vec3<isize> cell;
+        T b[3][n];
+        T db[3][n];
+
+        for (int i = 0; i < 3; ++i)
+        {
+            T const x = std::floor(grid_pt[i]);
+            cell[i] = isize(x) - offset;
+            Basis::eval(grid_pt[i] - x, b[i]);
+
+            if constexpr (with_gradient)
+                Diff::eval(grid_pt[i] - x, db[i]);
+        }
+
+        // Gather values, caching the most recently found leaf since neighboring grid points
+        // usually share one
+        T coeffs[n][n][n];
+        {
+            Vec3<Index> cached_key = to_leaf_key(cell);
+            isize cached_leaf = find_leaf(cell);
+
+            for (isize w = 0; w < n; ++w)
+            {
+                for (isize v = 0; v < n; ++v)
+                {
+                    for (isize u = 0; u < n; ++u)
+                    {
+                        Vec3<isize> const p = cell + Vec3<isize>{u, v, w};
+                        Vec3<Index> const key = to_leaf_key(p);
+
+                        if (key != cached_key)
+                        {
+                            auto const it = leaf_map_.find(key);
+                            cached_leaf = (it != leaf_map_.end()) ? it->second : -1;
+                            cached_key = key;
+                        }
+
+                        coeffs[w][v][u] = (cached_leaf < 0)
+                            ? background_
+                            : values_[cached_leaf * grid_brick_size + to_leaf_offset(p)];
+                    }
+                }
+            }
+        }
+
+        T result{0.0};
+        Vec3<T> grad = Vec3<T>::Zero();
+
+        for (isize w = 0; w < n; ++w)
+        {
+            for (isize v = 0; v < n; ++v)
+            {
+                for (isize u = 0; u < n; ++u)
+                {
+                    T const c = coeffs[w][v][u];
+                    result += c * b[0][u] * b[1][v] * b[2][w];
+
+                    if constexpr (with_gradient)
+                    {
+                        grad[0] += c * db[0][u] * b[1][v] * b[2][w];
+                        grad[1] += c * b[0][u] * db[1][v] * b[2][w];
+                        grad[2] += c * b[0][u] * b[1][v] * db[2][w];
+                    }
+                }
+            }
+        }
+
+        if constexpr (with_gradient)
+            *gradient = grad;
+
+        return result;
+    }
+};
+
+} // namespace dr
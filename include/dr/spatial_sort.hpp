@@ -0,0 +1,212 @@
+#pragma once
+
+/*
+    Spatial reordering of points and mesh elements along space-filling curves
+*/
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include <dr/algorithms.hpp>
+#include <dr/basic_traits.hpp>
+#include <dr/bitwise.hpp>
+#include <dr/container_utils.hpp>
+#include <dr/dynamic_array.hpp>
+#include <dr/executor.hpp>
+#include <dr/geometry.hpp>
+#include <dr/geometry_types.hpp>
+#include <dr/math_types.hpp>
+#include <dr/memory.hpp>
+#include <dr/span.hpp>
+
+namespace dr
+{
+
+enum SpatialCurve : u8
+{
+    SpatialCurve_Morton = 0,
+    SpatialCurve_Hilbert,
+    _SpatialCurve_Count
+};
+
+/// Returns the Morton code of the given 2D grid coordinates
+inline u64 morton_encode(Vec2<u32> const& p) { return morton_encode(p[0], p[1]); }
+
+/// Returns the Morton code of the given 3D grid coordinates. Only the lower 21 bits of each
+/// coordinate are used.
+inline u64 morton_encode(Vec3<u32> const& p) { return morton_encode(p[0], p[1], p[2]); }
+
+/// Returns the index of the given 2D grid coordinates along a Hilbert curve
+inline u64 hilbert_encode(Vec2<u32> const& p) { return hilbert_encode(p[0], p[1]); }
+
+/// Returns the index of the given 3D grid coordinates along a Hilbert curve. Only the lower 21
+/// bits of each coordinate are used.
+inline u64 hilbert_encode(Vec3<u32> const& p) { return hilbert_encode(p[0], p[1], p[2]); }
+
+/// Quantizes each point relative to the given bounds and returns its index along the given curve.
+/// Points are quantized to 32 bits per coordinate in 2D and 21 bits per coordinate in 3D.
+template <typename Real, int dim>
+void spatial_codes(
+    Span<Vec<Real, dim> const> const& points,
+    Interval<Real, dim> const& bounds,
+    SpatialCurve const curve,
+    Span<u64> const& result,
+    Executor const exec = {})
+{
+    static_assert(is_real<Real>);
+    static_assert(dim == 2 || dim == 3);
+    assert(result.size() == points.size());
+
+    using Coords = Vec<u32, dim>;
+
+    // NOTE: Quantization is done in double precision since single precision can't represent the
+    // largest 32 bit coordinate
+    constexpr f64 max_coord = (dim == 2) ? f64(~u32{0}) : f64(0x1fffff);
+
+    Vec<f64, dim> const from = bounds.min().template cast<f64>();
+    Vec<f64, dim> const delta = bounds.max().template cast<f64>() - from;
+
+    Vec<f64, dim> scale;
+    for (int i = 0; i < dim; ++i)
+        scale[i] = (delta[i] > 0.0) ? max_coord / delta[i] : 0.0;
+
+    auto const quantize = [&](Vec<Real, dim> const& p) -> Coords {
+        Coords result;
+
+        for (int i = 0; i < dim; ++i)
+        {
+            f64 const t = std::floor((f64(p[i]) - from[i]) * scale[i]);
+            result[i] = u32(std::clamp(t, 0.0, max_coord));
+        }
+
+        return result;
+    };
+
+    switch (curve)
+    {
+        case SpatialCurve_Morton:
+        {
+            exec.parallel_for(points.size(), [&](isize const i) {
+                result[i] = morton_encode(quantize(points[i]));
+            });
+            break;
+        }
+        case SpatialCurve_Hilbert:
+        {
+            exec.parallel_for(points.size(), [&](isize const i) {
+                result[i] = hilbert_encode(quantize(points[i]));
+            });
+            break;
+        }
+        default:
+        {
+            assert(false);
+        }
+    }
+}
+
+/// Returns the permutation which sorts the given points along the given curve
+template <typename Real, int dim, typename Index>
+void spatial_sort_permutation(
+    Span<Vec<Real, dim> const> const& points,
+    SpatialCurve const curve,
+    Span<Index> const& result,
+    Executor const exec = {},
+    Allocator const alloc = {})
+{
+    if (points.size() == 0)
+        return;
+
+    DynamicArray<u64> codes(points.size(), alloc);
+    spatial_codes(points, bounding_interval(points), curve, as_span(codes), exec);
+    radix_sort_permutation(as_span(codes).as_const(), result, exec, alloc);
+}
+
+/// Returns the permutation which sorts the given elements by the position of their centroid along
+/// the given curve
+template <typename Real, int dim, typename Index, int size>
+void spatial_sort_permutation(
+    Span<Vec<Real, dim> const> const& vertex_positions,
+    Span<Vec<Index, size> const> const& element_vertices,
+    SpatialCurve const curve,
+    Span<Index> const& result,
+    Executor const exec = {},
+    Allocator const alloc = {})
+{
+    static_assert(is_integer<Index> || is_natural<Index>);
+    isize const n = element_vertices.size();
+
+    DynamicArray<Vec<Real, dim>> centroids(n, alloc);
+    exec.parallel_for(n, [&](isize const i) {
+        Vec<Index, size> const& e_v = element_vertices[i];
+        Vec<Real, dim> sum = vertex_positions[e_v[0]];
+
+        for (int j = 1; j < size; ++j)
+            sum += vertex_positions[e_v[j]];
+
+        centroids[i] = sum / Real(size);
+    });
+
+    spatial_sort_permutation(as_span(centroids).as_const(), curve, result, exec, alloc);
+}
+
+/// Returns the inverse of the given permutation
+template <typename Index>
+void invert_permutation(
+    Span<Index const> const& permutation,
+    Span<Index> const& result,
+    Executor const exec = {})
+{
+    static_assert(is_integer<Index> || is_natural<Index>);
+    assert(result.size() == permutation.size());
+
+    exec.parallel_for(permutation.size(), [&](isize const i) {
+        result[permutation[i]] = Index(i);
+    });
+}
+
+/// Reorders values by the given permutation (i.e. result[i] = values[permutation[i]])
+template <typename T, typename Index>
+void apply_permutation(
+    Span<T const> const& values,
+    Span<Index const> const& permutation,
+    Span<T> const& result,
+    Executor const exec = {})
+{
+    static_assert(is_integer<Index> || is_natural<Index>);
+    assert(result.size() == permutation.size());
+    assert(values.size() == 0 || result.data() != values.data());
+
+    exec.parallel_for(permutation.size(), [&](isize const i) {
+        result[i] = values[permutation[i]];
+    });
+}
+
+/// Reorders vertex positions by the given permutation and updates the vertices of the given
+/// elements to match in a single pass over each
+template <typename Real, int dim, typename Index, int size>
+void apply_vertex_permutation(
+    Span<Vec<Real, dim> const> const& vertex_positions,
+    Span<Index const> const& permutation,
+    Span<Vec<Real, dim>> const& result_positions,
+    Span<Vec<Index, size>> const& element_vertices,
+    Executor const exec = {},
+    Allocator const alloc = {})
+{
+    static_assert(is_integer<Index> || is_natural<Index>);
+    assert(vertex_positions.size() == permutation.size());
+
+    DynamicArray<Index> old_to_new(permutation.size(), alloc);
+    invert_permutation(permutation, as_span(old_to_new), exec);
+    apply_permutation(vertex_positions, permutation, result_positions, exec);
+
+    exec.parallel_for(element_vertices.size(), [&](isize const i) {
+        Vec<Index, size>& e_v = element_vertices[i];
+
+        for (int j = 0; j < size; ++j)
+            e_v[j] = old_to_new[e_v[j]];
+    });
+}
+
+} // namespace dr
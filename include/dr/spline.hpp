@@ -207,6 +207,97 @@ constexpr void spline_eval(
     }
 }
 
+/// Row of Pascal's triangle (i.e. the binomial coefficients of n)
+template <isize n>
+struct BinomialRow
+{
+    isize values[n + 1];
+};
+
+template <isize n>
+constexpr BinomialRow<n> make_binomial_row()
+{
+    BinomialRow<n> result{};
+    result.values[0] = 1;
+
+    for (isize k = 1; k <= n; ++k)
+        result.values[k] = result.values[k - 1] * (n - k + 1) / k;
+
+    return result;
+}
+
+template <isize n>
+inline constexpr BinomialRow<n> binomial_row = make_binomial_row<n>();
+
+/// Evaluates Bernstein basis functions of the given degree
+template <isize degree, typename Real>
+constexpr void bernstein_eval(Real const t, Real result[degree + 1])
+{
+    static_assert(is_real<Real>);
+
+    // b_i(t) = C(n, i) t^i (1 - t)^(n - i)
+    result[0] = Real{1.0};
+    for (isize i = 1; i <= degree; ++i)
+        result[i] = result[i - 1] * t;
+
+    Real const s = Real{1.0} - t;
+    Real s_pow{1.0};
+
+    for (isize i = degree; i >= 0; --i)
+    {
+        result[i] *= Real(binomial_row<degree>.values[i]) * s_pow;
+        s_pow *= s;
+    }
+}
+
+/// Evaluates derivatives of Bernstein basis functions of the given degree
+template <isize degree, isize order, typename Real>
+constexpr void bernstein_diff(Real const t, Real result[degree + 1])
+{
+    static_assert(is_real<Real>);
+    static_assert(order > 0);
+
+    if constexpr (order > degree)
+    {
+        for (isize i = 0; i <= degree; ++i)
+            result[i] = Real{0.0};
+    }
+    else
+    {
+        /*
+            Derivatives are expressed in terms of lower degree basis functions
+
+            d^k/dt^k b_i,n = n! / (n - k)! sum_j (-1)^(k - j) C(k, j) b_(i - j),(n - k)
+        */
+
+        constexpr isize sub_degree = degree - order;
+
+        Real b[sub_degree + 1]{};
+        bernstein_eval<sub_degree>(t, b);
+
+        Real scale{1.0};
+        for (isize i = sub_degree + 1; i <= degree; ++i)
+            scale *= Real(i);
+
+        for (isize i = 0; i <= degree; ++i)
+        {
+            Real sum{0.0};
+
+            for (isize j = 0; j <= order; ++j)
+            {
+                isize const k = i - j;
+                if (k < 0 || k > sub_degree)
+                    continue;
+
+                Real const c = Real(binomial_row<order>.values[j]);
+                sum += ((order - j) & 1) ? -c * b[k] : c * b[k];
+            }
+
+            result[i] = scale * sum;
+        }
+    }
+}
+
 } // namespace impl
 
 template <isize degree_, isize size_>
@@ -318,8 +409,31 @@ struct CatmullRomBasis : SplineBasis<3, 4>
     };
 };
 
-template <isize degree>
-struct BernsteinBasis;
+/// Bernstein basis of arbitrary degree. Weights are derived from constexpr binomial tables and
+/// evaluated with fixed trip count loops which the compiler fully unrolls.
+template <isize degree_>
+struct BernsteinBasis : SplineBasis<degree_, degree_ + 1>
+{
+    static_assert(degree_ >= 0);
+
+    template <typename Real>
+    static constexpr void eval(Real const t, Real result[degree_ + 1])
+    {
+        impl::bernstein_eval<degree_>(t, result);
+    }
+
+    template <isize order>
+    struct Diff : SplineBasis<degree_ - order, degree_ + 1>
+    {
+        static_assert(order > 0);
+
+        template <typename Real>
+        static constexpr void eval(Real const t, Real result[degree_ + 1])
+        {
+            impl::bernstein_diff<degree_, order>(t, result);
+        }
+    };
+};
 
 template <>
 struct BernsteinBasis<2> : SplineBasis<2, 3>
@@ -386,10 +500,10 @@ struct BernsteinBasis<3> : SplineBasis<3, 4>
         /*
             Evaluated as product with basis matrix
 
-            | f0  f1  f2  f3 | = 0.5 * | ttt  tt  t  1 | * |-1  3 -3  1 |
-                                                           | 3 -6  3  0 |
-                                                           |-3  3  0  0 |
-                                                           | 1  0  0  0 |
+            | f0  f1  f2  f3 | = | ttt  tt  t  1 | * |-1  3 -3  1 |
+                                                     | 3 -6  3  0 |
+                                                     |-3  3  0  0 |
+                                                     | 1  0  0  0 |
         */
 
         Real const tt = t * t;
@@ -420,14 +534,14 @@ struct BernsteinBasis<3> : SplineBasis<3, 4>
             }
             else if constexpr (order == 2)
             {
-                result[0] = Real{6.0} - Real{2.0} * t;
+                result[0] = Real{6.0} - Real{6.0} * t;
                 result[1] = Real{18.0} * t - Real{12.0};
                 result[2] = Real{6.0} - Real{18.0} * t;
                 result[3] = Real{6.0} * t;
             }
             else if constexpr (order == 3)
             {
-                result[0] = Real{-2.0};
+                result[0] = Real{-6.0};
                 result[1] = Real{18.0};
                 result[2] = Real{-18.0};
                 result[3] = Real{6.0};
@@ -681,7 +795,7 @@ constexpr void eval_bezier_triquadratic(
     Value diff[3])
 {
     using B = BernsteinBasis<2>;
-    impl::spline_eval<B, B>(x, u, v, w, val, diff);
+    impl::spline_eval<B, B, B>(x, u, v, w, val, diff);
 }
 
 template <typename Value, typename Real>
@@ -779,7 +893,7 @@ constexpr void eval_bezier_tricubic(
     Value diff[3])
 {
     using B = BernsteinBasis<3>;
-    impl::spline_eval<B, B>(x, u, v, w, val, diff);
+    impl::spline_eval<B, B, B>(x, u, v, w, val, diff);
 }
 
 template <typename Value, typename Real>
@@ -0,0 +1,433 @@
+#pragma once
+
+/*
+    Evaluation of splines at many parameters at once
+*/
+
+#include <cassert>
+
+#include <dr/basic_traits.hpp>
+#include <dr/container_utils.hpp>
+#include <dr/dynamic_array.hpp>
+#include <dr/executor.hpp>
+#include <dr/linalg_reshape.hpp>
+#include <dr/linalg_types.hpp>
+#include <dr/memory.hpp>
+#include <dr/span.hpp>
+#include <dr/spline.hpp>
+
+namespace dr
+{
+namespace impl
+{
+
+template <typename Value>
+struct SplineValue
+{
+    static_assert(is_real<Value>);
+    using Scalar = Value;
+    static constexpr int dim = 1;
+};
+
+template <typename Scalar_, int dim_>
+struct SplineValue<Vec<Scalar_, dim_>>
+{
+    static_assert(is_real<Scalar_>);
+    using Scalar = Scalar_;
+    static constexpr int dim = dim_;
+};
+
+/// Returns a view of the scalar components of the given values
+template <typename Value>
+auto spline_scalars(Span<Value> const& values)
+{
+    using Scalar = typename SplineValue<std::remove_const_t<Value>>::Scalar;
+    using Result = std::conditional_t<std::is_const_v<Value>, Scalar const, Scalar>;
+    constexpr int dim = SplineValue<std::remove_const_t<Value>>::dim;
+
+    return Span<Result>{reinterpret_cast<Result*>(values.data()), values.size() * dim};
+}
+
+} // namespace impl
+
+/// Basis functions and their derivatives up to a given order evaluated at a set of parameters.
+/// Tables are evaluated once per unique parameter and can be reused across calls to
+/// eval_spline_batch.
+template <typename Basis, typename Real, isize max_order = 0>
+struct SplineBasisTable : AllocatorAware
+{
+    static_assert(is_real<Real>);
+    static_assert(max_order >= 0);
+
+    /// Number of basis functions
+    static constexpr isize basis_size = Basis::size;
+
+    /// Number of derivative orders evaluated (including order 0)
+    static constexpr isize num_orders = max_order + 1;
+
+    SplineBasisTable(Allocator const alloc = {}) : values_(alloc) {}
+
+    SplineBasisTable(Span<Real const> const& params, Allocator const alloc = {}) : values_(alloc)
+    {
+        assign(params);
+    }
+
+    SplineBasisTable(SplineBasisTable const& other, Allocator const alloc = {}) :
+        values_(other.values_, alloc),
+        num_params_(other.num_params_)
+    {
+    }
+
+    SplineBasisTable(SplineBasisTable&& other) noexcept = default;
+    SplineBasisTable& operator=(SplineBasisTable const& other) = default;
+    SplineBasisTable& operator=(SplineBasisTable&& other) = default;
+
+    /// Returns the allocator used by this container
+    Allocator allocator() const { return values_.get_allocator(); }
+
+    /// Returns the number of parameters in the table
+    isize num_params() const { return num_params_; }
+
+    /// Evaluates basis functions and their derivatives at the given parameters
+    void assign(Span<Real const> const& params)
+    {
+        num_params_ = params.size();
+        values_.resize(num_params_ * basis_size * num_orders);
+        assign_order<0>(params);
+    }
+
+    /// Returns the basis functions of the given derivative order at each parameter. Values for
+    /// each parameter are contiguous.
+    Span<Real const> values(isize const order) const
+    {
+        assert(order >= 0 && order <= max_order);
+        isize const n = num_params_ * basis_size;
+        return as_span(values_).segment(order * n, n);
+    }
+
+    /// Returns the basis functions of all derivative orders at each parameter. Values for each
+    /// order are contiguous and ordered as above.
+    Span<Real const> all_values() const { return as_span(values_); }
+
+  private:
+    DynamicArray<Real> values_;
+    isize num_params_{};
+
+    template <isize order>
+    void assign_order(Span<Real const> const& params)
+    {
+        Real* const dst = values_.data() + order * num_params_ * basis_size;
+
+        for (isize i = 0; i < num_params_; ++i)
+        {
+            if constexpr (order == 0)
+                Basis::eval(params[i], dst + i * basis_size);
+            else
+                Basis::template Diff<order>::eval(params[i], dst + i * basis_size);
+        }
+
+        if constexpr (order < max_order)
+            assign_order<order + 1>(params);
+    }
+};
+
+/// Evaluates a spline curve (or one of its derivatives) at each parameter in the given table. The
+/// curve is evaluated as the product of its coefficients and the basis table.
+template <typename Basis, typename Real, isize max_order, typename Value>
+void eval_spline_batch(
+    Span<Value const> const& coeffs,
+    SplineBasisTable<Basis, Real, max_order> const& table,
+    isize const order,
+    Span<Value> const& result)
+{
+    using Traits = impl::SplineValue<Value>;
+    static_assert(std::is_same_v<typename Traits::Scalar, Real>);
+
+    constexpr int dim = Traits::dim;
+    constexpr isize n = Basis::size;
+
+    assert(coeffs.size() == n);
+    assert(result.size() == table.num_params());
+
+    auto const x = as_mat(impl::spline_scalars(coeffs), dim);
+    auto const b = as_mat(table.values(order), n);
+    as_mat(impl::spline_scalars(result), dim).noalias() = x * b;
+}
+
+/// Evaluates a spline curve and all of its derivatives up to the maximum order of the given table
+/// in one pass over the coefficients. The coefficients are multiplied with the basis tables of all
+/// orders stacked as a single matrix. The derivative of order a at parameter i is written to
+/// index a * m + i where m is the number of parameters.
+template <typename Basis, typename Real, isize max_order, typename Value>
+void eval_spline_batch(
+    Span<Value const> const& coeffs,
+    SplineBasisTable<Basis, Real, max_order> const& table,
+    Span<Value> const& result)
+{
+    using Traits = impl::SplineValue<Value>;
+    static_assert(std::is_same_v<typename Traits::Scalar, Real>);
+
+    constexpr int dim = Traits::dim;
+    constexpr isize n = Basis::size;
+
+    assert(coeffs.size() == n);
+    assert(result.size() == table.num_orders * table.num_params());
+
+    auto const x = as_mat(impl::spline_scalars(coeffs), dim);
+    auto const b = as_mat(table.all_values(), n);
+    as_mat(impl::spline_scalars(result), dim).noalias() = x * b;
+}
+
+/// Evaluates a tensor product spline surface (or one of its partial derivatives) at each pair of
+/// parameters in the given tables. Results are ordered with u varying fastest. The surface is
+/// contracted with the v table first then each row of the result is evaluated as a single matrix
+/// product over all u parameters.
+template <
+    typename BasisU,
+    typename BasisV,
+    typename Real,
+    isize max_order_u,
+    isize max_order_v,
+    typename Value>
+void eval_spline_batch(
+    Span<Value const> const& coeffs,
+    SplineBasisTable<BasisU, Real, max_order_u> const& table_u,
+    isize const order_u,
+    SplineBasisTable<BasisV, Real, max_order_v> const& table_v,
+    isize const order_v,
+    Span<Value> const& result,
+    Executor const exec = {})
+{
+    using Traits = impl::SplineValue<Value>;
+    static_assert(std::is_same_v<typename Traits::Scalar, Real>);
+
+    constexpr int dim = Traits::dim;
+    constexpr isize n_u = BasisU::size;
+    constexpr isize n_v = BasisV::size;
+
+    isize const m_u = table_u.num_params();
+    isize const m_v = table_v.num_params();
+
+    assert(coeffs.size() == n_u * n_v);
+    assert(result.size() == m_u * m_v);
+
+    // Contract over v
+    DynamicArray<Real> tmp(dim * n_u * m_v, table_u.allocator());
+    as_mat(as_span(tmp), dim * n_u).noalias() = as_mat(impl::spline_scalars(coeffs), dim * n_u)
+        * as_mat(table_v.values(order_v), n_v);
+
+    // Contract over u
+    auto const b_u = as_mat(table_u.values(order_u), n_u);
+    Span<Real> const dst = impl::spline_scalars(result);
+
+    exec.parallel_for(m_v, [&](isize const j) {
+        as_mat(dst.segment(j * m_u * dim, m_u * dim), dim).noalias() =
+            as_mat(as_span(tmp).as_const().segment(j * n_u * dim, n_u * dim), dim) * b_u;
+    });
+}
+
+/// Evaluates a tensor product spline surface and all of its partial derivatives up to the maximum
+/// order of each table in one pass over the coefficients. The coefficients are contracted with the
+/// stacked v tables of all orders as a single matrix product then each row of the result is
+/// evaluated for each u order. The derivative of orders (a, b) at parameters (i, j) is written to
+/// index ((b * o_u + a) * m_v + j) * m_u + i where o_u is the number of u orders and m_u, m_v are
+/// the numbers of parameters.
+template <
+    typename BasisU,
+    typename BasisV,
+    typename Real,
+    isize max_order_u,
+    isize max_order_v,
+    typename Value>
+void eval_spline_batch(
+    Span<Value const> const& coeffs,
+    SplineBasisTable<BasisU, Real, max_order_u> const& table_u,
+    SplineBasisTable<BasisV, Real, max_order_v> const& table_v,
+    Span<Value> const& result,
+    Executor const exec = {})
+{
+    using Traits = impl::SplineValue<Value>;
+    static_assert(std::is_same_v<typename Traits::Scalar, Real>);
+
+    constexpr int dim = Traits::dim;
+    constexpr isize n_u = BasisU::size;
+    constexpr isize n_v = BasisV::size;
+    constexpr isize o_u = max_order_u + 1;
+    constexpr isize o_v = max_order_v + 1;
+
+    isize const m_u = table_u.num_params();
+    isize const m_v = table_v.num_params();
+
+    assert(coeffs.size() == n_u * n_v);
+    assert(result.size() == o_u * o_v * m_u * m_v);
+
+    // Contract over v for all orders at once
+    DynamicArray<Real> tmp(dim * n_u * o_v * m_v, table_u.allocator());
+    as_mat(as_span(tmp), dim * n_u).noalias() = as_mat(impl::spline_scalars(coeffs), dim * n_u)
+        * as_mat(table_v.all_values(), n_v);
+
+    // Contract over u for each order
+    Span<Real> const dst = impl::spline_scalars(result);
+
+    exec.parallel_for(o_v * m_v, [&](isize const row) {
+        isize const b = row / m_v;
+        isize const j = row % m_v;
+        auto const x = as_mat(as_span(tmp).as_const().segment(row * n_u * dim, n_u * dim), dim);
+
+        for (isize a = 0; a < o_u; ++a)
+        {
+            isize const offset = ((b * o_u + a) * m_v + j) * m_u * dim;
+            as_mat(dst.segment(offset, m_u * dim), dim).noalias() =
+                x * as_mat(table_u.values(a), n_u);
+        }
+    });
+}
+
+/// Evaluates a tensor product spline volume (or one of its partial derivatives) at each triple of
+/// parameters in the given tables. Results are ordered with u varying fastest then v. The volume
+/// is contracted with the w table, then the v table, then each row of the result is evaluated as
+/// a single matrix product over all u parameters.
+template <
+    typename BasisU,
+    typename BasisV,
+    typename BasisW,
+    typename Real,
+    isize max_order_u,
+    isize max_order_v,
+    isize max_order_w,
+    typename Value>
+void eval_spline_batch(
+    Span<Value const> const& coeffs,
+    SplineBasisTable<BasisU, Real, max_order_u> const& table_u,
+    isize const order_u,
+    SplineBasisTable<BasisV, Real, max_order_v> const& table_v,
+    isize const order_v,
+    SplineBasisTable<BasisW, Real, max_order_w> const& table_w,
+    isize const order_w,
+    Span<Value> const& result,
+    Executor const exec = {})
+{
+    using Traits = impl::SplineValue<Value>;
+    static_assert(std::is_same_v<typename Traits::Scalar, Real>);
+
+    constexpr int dim = Traits::dim;
+    constexpr isize n_u = BasisU::size;
+    constexpr isize n_v = BasisV::size;
+    constexpr isize n_w = BasisW::size;
+
+    isize const m_u = table_u.num_params();
+    isize const m_v = table_v.num_params();
+    isize const m_w = table_w.num_params();
+
+    assert(coeffs.size() == n_u * n_v * n_w);
+    assert(result.size() == m_u * m_v * m_w);
+
+    // Contract over w
+    DynamicArray<Real> tmp_w(dim * n_u * n_v * m_w, table_u.allocator());
+    as_mat(as_span(tmp_w), dim * n_u * n_v).noalias() =
+        as_mat(impl::spline_scalars(coeffs), dim * n_u * n_v)
+        * as_mat(table_w.values(order_w), n_w);
+
+    // Contract over v
+    DynamicArray<Real> tmp_v(dim * n_u * m_v * m_w, table_u.allocator());
+    {
+        auto const b_v = as_mat(table_v.values(order_v), n_v);
+        isize const src_size = dim * n_u * n_v;
+        isize const dst_size = dim * n_u * m_v;
+
+        exec.parallel_for(m_w, [&](isize const k) {
+            as_mat(as_span(tmp_v).segment(k * dst_size, dst_size), dim * n_u).noalias() =
+                as_mat(as_span(tmp_w).as_const().segment(k * src_size, src_size), dim * n_u)
+                * b_v;
+        });
+    }
+
+    // Contract over u
+    auto const b_u = as_mat(table_u.values(order_u), n_u);
+    Span<Real> const dst = impl::spline_scalars(result);
+
+    exec.parallel_for(m_v * m_w, [&](isize const jk) {
+        as_mat(dst.segment(jk * m_u * dim, m_u * dim), dim).noalias() =
+            as_mat(as_span(tmp_v).as_const().segment(jk * n_u * dim, n_u * dim), dim) * b_u;
+    });
+}
+
+/// Evaluates a tensor product spline volume and all of its partial derivatives up to the maximum
+/// order of each table in one pass over the coefficients (see the surface version above). The
+/// derivative of orders (a, b, c) at parameters (i, j, k) is written to index
+/// ((((c * o_v + b) * o_u + a) * m_w + k) * m_v + j) * m_u + i.
+template <
+    typename BasisU,
+    typename BasisV,
+    typename BasisW,
+    typename Real,
+    isize max_order_u,
+    isize max_order_v,
+    isize max_order_w,
+    typename Value>
+void eval_spline_batch(
+    Span<Value const> const& coeffs,
+    SplineBasisTable<BasisU, Real, max_order_u> const& table_u,
+    SplineBasisTable<BasisV, Real, max_order_v> const& table_v,
+    SplineBasisTable<BasisW, Real, max_order_w> const& table_w,
+    Span<Value> const& result,
+    Executor const exec = {})
+{
+    using Traits = impl::SplineValue<Value>;
+    static_assert(std::is_same_v<typename Traits::Scalar, Real>);
+
+    constexpr int dim = Traits::dim;
+    constexpr isize n_u = BasisU::size;
+    constexpr isize n_v = BasisV::size;
+    constexpr isize n_w = BasisW::size;
+    constexpr isize o_u = max_order_u + 1;
+    constexpr isize o_v = max_order_v + 1;
+    constexpr isize o_w = max_order_w + 1;
+
+    isize const m_u = table_u.num_params();
+    isize const m_v = table_v.num_params();
+    isize const m_w = table_w.num_params();
+
+    assert(coeffs.size() == n_u * n_v * n_w);
+    assert(result.size() == o_u * o_v * o_w * m_u * m_v * m_w);
+
+    // Contract over w for all orders at once
+    DynamicArray<Real> tmp_w(dim * n_u * n_v * o_w * m_w, table_u.allocator());
+    as_mat(as_span(tmp_w), dim * n_u * n_v).noalias() =
+        as_mat(impl::spline_scalars(coeffs), dim * n_u * n_v)
+        * as_mat(table_w.all_values(), n_w);
+
+    // Contract over v for all orders at once
+    DynamicArray<Real> tmp_v(dim * n_u * o_v * m_v * o_w * m_w, table_u.allocator());
+    {
+        auto const b_v = as_mat(table_v.all_values(), n_v);
+        isize const src_size = dim * n_u * n_v;
+        isize const dst_size = dim * n_u * o_v * m_v;
+
+        exec.parallel_for(o_w * m_w, [&](isize const col) {
+            as_mat(as_span(tmp_v).segment(col * dst_size, dst_size), dim * n_u).noalias() =
+                as_mat(as_span(tmp_w).as_const().segment(col * src_size, src_size), dim * n_u)
+                * b_v;
+        });
+    }
+
+    // Contract over u for each order
+    Span<Real> const dst = impl::spline_scalars(result);
+
+    exec.parallel_for(o_w * m_w * o_v * m_v, [&](isize const row) {
+        isize const c = row / (m_w * o_v * m_v);
+        isize const k = row / (o_v * m_v) % m_w;
+        isize const b = row / m_v % o_v;
+        isize const j = row % m_v;
+        auto const x = as_mat(as_span(tmp_v).as_const().segment(row * n_u * dim, n_u * dim), dim);
+
+        for (isize a = 0; a < o_u; ++a)
+        {
+            isize const offset = ((((c * o_v + b) * o_u + a) * m_w + k) * m_v + j) * m_u * dim;
+            as_mat(dst.segment(offset, m_u * dim), dim).noalias() =
+                x * as_mat(table_u.values(a), n_u);
+        }
+    });
+}
+
+} // namespace dr
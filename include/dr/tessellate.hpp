@@ -0,0 +1,533 @@
+#pragma once
+
+/*
+    Adaptive tessellation of spline curves and surfaces
+*/
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include <dr/basic_traits.hpp>
+#include <dr/container_utils.hpp>
+#include <dr/dynamic_array.hpp>
+#include <dr/executor.hpp>
+#include <dr/math_types.hpp>
+#include <dr/memory.hpp>
+#include <dr/sliced_array.hpp>
+#include <dr/span.hpp>
+#include <dr/spline.hpp>
+
+namespace dr
+{
+
+/// Number of segments used to tessellate each boundary and the interior of a surface patch
+struct PatchTessellation
+{
+    /// Number of segments along each edge in counter-clockwise order starting from v = 0
+    isize outer[4];
+
+    /// Number of segments in the interior along u and v
+    isize inner[2];
+
+    /// Returns true if the patch can be tessellated as a regular grid
+    bool is_regular() const
+    {
+        return outer[0] == inner[0] && outer[2] == inner[0] && outer[1] == inner[1]
+            && outer[3] == inner[1];
+    }
+
+    /// Returns the number of vertices in the tessellated patch
+    isize num_vertices() const
+    {
+        if (is_regular())
+            return (inner[0] + 1) * (inner[1] + 1);
+        else
+            return outer[0] + outer[1] + outer[2] + outer[3] + (inner[0] - 1) * (inner[1] - 1);
+    }
+
+    /// Returns the number of triangles in the tessellated patch
+    isize num_faces() const
+    {
+        if (is_regular())
+            return 2 * inner[0] * inner[1];
+        else
+            return outer[0] + outer[1] + outer[2] + outer[3] + 2 * (inner[0] - 2) * (inner[1] - 2)
+                + 2 * (inner[0] - 2) + 2 * (inner[1] - 2);
+    }
+};
+
+namespace impl
+{
+
+/// Number of samples along each parametric direction used to bound the curvature of a patch
+constexpr isize tessellation_num_samples = 8;
+
+/// Returns the number of uniform segments needed to approximate a curve within the given
+/// tolerance. Linear interpolation over a segment of length h deviates from the curve by at most
+/// h^2 / 8 times the magnitude of its second derivative.
+template <typename Real>
+isize tessellation_num_segments(
+    Real const max_diff2,
+    Real const tolerance,
+    isize const max_segments)
+{
+    Real const n = std::ceil(std::sqrt(max_diff2 / (Real{8.0} * tolerance)));
+    return std::clamp<isize>(isize(std::min(n, Real(max_segments))), 1, max_segments);
+}
+
+/// Recursively bisects the parameter interval [a, b] until each segment is within the given
+/// tolerance. Calls the given function with the end of each segment in order.
+template <typename Basis, typename Value, typename Real, typename Emit>
+void tessellate_curve_visit(
+    Value const coeffs[Basis::size],
+    Real const a,
+    Real const b,
+    Value const& diff_a,
+    Value const& diff_b,
+    Real const tolerance,
+    isize const depth,
+    Emit&& emit)
+{
+    using DiffBasis = typename Basis::template Diff<1>;
+
+    Real const h = b - a;
+    Real const m = Real{0.5} * (a + b);
+    Value const diff_m = spline_eval<DiffBasis>(coeffs, m);
+
+    // Estimate deviation from the change in tangent over each half of the interval
+    Real const d = std::max((diff_m - diff_a).norm(), (diff_b - diff_m).norm());
+
+    if (depth > 0 && Real{0.25} * h * d > tolerance)
+    {
+        tessellate_curve_visit<Basis>(coeffs, a, m, diff_a, diff_m, tolerance, depth - 1, emit);
+        tessellate_curve_visit<Basis>(coeffs, m, b, diff_m, diff_b, tolerance, depth - 1, emit);
+    }
+    else
+    {
+        emit(b);
+    }
+}
+
+/// Calls the given function with each parameter of an adaptive tessellation of a curve
+template <typename Basis, typename Value, typename Real, typename Emit>
+void tessellate_curve(
+    Value const coeffs[Basis::size],
+    Real const tolerance,
+    isize const max_depth,
+    Emit&& emit)
+{
+    using DiffBasis = typename Basis::template Diff<1>;
+
+    Value const diff_a = spline_eval<DiffBasis>(coeffs, Real{0.0});
+    Value const diff_b = spline_eval<DiffBasis>(coeffs, Real{1.0});
+
+    emit(Real{0.0});
+    tessellate_curve_visit<Basis>(
+        coeffs,
+        Real{0.0},
+        Real{1.0},
+        diff_a,
+        diff_b,
+        tolerance,
+        max_depth,
+        emit);
+}
+
+/// Returns the largest change in the u derivative between adjacent samples along the given
+/// isolines of constant v, scaled by the number of samples
+template <typename BasisU, typename BasisV, typename Value, typename Real>
+Real tessellation_max_diff2_u(
+    Value const coeffs[BasisU::size * BasisV::size],
+    isize const v_start,
+    isize const v_end,
+    isize const v_step)
+{
+    using DiffBasisU = typename BasisU::template Diff<1>;
+    constexpr isize n = tessellation_num_samples;
+
+    Real result{0.0};
+
+    for (isize j = v_start; j <= v_end; j += v_step)
+    {
+        Real const v = Real(j) / Real(n);
+        Value prev = spline_eval<DiffBasisU, BasisV>(coeffs, Real{0.0}, v);
+
+        for (isize i = 1; i <= n; ++i)
+        {
+            Value const next = spline_eval<DiffBasisU, BasisV>(coeffs, Real(i) / Real(n), v);
+            result = std::max(result, (next - prev).norm() * Real(n));
+            prev = next;
+        }
+    }
+
+    return result;
+}
+
+/// Returns the largest change in the v derivative between adjacent samples along the given
+/// isolines of constant u, scaled by the number of samples
+template <typename BasisU, typename BasisV, typename Value, typename Real>
+Real tessellation_max_diff2_v(
+    Value const coeffs[BasisU::size * BasisV::size],
+    isize const u_start,
+    isize const u_end,
+    isize const u_step)
+{
+    using DiffBasisV = typename BasisV::template Diff<1>;
+    constexpr isize n = tessellation_num_samples;
+
+    Real result{0.0};
+
+    for (isize i = u_start; i <= u_end; i += u_step)
+    {
+        Real const u = Real(i) / Real(n);
+        Value prev = spline_eval<BasisU, DiffBasisV>(coeffs, u, Real{0.0});
+
+        for (isize j = 1; j <= n; ++j)
+        {
+            Value const next = spline_eval<BasisU, DiffBasisV>(coeffs, u, Real(j) / Real(n));
+            result = std::max(result, (next - prev).norm() * Real(n));
+            prev = next;
+        }
+    }
+
+    return result;
+}
+
+/// Emits triangles which stitch a boundary edge of a patch to the adjacent side of its interior
+/// grid. Both sides are traversed counter-clockwise and merged by parameter.
+template <typename Index, typename OuterFn, typename InnerFn>
+Vec3<Index>* tessellation_stitch(
+    isize const num_outer,
+    isize const num_inner,
+    OuterFn&& outer,
+    InnerFn&& inner,
+    Vec3<Index>* dst)
+{
+    // Outer side has num_outer segments, inner side has num_inner - 2 segments
+    isize a = 0;
+    isize b = 0;
+
+    while (a < num_outer || b < num_inner - 2)
+    {
+        bool const advance_outer =
+            (b == num_inner - 2) || (a < num_outer && (a + 1) * num_inner <= (b + 2) * num_outer);
+
+        if (advance_outer)
+        {
+            *dst++ = {Index(outer(a)), Index(outer(a + 1)), Index(inner(b))};
+            ++a;
+        }
+        else
+        {
+            *dst++ = {Index(outer(a)), Index(inner(b + 1)), Index(inner(b))};
+            ++b;
+        }
+    }
+
+    return dst;
+}
+
+} // namespace impl
+
+/// Adaptively tessellates a set of spline curves such that each segment deviates from its curve
+/// by roughly no more than the given tolerance. Coefficients of each curve are contiguous.
+/// Parameters are bisected where the curve bends, guided by its first derivative, up to the given
+/// depth. Points of each curve (including both end points) are written to a separate slice of
+/// the result.
+template <typename Basis, typename Value, typename Real, typename Index>
+void tessellate_curves(
+    Span<Value const> const& coeffs,
+    Real const tolerance,
+    SlicedArray<Value, Index>& result,
+    isize const max_depth = 10,
+    Executor const exec = {})
+{
+    static_assert(is_real<Real>);
+
+    constexpr isize n = Basis::size;
+    assert(coeffs.size() % n == 0);
+    assert(tolerance > Real{0.0});
+
+    auto const count = [&](Index const i) -> Index {
+        Index result = 0;
+
+        impl::tessellate_curve<Basis>(
+            coeffs.data() + i * n,
+            tolerance,
+            max_depth,
+            [&](Real /*t*/) { ++result; });
+
+        return result;
+    };
+
+    auto const fill = [&](Index const i, Span<Value> const& points) {
+        Value const* c = coeffs.data() + i * n;
+        Value* dst = points.data();
+
+        impl::tessellate_curve<Basis>(c, tolerance, max_depth, [&](Real const t) {
+            *dst++ = impl::spline_eval<Basis>(c, t);
+        });
+    };
+
+    count_then_fill(Index(coeffs.size() / n), count, fill, result, exec);
+}
+
+/// Determines the number of segments needed to tessellate a spline patch within the given
+/// tolerance. Edge counts depend only on the patch boundary so that adjacent patches which share a
+/// boundary curve agree on its tessellation.
+template <typename BasisU, typename BasisV, typename Value, typename Real>
+PatchTessellation tessellation_levels(
+    Value const coeffs[BasisU::size * BasisV::size],
+    Real const tolerance,
+    isize const max_segments)
+{
+    static_assert(is_real<Real>);
+    assert(tolerance > Real{0.0});
+
+    constexpr isize n = impl::tessellation_num_samples;
+
+    auto const to_segments = [&](Real const max_diff2) -> isize {
+        return impl::tessellation_num_segments(max_diff2, tolerance, max_segments);
+    };
+
+    auto const diff2_u = [&](isize const start, isize const end, isize const step) -> Real {
+        return impl::tessellation_max_diff2_u<BasisU, BasisV, Value, Real>(
+            coeffs,
+            start,
+            end,
+            step);
+    };
+
+    auto const diff2_v = [&](isize const start, isize const end, isize const step) -> Real {
+        return impl::tessellation_max_diff2_v<BasisU, BasisV, Value, Real>(
+            coeffs,
+            start,
+            end,
+            step);
+    };
+
+    PatchTessellation result;
+    result.outer[0] = to_segments(diff2_u(0, 0, 1));
+    result.outer[1] = to_segments(diff2_v(n, n, 1));
+    result.outer[2] = to_segments(diff2_u(n, n, 1));
+    result.outer[3] = to_segments(diff2_v(0, 0, 1));
+
+    // Interior is at least as fine as either of its parallel edges
+    isize const* e = result.outer;
+    result.inner[0] = std::max({to_segments(diff2_u(1, n - 1, 1)), e[0], e[2]});
+    result.inner[1] = std::max({to_segments(diff2_v(1, n - 1, 1)), e[1], e[3]});
+
+    // Irregular patches are stitched to an interior grid which needs at least one interior vertex
+    if (!result.is_regular())
+    {
+        result.inner[0] = std::max<isize>(result.inner[0], 2);
+        result.inner[1] = std::max<isize>(result.inner[1], 2);
+    }
+
+    return result;
+}
+
+/// Writes the vertices and faces of a tessellated patch. Face vertices are offset by the given
+/// index.
+template <typename BasisU, typename BasisV, typename Value, typename Real, typename Index>
+void tessellate_patch(
+    Value const coeffs[BasisU::size * BasisV::size],
+    PatchTessellation const& levels,
+    Index const vertex_offset,
+    Span<Value> const& vertex_positions,
+    Span<Vec3<Index>> const& face_vertices)
+{
+    static_assert(is_real<Real>);
+
+    assert(vertex_positions.size() == levels.num_vertices());
+    assert(face_vertices.size() == levels.num_faces());
+
+    isize const n_u = levels.inner[0];
+    isize const n_v = levels.inner[1];
+
+    auto const eval = [&](Real const u, Real const v) -> Value {
+        return impl::spline_eval<BasisU, BasisV>(coeffs, u, v);
+    };
+
+    if (levels.is_regular())
+    {
+        for (isize j = 0; j <= n_v; ++j)
+        {
+            Real const v = Real(j) / Real(n_v);
+
+            for (isize i = 0; i <= n_u; ++i)
+                vertex_positions[i + j * (n_u + 1)] = eval(Real(i) / Real(n_u), v);
+        }
+
+        Vec3<Index>* dst = face_vertices.data();
+
+        for (isize j = 0; j < n_v; ++j)
+        {
+            for (isize i = 0; i < n_u; ++i)
+            {
+                Index const v0 = vertex_offset + Index(i + j * (n_u + 1));
+                Index const v1 = v0 + 1;
+                Index const v2 = v1 + Index(n_u + 1);
+                Index const v3 = v0 + Index(n_u + 1);
+
+                *dst++ = {v0, v1, v2};
+                *dst++ = {v0, v2, v3};
+            }
+        }
+
+        return;
+    }
+
+    // Boundary vertices form a counter-clockwise ring starting from the corner at (0, 0). Reversed
+    // edges are evaluated at (e - k) / e rather than 1 - k / e so that their parameters match the
+    // forward edge of an adjacent patch exactly.
+    isize const* e = levels.outer;
+    isize const ring_start[]{0, e[0], e[0] + e[1], e[0] + e[1] + e[2]};
+    isize const ring_size = ring_start[3] + e[3];
+
+    for (isize k = 0; k < e[0]; ++k)
+        vertex_positions[ring_start[0] + k] = eval(Real(k) / Real(e[0]), Real{0.0});
+
+    for (isize k = 0; k < e[1]; ++k)
+        vertex_positions[ring_start[1] + k] = eval(Real{1.0}, Real(k) / Real(e[1]));
+
+    for (isize k = 0; k < e[2]; ++k)
+        vertex_positions[ring_start[2] + k] = eval(Real(e[2] - k) / Real(e[2]), Real{1.0});
+
+    for (isize k = 0; k < e[3]; ++k)
+        vertex_positions[ring_start[3] + k] = eval(Real{0.0}, Real(e[3] - k) / Real(e[3]));
+
+    // Interior vertices form a regular grid
+    auto const interior = [&](isize const i, isize const j) -> isize {
+        return ring_size + (i - 1) + (j - 1) * (n_u - 1);
+    };
+
+    for (isize j = 1; j < n_v; ++j)
+    {
+        for (isize i = 1; i < n_u; ++i)
+            vertex_positions[interior(i, j)] = eval(Real(i) / Real(n_u), Real(j) / Real(n_v));
+    }
+
+    auto const ring = [&](isize const edge, isize const k) -> isize {
+        return vertex_offset + (ring_start[edge] + k) % ring_size;
+    };
+
+    Vec3<Index>* dst = face_vertices.data();
+
+    // Stitch each edge to the adjacent side of the interior grid
+    dst = impl::tessellation_stitch<Index>(
+        e[0],
+        n_u,
+        [&](isize const k) { return ring(0, k); },
+        [&](isize const k) { return vertex_offset + interior(k + 1, 1); },
+        dst);
+
+    dst = impl::tessellation_stitch<Index>(
+        e[1],
+        n_v,
+        [&](isize const k) { return ring(1, k); },
+        [&](isize const k) { return vertex_offset + interior(n_u - 1, k + 1); },
+        dst);
+
+    dst = impl::tessellation_stitch<Index>(
+        e[2],
+        n_u,
+        [&](isize const k) { return ring(2, k); },
+        [&](isize const k) { return vertex_offset + interior(n_u - 1 - k, n_v - 1); },
+        dst);
+
+    dst = impl::tessellation_stitch<Index>(
+        e[3],
+        n_v,
+        [&](isize const k) { return ring(3, k); },
+        [&](isize const k) { return vertex_offset + interior(1, n_v - 1 - k); },
+        dst);
+
+    // Triangulate the interior grid
+    for (isize j = 1; j < n_v - 1; ++j)
+    {
+        for (isize i = 1; i < n_u - 1; ++i)
+        {
+            Index const v0 = Index(vertex_offset + interior(i, j));
+            Index const v1 = Index(vertex_offset + interior(i + 1, j));
+            Index const v2 = Index(vertex_offset + interior(i + 1, j + 1));
+            Index const v3 = Index(vertex_offset + interior(i, j + 1));
+
+            *dst++ = {v0, v1, v2};
+            *dst++ = {v0, v2, v3};
+        }
+    }
+
+    assert(dst == face_vertices.data() + face_vertices.size());
+}
+
+/// Adaptively tessellates a set of spline patches into triangles such that each triangle deviates
+/// from its patch by roughly no more than the given tolerance. Coefficients of each patch are
+/// contiguous with u varying fastest (see eval_bicubic).
+///
+/// The number of segments along each edge and across the interior of a patch is derived from
+/// bounds on its second derivatives, estimated from the change in its first derivatives between
+/// samples. Interior grids are stitched to their edges so the result is crack-free: patches which
+/// share a boundary curve (with the same orientation) produce identical vertices along it. Shared
+/// vertices are duplicated between patches and can be welded if needed.
+///
+/// Vertices and faces of each patch are written to a separate slice of the results. Face vertices
+/// index into the items of the vertex array. Patches are processed in parallel.
+template <typename BasisU, typename BasisV, typename Real, typename Index>
+void tessellate_patches(
+    Span<Vec3<Real> const> const& coeffs,
+    Real const tolerance,
+    SlicedArray<Vec3<Real>, isize>& vertex_positions,
+    SlicedArray<Vec3<Index>, isize>& face_vertices,
+    isize const max_segments = 64,
+    Executor const exec = {},
+    Allocator const alloc = {})
+{
+    static_assert(is_real<Real>);
+    static_assert(is_integer<Index> || is_natural<Index>);
+
+    constexpr isize n = BasisU::size * BasisV::size;
+    assert(coeffs.size() % n == 0);
+
+    isize const num_patches = coeffs.size() / n;
+    DynamicArray<PatchTessellation> levels(num_patches, alloc);
+
+    auto const patch_coeffs = [&](isize const i) -> Vec3<Real> const* {
+        return coeffs.data() + i * n;
+    };
+
+    auto const eval_levels = [&](isize const i) {
+        levels[i] = tessellation_levels<BasisU, BasisV>(patch_coeffs(i), tolerance, max_segments);
+    };
+
+    // Refinement levels vary between patches so work is balanced dynamically
+    exec.parallel_for_dynamic(num_patches, eval_levels);
+
+    // Vertices are filled along with faces below
+    {
+        DynamicArray<isize> counts(num_patches, alloc);
+        for (isize i = 0; i < num_patches; ++i)
+            counts[i] = levels[i].num_vertices();
+
+        vertex_positions.assign_sizes(as_span(counts).as_const(), exec);
+    }
+
+    count_then_fill(
+        num_patches,
+        [&](isize const i) { return levels[i].num_faces(); },
+        [&](isize const i, Span<Vec3<Index>> const& faces) {
+            isize const offset = (i > 0) ? vertex_positions.slice_ends[i - 1] : 0;
+
+            tessellate_patch<BasisU, BasisV, Vec3<Real>, Real>(
+                patch_coeffs(i),
+                levels[i],
+                Index(offset),
+                vertex_positions[i],
+                faces);
+        },
+        face_vertices,
+        exec);
+}
+
+} // namespace dr
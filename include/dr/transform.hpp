@@ -1,11 +1,65 @@
 #pragma once
 
+#include <algorithm>
+#include <cassert>
+
 #include <dr/basic_traits.hpp>
+#include <dr/executor.hpp>
+#include <dr/linalg_reshape.hpp>
 #include <dr/math_ctors.hpp>
 #include <dr/math_types.hpp>
+#include <dr/span.hpp>
 
 namespace dr
 {
+namespace impl
+{
+
+/// Number of vectors transformed together in batched kernels
+constexpr isize transform_block_size = 64;
+
+/// Applies a linear transformation followed by an optional translation and normalization to each
+/// of the given vectors. Vectors are processed in fixed-size blocks which are mapped to matrices so
+/// that each block is transformed by a single matrix product. Source and destination may alias.
+template <bool translate, bool normalize, typename Real, int dim>
+void transform_batch(
+    Mat<Real, dim, dim> const& linear,
+    Vec<Real, dim> const& translation,
+    Span<Vec<Real, dim> const> const& src,
+    Span<Vec<Real, dim>> const& dst,
+    Executor const exec)
+{
+    assert(src.size() == dst.size());
+
+    constexpr isize block_size = transform_block_size;
+    isize const n = src.size();
+    isize const num_blocks = (n + block_size - 1) / block_size;
+
+    auto const apply_block = [&](isize const block) {
+        isize const start = block * block_size;
+        isize const count = std::min(block_size, n - start);
+
+        // Evaluated into a temporary since the source may alias the destination
+        Mat<Real, dim, block_size> tmp;
+        auto tmp_block = tmp.leftCols(count);
+        tmp_block.noalias() = linear * as_mat(src.segment(start, count));
+
+        if constexpr (translate)
+            tmp_block.colwise() += translation;
+
+        if constexpr (normalize)
+        {
+            for (isize i = 0; i < count; ++i)
+                tmp_block.col(i).normalize();
+        }
+
+        as_mat(dst.segment(start, count)) = tmp_block;
+    };
+
+    exec.parallel_for(num_blocks, apply_block);
+}
+
+} // namespace impl
 
 template <typename Real, int dim>
 struct Affine
@@ -56,6 +110,37 @@ struct Affine
     /// Applies this transformation to the given vector
     Vec<Real, dim> operator*(Vec<Real, dim> const& u) const { return apply(u); }
 
+    /// Applies this transformation to each of the given points. The result may alias the input.
+    void apply(
+        Span<Vec<Real, dim> const> const& points,
+        Span<Vec<Real, dim>> const& result,
+        Executor const exec = {}) const
+    {
+        impl::transform_batch<true, false>(linear, translation, points, result, exec);
+    }
+
+    /// Applies this transformation to each of the given unit normals. Results are renormalized.
+    /// The result may alias the input.
+    void apply_normal(
+        Span<Vec<Real, dim> const> const& normals,
+        Span<Vec<Real, dim>> const& result,
+        Executor const exec = {}) const
+    {
+        Mat<Real, dim, dim> const m = linear.inverse().transpose();
+        impl::transform_batch<false, true>(m, {}, normals, result, exec);
+    }
+
+    /// Applies this transformation to each of the given covectors (e.g. gradients of scalar
+    /// fields) via the inverse transpose of its linear part. The result may alias the input.
+    void apply_covector(
+        Span<Vec<Real, dim> const> const& covectors,
+        Span<Vec<Real, dim>> const& result,
+        Executor const exec = {}) const
+    {
+        Mat<Real, dim, dim> const m = linear.inverse().transpose();
+        impl::transform_batch<false, false>(m, {}, covectors, result, exec);
+    }
+
     /// Applies this transformation to another transformation
     Affine<Real, dim> apply(Affine<Real, dim> const& other) const
     {
@@ -192,6 +277,38 @@ struct Conformal
     /// Applies this transformation to the given vector
     Vec<Real, dim> operator*(Vec<Real, dim> const& u) const { return apply(u); }
 
+    /// Applies this transformation to each of the given points. The result may alias the input.
+    void apply(
+        Span<Vec<Real, dim> const> const& points,
+        Span<Vec<Real, dim>> const& result,
+        Executor const exec = {}) const
+    {
+        Mat<Real, dim, dim> const m = scale * rotation.to_matrix();
+        impl::transform_batch<true, false>(m, translation, points, result, exec);
+    }
+
+    /// Applies this transformation to each of the given unit normals. Results are renormalized.
+    /// The result may alias the input.
+    void apply_normal(
+        Span<Vec<Real, dim> const> const& normals,
+        Span<Vec<Real, dim>> const& result,
+        Executor const exec = {}) const
+    {
+        Mat<Real, dim, dim> const m = rotation.to_matrix();
+        impl::transform_batch<false, true>(m, {}, normals, result, exec);
+    }
+
+    /// Applies this transformation to each of the given covectors (e.g. gradients of scalar
+    /// fields) via the inverse transpose of its linear part. The result may alias the input.
+    void apply_covector(
+        Span<Vec<Real, dim> const> const& covectors,
+        Span<Vec<Real, dim>> const& result,
+        Executor const exec = {}) const
+    {
+        Mat<Real, dim, dim> const m = rotation.to_matrix() / scale;
+        impl::transform_batch<false, false>(m, {}, covectors, result, exec);
+    }
+
     /// Applies this transformation to another transformation
     Conformal<Real, dim> apply(Conformal<Real, dim> const& other) const
     {
@@ -283,6 +400,38 @@ struct Rigid
     /// Applies this transformation to the given vector
     Vec<Real, dim> operator*(Vec<Real, dim> const& u) const { return apply(u); }
 
+    /// Applies this transformation to each of the given points. The result may alias the input.
+    void apply(
+        Span<Vec<Real, dim> const> const& points,
+        Span<Vec<Real, dim>> const& result,
+        Executor const exec = {}) const
+    {
+        Mat<Real, dim, dim> const m = rotation.to_matrix();
+        impl::transform_batch<true, false>(m, translation, points, result, exec);
+    }
+
+    /// Applies this transformation to each of the given unit normals. Results are renormalized.
+    /// The result may alias the input.
+    void apply_normal(
+        Span<Vec<Real, dim> const> const& normals,
+        Span<Vec<Real, dim>> const& result,
+        Executor const exec = {}) const
+    {
+        Mat<Real, dim, dim> const m = rotation.to_matrix();
+        impl::transform_batch<false, true>(m, {}, normals, result, exec);
+    }
+
+    /// Applies this transformation to each of the given covectors (e.g. gradients of scalar
+    /// fields) via the inverse transpose of its linear part. The result may alias the input.
+    void apply_covector(
+        Span<Vec<Real, dim> const> const& covectors,
+        Span<Vec<Real, dim>> const& result,
+        Executor const exec = {}) const
+    {
+        Mat<Real, dim, dim> const m = rotation.to_matrix();
+        impl::transform_batch<false, false>(m, {}, covectors, result, exec);
+    }
+
     /// Applies this transformation to another transformation
     Rigid<Real, dim> apply(Rigid<Real, dim> const& other) const
     {
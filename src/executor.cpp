@@ -0,0 +1,343 @@
+#include <dr/executor.hpp>
+
+namespace dr
+{
+namespace
+{
+
+// Pool whose task is running on the current thread if any
+thread_local ThreadPool const* current_pool{};
+
+// Number of failed attempts to steal before an idle thread goes to sleep
+constexpr isize max_idle_spins = 64;
+
+} // namespace
+
+/// Chase-Lev work-stealing deque of index ranges (Lê et al. 2013). The owning thread pushes and
+/// pops at the bottom while other threads steal from the top. Ranges are split in half before
+/// being pushed so a deque never holds more ranges than the number of bits in an index.
+struct alignas(64) ThreadPool::Deque
+{
+    static constexpr isize capacity = 64;
+
+    struct Range
+    {
+        isize begin;
+        isize end;
+        isize size() const { return end - begin; }
+    };
+
+    // Pushes a range onto the bottom of the deque. Must only be called by the owning thread.
+    void push(Range const& range)
+    {
+        isize const b = bottom_.load(std::memory_order_relaxed);
+        assert(b - top_.load(std::memory_order_acquire) < capacity);
+
+        Slot& slot = slots_[b & (capacity - 1)];
+        slot.begin.store(range.begin, std::memory_order_relaxed);
+        slot.end.store(range.end, std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom_.store(b + 1, std::memory_order_relaxed);
+    }
+
+    // Pops a range from the bottom of the deque. Must only be called by the owning thread.
+    bool pop(Range& result)
+    {
+        isize const b = bottom_.load(std::memory_order_relaxed) - 1;
+        bottom_.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        isize t = top_.load(std::memory_order_relaxed);
+
+        if (t > b)
+        {
+            // Empty
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        result = load(b);
+
+        if (t < b)
+            return true;
+
+        // Last range so race against thieves
+        bool const won = top_.compare_exchange_strong(
+            t,
+            t + 1,
+            std::memory_order_seq_cst,
+            std::memory_order_relaxed);
+
+        bottom_.store(b + 1, std::memory_order_relaxed);
+        return won;
+    }
+
+    // Returns true if the deque appears to hold no ranges. Can be called by any thread.
+    bool empty() const
+    {
+        return top_.load(std::memory_order_acquire) >= bottom_.load(std::memory_order_acquire);
+    }
+
+    // Steals a range from the top of the deque. Can be called by any thread.
+    bool steal(Range& result)
+    {
+        isize t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        isize const b = bottom_.load(std::memory_order_acquire);
+
+        if (t >= b)
+            return false;
+
+        result = load(t);
+
+        return top_.compare_exchange_strong(
+            t,
+            t + 1,
+            std::memory_order_seq_cst,
+            std::memory_order_relaxed);
+    }
+
+  private:
+    struct Slot
+    {
+        std::atomic<isize> begin;
+        std::atomic<isize> end;
+    };
+
+    std::atomic<isize> top_{};
+    std::atomic<isize> bottom_{};
+    Slot slots_[capacity];
+
+    Range load(isize const index) const
+    {
+        Slot const& slot = slots_[index & (capacity - 1)];
+        return {
+            slot.begin.load(std::memory_order_relaxed),
+            slot.end.load(std::memory_order_relaxed),
+        };
+    }
+};
+
+ThreadPool::ThreadPool(isize const num_threads, Allocator const alloc) :
+    deques_(std::max<isize>(num_threads, 1), alloc),
+    workers_(alloc)
+{
+    isize const num_workers = size(deques_) - 1;
+    workers_.reserve(num_workers);
+
+    // Workers use the deques after the calling thread's
+    for (isize i = 1; i <= num_workers; ++i)
+        workers_.emplace_back([this, i]() {
+            worker_loop(i);
+        });
+}
+
+Allocator ThreadPool::allocator() const { return deques_.get_allocator(); }
+
+isize ThreadPool::concurrency() const { return size(deques_); }
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard lock{mutex_};
+        stop_ = true;
+    }
+
+    job_ready_.notify_all();
+
+    for (std::thread& worker : workers_)
+        worker.join();
+}
+
+void ThreadPool::run(isize const num_tasks, FunctionRef<void(isize)> const fn)
+{
+    auto const run_range = [&](isize const begin, isize const end) {
+        for (isize i = begin; i < end; ++i)
+            fn(i);
+    };
+
+    run_ranges(num_tasks, 1, &run_range);
+}
+
+void ThreadPool::run_ranges(
+    isize const count,
+    isize const grain_size,
+    FunctionRef<void(isize, isize)> const fn)
+{
+    assert(grain_size > 0);
+
+    // Nested calls run serially to avoid oversubscription
+    if (current_pool == this || count <= grain_size || workers_.empty())
+    {
+        for (isize i = 0; i < count; i += grain_size)
+            fn(i, std::min(i + grain_size, count));
+
+        return;
+    }
+
+    std::lock_guard run_lock{run_mutex_};
+
+    // The whole range starts on the calling thread's deque and is stolen from there
+    deques_[0].push({0, count});
+    num_remaining_.store(count, std::memory_order_relaxed);
+
+    {
+        std::lock_guard lock{mutex_};
+        job_fn_ = fn;
+        job_grain_size_ = grain_size;
+        num_busy_ = size(workers_);
+        ++job_id_;
+    }
+
+    job_ready_.notify_all();
+
+    ThreadPool const* const prev_pool = current_pool;
+    current_pool = this;
+    work(0, grain_size, fn);
+    current_pool = prev_pool;
+
+    std::unique_lock lock{mutex_};
+    job_done_.wait(lock, [&]() {
+        return num_busy_ == 0;
+    });
+}
+
+void ThreadPool::work(
+    isize const thread,
+    isize const grain_size,
+    FunctionRef<void(isize, isize)> const fn)
+{
+    Deque& own = deques_[thread];
+    isize const num_threads = size(deques_);
+    isize victim = thread;
+    isize num_spins = 0;
+
+    while (num_remaining_.load(std::memory_order_acquire) > 0)
+    {
+        Deque::Range range;
+
+        if (!own.pop(range))
+        {
+            // Look for work on other threads starting from the last successful victim
+            bool found = false;
+            for (isize i = 0; i < num_threads && !found; ++i)
+            {
+                victim = (victim + 1) % num_threads;
+                found = victim != thread && deques_[victim].steal(range);
+            }
+
+            if (!found)
+            {
+                if (++num_spins < max_idle_spins)
+                {
+                    std::this_thread::yield();
+                }
+                else
+                {
+                    wait_for_work(thread);
+                    num_spins = 0;
+                }
+
+                continue;
+            }
+        }
+
+        num_spins = 0;
+
+        // Expose the back half of the range to thieves and continue with the front half
+        bool const pushed = range.size() > grain_size;
+        while (range.size() > grain_size)
+        {
+            isize const mid = range.begin + range.size() / 2;
+            own.push({mid, range.end});
+            range.end = mid;
+        }
+
+        // Let idle threads steal the exposed ranges
+        if (pushed)
+            wake_idle();
+
+        fn(range.begin, range.end);
+
+        // Wake idle threads once the job completes so they can return
+        isize const num_items = range.size();
+        if (num_remaining_.fetch_sub(num_items, std::memory_order_acq_rel) == num_items)
+            wake_idle();
+    }
+}
+
+void ThreadPool::wait_for_work(isize const thread)
+{
+    std::unique_lock lock{mutex_};
+    u64 const wake_id = wake_id_;
+
+    // Announce that this thread is about to sleep before checking for work one last time. Threads
+    // which push work after this point will see it and wake this thread. Threads which pushed work
+    // before this point will have their work seen by the check below.
+    num_idle_.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    bool ready = num_remaining_.load(std::memory_order_relaxed) <= 0;
+    for (isize i = 0; i < size(deques_) && !ready; ++i)
+        ready = i != thread && !deques_[i].empty();
+
+    if (!ready)
+    {
+        work_ready_.wait(lock, [&]() {
+            return wake_id_ != wake_id || num_remaining_.load(std::memory_order_relaxed) <= 0;
+        });
+    }
+
+    num_idle_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void ThreadPool::wake_idle()
+{
+    // Pairs with the fence in wait_for_work
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (num_idle_.load(std::memory_order_relaxed) == 0)
+        return;
+
+    {
+        std::lock_guard lock{mutex_};
+        ++wake_id_;
+    }
+
+    work_ready_.notify_all();
+}
+
+void ThreadPool::worker_loop(isize const thread)
+{
+    current_pool = this;
+    u64 last_job_id = 0;
+
+    while (true)
+    {
+        FunctionRef<void(isize, isize)> fn;
+        isize grain_size;
+        {
+            std::unique_lock lock{mutex_};
+            job_ready_.wait(lock, [&]() {
+                return stop_ || job_id_ != last_job_id;
+            });
+
+            if (stop_)
+                return;
+
+            last_job_id = job_id_;
+            fn = job_fn_;
+            grain_size = job_grain_size_;
+        }
+
+        work(thread, grain_size, fn);
+
+        {
+            std::lock_guard lock{mutex_};
+            if (--num_busy_ == 0)
+                job_done_.notify_one();
+        }
+    }
+}
+
+} // namespace dr
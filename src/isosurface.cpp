@@ -0,0 +1,128 @@
+#include <dr/isosurface.hpp>
+
+namespace dr
+{
+namespace impl
+{
+namespace
+{
+
+struct MarchingCubesTable
+{
+    static constexpr isize max_size = 30;
+
+    u8 sizes[256]{};
+    u8 edges[256][max_size]{};
+};
+
+constexpr u8 find_cube_edge(u8 const c0, u8 const c1)
+{
+    for (u8 i = 0; i < 12; ++i)
+    {
+        u8 const a = marching_cubes_edges[i][0];
+        u8 const b = marching_cubes_edges[i][1];
+
+        if ((a == c0 && b == c1) || (a == c1 && b == c0))
+            return i;
+    }
+
+    return 0xff;
+}
+
+constexpr MarchingCubesTable make_marching_cubes_table()
+{
+    // Corners of each cube face in counter-clockwise order as viewed from outside the cube
+    constexpr u8 face_corners[6][4]{
+        {0, 4, 6, 2},
+        {1, 3, 7, 5},
+        {0, 1, 5, 4},
+        {2, 6, 7, 3},
+        {0, 2, 3, 1},
+        {4, 5, 7, 6},
+    };
+
+    MarchingCubesTable result{};
+
+    for (isize cube_case = 0; cube_case < 256; ++cube_case)
+    {
+        auto const is_inside = [&](u8 const corner) -> bool {
+            return (cube_case >> corner) & 1;
+        };
+
+        // Link crossed edges into directed loops. On each face, the loop goes from an edge where
+        // the boundary enters the inside region to the next edge where it leaves. This separates
+        // inside corners on ambiguous faces. Since adjacent faces traverse their shared edge in
+        // opposite directions, each crossed edge has exactly one successor and predecessor.
+        u8 next[12]{};
+        for (u8& e : next)
+            e = 0xff;
+
+        for (auto const& f_c : face_corners)
+        {
+            u8 crossed[4]{};
+            bool entering[4]{};
+            isize num_crossed = 0;
+
+            for (isize i = 0; i < 4; ++i)
+            {
+                u8 const c0 = f_c[i];
+                u8 const c1 = f_c[(i + 1) % 4];
+
+                if (is_inside(c0) != is_inside(c1))
+                {
+                    crossed[num_crossed] = find_cube_edge(c0, c1);
+                    entering[num_crossed] = is_inside(c1);
+                    ++num_crossed;
+                }
+            }
+
+            for (isize i = 0; i < num_crossed; ++i)
+            {
+                if (entering[i])
+                    next[crossed[i]] = crossed[(i + 1) % num_crossed];
+            }
+        }
+
+        // Triangulate each loop as a fan
+        bool visited[12]{};
+        u8 size = 0;
+
+        for (u8 e = 0; e < 12; ++e)
+        {
+            if (next[e] == 0xff || visited[e])
+                continue;
+
+            u8 loop[12]{};
+            isize loop_size = 0;
+
+            for (u8 f = e; !visited[f]; f = next[f])
+            {
+                visited[f] = true;
+                loop[loop_size++] = f;
+            }
+
+            for (isize i = 1; i + 1 < loop_size; ++i)
+            {
+                result.edges[cube_case][size++] = loop[0];
+                result.edges[cube_case][size++] = loop[i];
+                result.edges[cube_case][size++] = loop[i + 1];
+            }
+        }
+
+        result.sizes[cube_case] = size;
+    }
+
+    return result;
+}
+
+constexpr MarchingCubesTable marching_cubes_table = make_marching_cubes_table();
+
+} // namespace
+
+Span<u8 const> marching_cubes_tris(u8 const cube_case)
+{
+    return {marching_cubes_table.edges[cube_case], marching_cubes_table.sizes[cube_case]};
+}
+
+} // namespace impl
+} // namespace dr
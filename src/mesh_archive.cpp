@@ -0,0 +1,498 @@
+#include <dr/mesh_archive.hpp>
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <dr/hash.hpp>
+
+namespace dr
+{
+namespace
+{
+
+/*
+    File layout
+
+    | FileHeader | SectionEntry * num_sections | padding | section data (aligned) | ... |
+
+    All fields are little-endian. Section data is aligned to section_alignment bytes from the start
+    of the file so that spans over the mapping meet the alignment requirements of their elements.
+*/
+
+constexpr char file_magic[8]{'D', 'R', 'M', 'E', 'S', 'H', '\0', '\0'};
+constexpr u32 file_version = 1;
+constexpr u32 file_endian_tag = 0x01020304;
+constexpr u64 section_alignment = 64;
+
+struct FileHeader
+{
+    char magic[8];
+    u32 version;
+    u32 endian_tag;
+    u64 num_sections;
+    u64 file_size;
+    u64 table_checksum;
+    u64 header_checksum;
+    u8 reserved[16];
+};
+static_assert(sizeof(FileHeader) == 64);
+
+struct SectionEntry
+{
+    char name[MeshArchive::max_name_size];
+    u8 value_type;
+    u8 num_components;
+    u8 reserved[6];
+    u64 count;
+    u64 offset;
+    u64 size;
+    u64 checksum;
+};
+static_assert(sizeof(SectionEntry) == 96);
+
+constexpr u64 align_up(u64 const offset)
+{
+    return (offset + section_alignment - 1) & ~(section_alignment - 1);
+}
+
+constexpr usize value_type_size(u8 const value_type)
+{
+    constexpr usize sizes[]{0, 1, 2, 4, 8, 1, 2, 4, 8, 4, 8};
+    static_assert(size(sizes) == MeshArchive::_ValueType_Count);
+    return (value_type < MeshArchive::_ValueType_Count) ? sizes[value_type] : 0;
+}
+
+u64 header_checksum(FileHeader const& header)
+{
+    // Hash all fields preceding the header checksum
+    return hash({as<u8>(&header), isize(offsetof(FileHeader, header_checksum))});
+}
+
+FileHeader const* get_header(void const* const data)
+{
+    return static_cast<FileHeader const*>(data);
+}
+
+SectionEntry const* get_sections(void const* const data)
+{
+    return reinterpret_cast<SectionEntry const*>(static_cast<u8 const*>(data) + sizeof(FileHeader));
+}
+
+Span<u8 const> get_section_bytes(void const* const data, SectionEntry const& entry)
+{
+    return {static_cast<u8 const*>(data) + entry.offset, isize(entry.size)};
+}
+
+bool map_file(char const* const path, void const*& data, usize& size, void*& handle)
+{
+#ifdef _WIN32
+    HANDLE const file = CreateFileA(
+        path,
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL,
+        nullptr);
+
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER file_size{};
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE const mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+
+    if (mapping == nullptr)
+        return false;
+
+    void const* const ptr = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (ptr == nullptr)
+    {
+        CloseHandle(mapping);
+        return false;
+    }
+
+    data = ptr;
+    size = usize(file_size.QuadPart);
+    handle = mapping;
+    return true;
+#else
+    int const fd = ::open(path, O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat info{};
+    if (fstat(fd, &info) != 0 || info.st_size == 0)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    void* const ptr = mmap(nullptr, usize(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+
+    // NOTE: The mapping remains valid after the file descriptor is closed
+    ::close(fd);
+
+    if (ptr == MAP_FAILED)
+        return false;
+
+    data = ptr;
+    size = usize(info.st_size);
+    handle = nullptr;
+    return true;
+#endif
+}
+
+void unmap_file(void const* const data, usize const size, void* const handle)
+{
+#ifdef _WIN32
+    (void)size;
+    UnmapViewOfFile(data);
+    CloseHandle(handle);
+#else
+    (void)handle;
+    munmap(const_cast<void*>(data), size);
+#endif
+}
+
+constexpr char const* halfedge_array_names[]{
+    ".hedge_next",
+    ".hedge_prev",
+    ".hedge_vert",
+    ".hedge_face",
+    ".hedge_hole",
+    ".vert_hedge",
+    ".face_hedge",
+    ".hole_hedge",
+};
+
+} // namespace
+
+char const* MeshArchive::error_message(Error const err)
+{
+    static constexpr char const* messages[]{
+        "",
+        "Failed to open the archive file",
+        "Failed to write the archive file",
+        "The archive header is invalid",
+        "The archive version is not supported",
+        "The archive contains one or more invalid sections",
+        "The archive contains one or more sections with mismatched checksums",
+    };
+    static_assert(size(messages) == _Error_Count);
+
+    assert(err < _Error_Count);
+    return messages[err];
+}
+
+char const* MeshArchive::make_name(
+    char const* const prefix,
+    char const* const suffix,
+    char (&result)[max_name_size])
+{
+    [[maybe_unused]] int const n = std::snprintf(result, max_name_size, "%s%s", prefix, suffix);
+    assert(n >= 0 && n < max_name_size);
+    return result;
+}
+
+MeshArchive::Error MeshArchive::open(char const* const path, bool const verify_checksums)
+{
+    close();
+
+    if (!map_file(path, data_, size_, handle_))
+        return Error_OpenFailed;
+
+    auto const fail = [&](Error const err) {
+        close();
+        return err;
+    };
+
+    if (size_ < sizeof(FileHeader))
+        return fail(Error_InvalidHeader);
+
+    // Validate header
+    FileHeader const& header = *get_header(data_);
+    {
+        if (std::memcmp(header.magic, file_magic, sizeof(file_magic)) != 0
+            || header.endian_tag != file_endian_tag || header.file_size != size_
+            || header.header_checksum != header_checksum(header))
+            return fail(Error_InvalidHeader);
+
+        if (header.version > file_version)
+            return fail(Error_UnsupportedVersion);
+
+        if (header.num_sections > (size_ - sizeof(FileHeader)) / sizeof(SectionEntry))
+            return fail(Error_InvalidHeader);
+    }
+
+    // Validate section table
+    Span<SectionEntry const> const sections{get_sections(data_), isize(header.num_sections)};
+    {
+        if (hash(as<u8>(sections)) != header.table_checksum)
+            return fail(Error_ChecksumMismatch);
+
+        for (SectionEntry const& entry : sections)
+        {
+            usize const elem_size = value_type_size(entry.value_type) * entry.num_components;
+
+            if (elem_size == 0 || entry.name[max_name_size - 1] != '\0'
+                || entry.offset % section_alignment != 0 || entry.size != entry.count * elem_size
+                || entry.offset > size_ || entry.size > size_ - entry.offset)
+                return fail(Error_InvalidSection);
+
+            if (verify_checksums && hash(get_section_bytes(data_, entry)) != entry.checksum)
+                return fail(Error_ChecksumMismatch);
+        }
+    }
+
+    return Error_None;
+}
+
+void MeshArchive::close()
+{
+    if (data_ != nullptr)
+        unmap_file(data_, size_, handle_);
+
+    data_ = nullptr;
+    size_ = 0;
+    handle_ = nullptr;
+}
+
+isize MeshArchive::num_sections() const
+{
+    return is_open() ? isize(get_header(data_)->num_sections) : 0;
+}
+
+char const* MeshArchive::section_name(isize const index) const
+{
+    assert(index >= 0 && index < num_sections());
+    return get_sections(data_)[index].name;
+}
+
+void const* MeshArchive::find_bytes(
+    char const* const name,
+    ValueType const value_type,
+    u8 const num_components,
+    isize& count) const
+{
+    for (isize i = 0; i < num_sections(); ++i)
+    {
+        SectionEntry const& entry = get_sections(data_)[i];
+
+        if (std::strncmp(entry.name, name, max_name_size) == 0)
+        {
+            if (entry.value_type != value_type || entry.num_components != num_components)
+                return nullptr;
+
+            count = isize(entry.count);
+            return static_cast<u8 const*>(data_) + entry.offset;
+        }
+    }
+
+    return nullptr;
+}
+
+bool MeshArchive::read(char const* const name, HalfedgeMesh& result) const
+{
+    using Index = HalfedgeMesh::Index;
+
+    DynamicArray<Index>* const arrays[]{
+        &result.hedge_next_,
+        &result.hedge_prev_,
+        &result.hedge_vert_,
+        &result.hedge_face_,
+        &result.hedge_hole_,
+        &result.vert_hedge_,
+        &result.face_hedge_,
+        &result.hole_hedge_,
+    };
+    static_assert(size(arrays) == size(halfedge_array_names));
+
+    char buf[max_name_size];
+    Span<Index const> spans[size(arrays)];
+
+    for (isize i = 0; i < size(arrays); ++i)
+    {
+        spans[i] = find<Index>(make_name(name, halfedge_array_names[i], buf));
+        if (!spans[i].is_valid())
+            return false;
+    }
+
+    // Validate connectivity before copying so that a damaged archive can't produce a mesh which
+    // indexes out of bounds
+    {
+        auto const [he_next, he_prev, he_vert, he_face, he_hole, v_hedge, f_hedge, h_hedge] = spans;
+
+        isize const num_hedges = he_next.size();
+        if ((num_hedges & 1) != 0 || he_vert.size() != num_hedges || he_face.size() != num_hedges)
+            return false;
+
+        // Previous halfedges and holes are optional
+        if (he_prev.size() != 0 && he_prev.size() != num_hedges)
+            return false;
+
+        if (he_hole.size() == 0 ? h_hedge.size() != 0 : he_hole.size() != num_hedges)
+            return false;
+
+        constexpr Index invalid = HalfedgeMesh::invalid_index_;
+
+        // Returns true if all indices are in [0, count) or optionally invalid
+        auto const all_in_range = [](Span<Index const> const& indices,
+                                     isize const count,
+                                     bool const allow_invalid) {
+            for (Index const i : indices)
+            {
+                if ((i < 0 || i >= count) && !(allow_invalid && i == invalid))
+                    return false;
+            }
+
+            return true;
+        };
+
+        bool const indices_valid = all_in_range(he_next, num_hedges, false)
+            && all_in_range(he_prev, num_hedges, false)
+            && all_in_range(he_vert, v_hedge.size(), false)
+            && all_in_range(he_face, f_hedge.size(), true)
+            && all_in_range(he_hole, h_hedge.size(), true)
+            && all_in_range(v_hedge, num_hedges, true)
+            && all_in_range(f_hedge, num_hedges, false)
+            && all_in_range(h_hedge, num_hedges, false);
+
+        if (!indices_valid)
+            return false;
+    }
+
+    for (isize i = 0; i < size(arrays); ++i)
+        arrays[i]->assign(begin(spans[i]), end(spans[i]));
+
+    return true;
+}
+
+void MeshArchive::Writer::add_bytes(
+    char const* const name,
+    ValueType const value_type,
+    u8 const num_components,
+    isize const count,
+    Span<u8 const> const& bytes)
+{
+    assert(std::strlen(name) < max_name_size);
+
+    Section& sec = sections_.emplace_back();
+    std::strncpy(sec.name, name, max_name_size - 1);
+    sec.name[max_name_size - 1] = '\0';
+    sec.value_type = value_type;
+    sec.num_components = num_components;
+    sec.count = count;
+    sec.bytes = bytes;
+}
+
+void MeshArchive::Writer::add(char const* const name, HalfedgeMesh const& mesh)
+{
+    Span<HalfedgeMesh::Index const> const arrays[]{
+        as_span(mesh.hedge_next_),
+        as_span(mesh.hedge_prev_),
+        as_span(mesh.hedge_vert_),
+        as_span(mesh.hedge_face_),
+        as_span(mesh.hedge_hole_),
+        as_span(mesh.vert_hedge_),
+        as_span(mesh.face_hedge_),
+        as_span(mesh.hole_hedge_),
+    };
+    static_assert(size(arrays) == size(halfedge_array_names));
+
+    char buf[max_name_size];
+    for (isize i = 0; i < size(arrays); ++i)
+    {
+        // NOTE: Empty arrays are included to preserve optional connectivity (previous, holes)
+        add(make_name(name, halfedge_array_names[i], buf), arrays[i]);
+    }
+}
+
+MeshArchive::Error MeshArchive::Writer::write(char const* const path) const
+{
+    isize const num_sections = size(sections_);
+
+    FileHeader header{};
+    std::memcpy(header.magic, file_magic, sizeof(file_magic));
+    header.version = file_version;
+    header.endian_tag = file_endian_tag;
+    header.num_sections = u64(num_sections);
+
+    // Assign section offsets
+    DynamicArray<SectionEntry> entries(num_sections, allocator());
+    u64 offset = align_up(sizeof(FileHeader) + sizeof(SectionEntry) * u64(num_sections));
+
+    for (isize i = 0; i < num_sections; ++i)
+    {
+        Section const& sec = sections_[i];
+        SectionEntry& entry = entries[i];
+
+        std::memcpy(entry.name, sec.name, max_name_size);
+        entry.value_type = sec.value_type;
+        entry.num_components = sec.num_components;
+        entry.count = u64(sec.count);
+        entry.offset = offset;
+        entry.size = u64(sec.bytes.size());
+        entry.checksum = hash(sec.bytes);
+
+        offset = align_up(offset + entry.size);
+    }
+
+    header.file_size = offset;
+    header.table_checksum = hash(as<u8>(as_span(entries).as_const()));
+    header.header_checksum = header_checksum(header);
+
+    std::FILE* const file = std::fopen(path, "wb");
+    if (file == nullptr)
+        return Error_OpenFailed;
+
+    u64 num_written = 0;
+    auto const write_bytes = [&](void const* const data, u64 const size) -> bool {
+        if (size > 0 && std::fwrite(data, 1, size, file) != size)
+            return false;
+
+        num_written += size;
+        return true;
+    };
+
+    auto const write_padding = [&](u64 const target) -> bool {
+        constexpr u8 zeros[section_alignment]{};
+        assert(target - num_written <= section_alignment);
+        return write_bytes(zeros, target - num_written);
+    };
+
+    bool ok = write_bytes(&header, sizeof(header))
+        && write_bytes(entries.data(), sizeof(SectionEntry) * entries.size());
+
+    for (isize i = 0; ok && i < num_sections; ++i)
+    {
+        ok = write_padding(entries[i].offset)
+            && write_bytes(sections_[i].bytes.data(), entries[i].size);
+    }
+
+    ok = ok && write_padding(header.file_size);
+
+    if (std::fclose(file) != 0)
+        ok = false;
+
+    return ok ? Error_None : Error_WriteFailed;
+}
+
+} // namespace dr
@@ -0,0 +1,806 @@
+#include <dr/mesh_file_repair.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <string>
+
+#include <fmt/format.h>
+
+#include <dr/container_utils.hpp>
+#include <dr/dynamic_array.hpp>
+#include <dr/math_types.hpp>
+#include <dr/mesh_repair.hpp>
+#include <dr/sliced_array.hpp>
+#include <dr/span.hpp>
+
+namespace dr
+{
+namespace
+{
+
+using Error = MeshIO::Error;
+using Options = MeshFileRepair::Options;
+
+// Face corner which references a vertex
+struct CornerVertex
+{
+    i64 vertex;
+    i64 corner;
+};
+
+// Face corner along with the position of the vertex it references
+struct CornerPoint
+{
+    f64 position[3];
+    i64 corner;
+};
+
+// Welded vertex passed from a tile to its unprocessed neighbors
+struct HaloVertex
+{
+    f64 position[3];
+    i64 vertex;
+};
+
+struct Triangle
+{
+    i64 vertices[3];
+};
+
+/// Set of temporary files which records are appended to. Records are buffered in memory and
+/// written to disk once the buffer for a file is full. Files are removed on destruction.
+struct TempFiles
+{
+    TempFiles(Options const& options, char const* const name, Allocator const alloc) :
+        prefix_(fmt::format("{}/{}_{}", options.temp_dir, options.temp_prefix, name)),
+        buffer_size_(options.buffer_size),
+        buffers_(alloc),
+        on_disk_(alloc)
+    {
+    }
+
+    TempFiles(TempFiles const& other) = delete;
+    TempFiles& operator=(TempFiles const& other) = delete;
+
+    ~TempFiles()
+    {
+        for (isize i = 0; i < num_files(); ++i)
+            remove(i);
+    }
+
+    /// Returns the number of files in the set
+    isize num_files() const { return size(buffers_); }
+
+    /// Returns false if any records failed to be written to disk
+    bool ok() const { return ok_; }
+
+    /// Adds files to the set until it contains the given number
+    void reserve_files(isize const count)
+    {
+        if (count > num_files())
+        {
+            buffers_.resize(count);
+            on_disk_.resize(count, 0);
+        }
+    }
+
+    /// Appends a record to the given file
+    template <typename T>
+    void append(isize const index, T const& record)
+    {
+        DynamicArray<u8>& buf = buffers_[index];
+        u8 const* const bytes = reinterpret_cast<u8 const*>(&record);
+        buf.insert(buf.end(), bytes, bytes + sizeof(T));
+
+        if (size(buf) >= buffer_size_)
+            ok_ = flush(index) && ok_;
+    }
+
+    /// Reads all records appended to the given file
+    template <typename T>
+    bool read(isize const index, DynamicArray<T>& result)
+    {
+        if (!flush(index))
+            return false;
+
+        result.clear();
+
+        if (!on_disk_[index])
+            return true;
+
+        std::FILE* const file = std::fopen(path(index).c_str(), "rb");
+        if (file == nullptr)
+            return false;
+
+        bool ok = std::fseek(file, 0, SEEK_END) == 0;
+        long const num_bytes = ok ? std::ftell(file) : -1;
+        ok = ok && num_bytes >= 0 && num_bytes % sizeof(T) == 0
+            && std::fseek(file, 0, SEEK_SET) == 0;
+
+        if (ok)
+        {
+            usize const count = usize(num_bytes) / sizeof(T);
+            result.resize(count);
+            ok = std::fread(result.data(), sizeof(T), count, file) == count;
+        }
+
+        std::fclose(file);
+        return ok;
+    }
+
+    /// Reads records appended to the given file in chunks of at most the given size. The given
+    /// function is called with each chunk.
+    template <typename T, typename Func>
+    bool read_chunks(isize const index, isize const chunk_size, DynamicArray<T>& chunk, Func&& func)
+    {
+        if (!flush(index))
+            return false;
+
+        if (!on_disk_[index])
+            return true;
+
+        std::FILE* const file = std::fopen(path(index).c_str(), "rb");
+        if (file == nullptr)
+            return false;
+
+        chunk.resize(chunk_size);
+
+        while (true)
+        {
+            usize const count = std::fread(chunk.data(), sizeof(T), usize(chunk_size), file);
+            if (count == 0)
+                break;
+
+            func(as_span(chunk).front(isize(count)).as_const());
+        }
+
+        bool const ok = std::ferror(file) == 0;
+        std::fclose(file);
+        return ok;
+    }
+
+    /// Removes the given file along with any buffered records
+    void remove(isize const index)
+    {
+        DynamicArray<u8>& buf = buffers_[index];
+        buf.clear();
+        buf.shrink_to_fit();
+
+        if (on_disk_[index])
+        {
+            std::remove(path(index).c_str());
+            on_disk_[index] = 0;
+        }
+    }
+
+  private:
+    std::string prefix_;
+    isize buffer_size_;
+    DynamicArray<DynamicArray<u8>> buffers_;
+    DynamicArray<u8> on_disk_;
+    bool ok_{true};
+
+    std::string path(isize const index) const { return fmt::format("{}_{}.tmp", prefix_, index); }
+
+    bool flush(isize const index)
+    {
+        DynamicArray<u8>& buf = buffers_[index];
+        if (buf.empty())
+            return true;
+
+        // Files are truncated on first write in case any were left behind by a previous run
+        std::FILE* const file = std::fopen(path(index).c_str(), on_disk_[index] ? "ab" : "wb");
+        if (file == nullptr)
+            return false;
+
+        on_disk_[index] = 1;
+        bool ok = std::fwrite(buf.data(), 1, buf.size(), file) == buf.size();
+
+        if (std::fclose(file) != 0)
+            ok = false;
+
+        buf.clear();
+        return ok;
+    }
+};
+
+/// Uniform random sample of a stream of points along with the bounds of all points in the stream
+struct PointSample
+{
+    DynamicArray<Vec3<f64>> points;
+    Vec3<f64> box_min;
+    Vec3<f64> box_max;
+    isize count;
+
+    PointSample(Allocator const alloc) : points(alloc) { clear(); }
+
+    void clear()
+    {
+        points.clear();
+        box_min.setConstant(std::numeric_limits<f64>::max());
+        box_max.setConstant(std::numeric_limits<f64>::lowest());
+        count = 0;
+    }
+
+    void add(Vec3<f64> const& p)
+    {
+        // Reservoir sampling
+        if (count < max_size)
+        {
+            points.push_back(p);
+        }
+        else
+        {
+            i64 const i = std::uniform_int_distribution<i64>{0, count}(engine_);
+            if (i < max_size)
+                points[i] = p;
+        }
+
+        box_min = box_min.cwiseMin(p);
+        box_max = box_max.cwiseMax(p);
+        ++count;
+    }
+
+  private:
+    static constexpr isize max_size = isize{1} << 16;
+    std::default_random_engine engine_{};
+};
+
+/// Finds an axis-aligned plane which splits a set of points within the given bounds into two
+/// non-empty subsets. The plane is placed at the median of a sample of the points along the
+/// longest axis of the bounds. Returns false if the points are coincident.
+bool find_split(
+    Span<Vec3<f64>> const sample,
+    Vec3<f64> const& box_min,
+    Vec3<f64> const& box_max,
+    isize& axis,
+    f64& value)
+{
+    f64 const max_extent = (box_max - box_min).maxCoeff(&axis);
+    if (!(max_extent > 0.0))
+        return false;
+
+    Vec3<f64>* const mid = begin(sample) + size(sample) / 2;
+    std::nth_element(begin(sample), mid, end(sample), [&](auto const& a, auto const& b) {
+        return a[axis] < b[axis];
+    });
+
+    // Points less than the split value go to the first subset so it must be greater than the
+    // minimum. If more than half the sample shares the minimum then fall back to the midpoint.
+    f64 const lo = box_min[axis];
+    f64 const hi = box_max[axis];
+    value = (*mid)[axis];
+
+    if (!(value > lo))
+        value = 0.5 * (lo + hi);
+
+    if (!(value > lo))
+        value = hi;
+
+    return true;
+}
+
+/// Adaptive partition of space into tiles which are the leaves of a k-d tree
+struct TileTree
+{
+    struct Node
+    {
+        Vec3<f64> box_min;
+        Vec3<f64> box_max;
+        isize axis;
+        f64 split;
+        isize children;
+        isize tile;
+    };
+
+    TileTree(Vec3<f64> const& box_min, Vec3<f64> const& box_max, Allocator const alloc) :
+        nodes_(alloc), tile_nodes_(alloc)
+    {
+        nodes_.push_back({box_min, box_max, 0, 0.0, -1, 0});
+        tile_nodes_.push_back(0);
+    }
+
+    /// Returns the number of tiles including those which have been split
+    isize num_tiles() const { return size(tile_nodes_); }
+
+    /// Returns the number of tiles which haven't been split
+    isize num_leaves() const { return (size(nodes_) + 1) / 2; }
+
+    /// Returns true if the given tile has been split
+    bool is_split(isize const tile) const { return tile_nodes_[tile] < 0; }
+
+    /// Returns the tile containing the given point
+    isize find_tile(Vec3<f64> const& p) const
+    {
+        isize node = 0;
+
+        while (nodes_[node].children >= 0)
+        {
+            Node const& n = nodes_[node];
+            node = n.children + ((p[n.axis] < n.split) ? 0 : 1);
+        }
+
+        return nodes_[node].tile;
+    }
+
+    /// Splits a tile in two. Points less than the given value along the given axis belong to the
+    /// first new tile. Returns the index of the first new tile. The second follows it.
+    isize split_tile(isize const tile, isize const axis, f64 const value)
+    {
+        isize const node = tile_nodes_[tile];
+        assert(node >= 0);
+
+        isize const children = size(nodes_);
+        isize const first_tile = num_tiles();
+
+        Node left = nodes_[node];
+        left.box_max[axis] = value;
+        left.tile = first_tile;
+
+        Node right = nodes_[node];
+        right.box_min[axis] = value;
+        right.tile = first_tile + 1;
+
+        nodes_.push_back(left);
+        nodes_.push_back(right);
+        tile_nodes_.push_back(children);
+        tile_nodes_.push_back(children + 1);
+
+        Node& n = nodes_[node];
+        n.axis = axis;
+        n.split = value;
+        n.children = children;
+        n.tile = -1;
+        tile_nodes_[tile] = -1;
+
+        return first_tile;
+    }
+
+    /// Calls the given function with each tile within the given distance of a point
+    template <typename Func>
+    void for_each_tile_near(Vec3<f64> const& p, f64 const distance, Func&& func) const
+    {
+        for_each_tile_near(0, p, distance * distance, func);
+    }
+
+  private:
+    DynamicArray<Node> nodes_;
+    DynamicArray<isize> tile_nodes_;
+
+    template <typename Func>
+    void for_each_tile_near(
+        isize const node,
+        Vec3<f64> const& p,
+        f64 const sqr_distance,
+        Func& func) const
+    {
+        Node const& n = nodes_[node];
+        if ((n.box_min - p).cwiseMax(p - n.box_max).cwiseMax(0.0).squaredNorm() > sqr_distance)
+            return;
+
+        if (n.children < 0)
+        {
+            func(n.tile);
+        }
+        else
+        {
+            for_each_tile_near(n.children, p, sqr_distance, func);
+            for_each_tile_near(n.children + 1, p, sqr_distance, func);
+        }
+    }
+};
+
+/// Recursively splits a tile until the estimated number of points in each new tile is at most
+/// the given maximum. Each point in the sample stands in for the given number of points.
+void split_tile(
+    TileTree& tree,
+    isize const tile,
+    Span<Vec3<f64>> const sample,
+    f64 const points_per_sample,
+    isize const max_points)
+{
+    if (size(sample) < 2 || f64(size(sample)) * points_per_sample <= f64(max_points))
+        return;
+
+    Vec3<f64> box_min = sample[0];
+    Vec3<f64> box_max = sample[0];
+
+    for (Vec3<f64> const& p : sample)
+    {
+        box_min = box_min.cwiseMin(p);
+        box_max = box_max.cwiseMax(p);
+    }
+
+    isize axis;
+    f64 value;
+    if (!find_split(sample, box_min, box_max, axis, value))
+        return;
+
+    Vec3<f64>* const mid = std::partition(begin(sample), end(sample), [&](Vec3<f64> const& p) {
+        return p[axis] < value;
+    });
+    isize const num_left = mid - begin(sample);
+
+    isize const left = tree.split_tile(tile, axis, value);
+    split_tile(tree, left, sample.front(num_left), points_per_sample, max_points);
+    split_tile(tree, left + 1, sample.trim(num_left, 0), points_per_sample, max_points);
+}
+
+} // namespace
+
+MeshIO::Error repair_mesh_file(
+    char const* const src_path,
+    char const* const dst_path,
+    MeshFileRepair::Options const& options,
+    MeshFileRepair::Stats* const stats,
+    Allocator const alloc)
+{
+    assert(options.weld_tolerance >= 0.0);
+    assert(options.max_corners_per_tile > 0);
+    assert(options.max_vertices_per_block > 0);
+    assert(options.max_faces_per_block > 0);
+
+    isize const verts_per_block = options.max_vertices_per_block;
+    isize const corners_per_block = options.max_faces_per_block * 3;
+    f64 const tol = options.weld_tolerance;
+
+    MeshFileRepair::Stats st{};
+
+    // Read the input file. Vertex positions are written to disk in blocks and triangle corners
+    // are bucketed by the block of the vertex they reference. Vertex positions are also sampled to
+    // choose an initial set of tiles.
+    TempFiles vertex_blocks{options, "vertices", alloc};
+    TempFiles corner_vertices{options, "corner_vertices", alloc};
+    PointSample sample{alloc};
+    isize num_corners = 0;
+    {
+        MeshIO::Reader reader{alloc};
+        Error const err = reader.open(src_path, options.read_chunk_size);
+        if (err != MeshIO::Error_None)
+            return err;
+
+        MeshIO::Chunk<f64, i64> chunk{alloc};
+
+        while (reader.read(chunk, options.executor))
+        {
+            for (Vec3<f64> const& p : chunk.vertex_positions)
+            {
+                isize const block = st.num_input_vertices++ / verts_per_block;
+                vertex_blocks.reserve_files(block + 1);
+                vertex_blocks.append(block, p);
+                sample.add(p);
+            }
+
+            for (i32 f = 0; f < chunk.face_vertices.num_slices(); ++f)
+            {
+                auto const face = chunk.face_vertices[f];
+                ++st.num_input_faces;
+
+                // Triangulate as a fan
+                for (isize k = 2; k < face.size(); ++k)
+                {
+                    for (i64 const v : {face[0], face[k - 1], face[k]})
+                    {
+                        if (v < 0)
+                            return MeshIO::Error_InvalidData;
+
+                        isize const block = v / verts_per_block;
+                        corner_vertices.reserve_files(block + 1);
+                        corner_vertices.append(block, CornerVertex{v, num_corners++});
+                    }
+                }
+            }
+        }
+
+        if (reader.error() != MeshIO::Error_None)
+            return reader.error();
+    }
+
+    if (!vertex_blocks.ok() || !corner_vertices.ok())
+        return MeshIO::Error_WriteFailed;
+
+    // Faces can't reference vertices beyond the end of the file
+    if (corner_vertices.num_files() > vertex_blocks.num_files())
+        return MeshIO::Error_InvalidData;
+
+    // Split tiles at quantiles of the sampled vertex positions. Each vertex is assumed to be
+    // referenced by the same number of corners.
+    TileTree tree{sample.box_min, sample.box_max, alloc};
+    split_tile(
+        tree,
+        0,
+        as_span(sample.points),
+        f64(num_corners) / f64(std::max<isize>(sample.count, 1)),
+        options.max_corners_per_tile);
+
+    // Resolve the position of each corner one vertex block at a time and bucket corners by tile
+    TempFiles tile_points{options, "tile_points", alloc};
+    tile_points.reserve_files(tree.num_tiles());
+    DynamicArray<isize> tile_sizes{alloc};
+    tile_sizes.resize(tree.num_tiles(), 0);
+    {
+        DynamicArray<Vec3<f64>> positions{alloc};
+        DynamicArray<CornerVertex> corners{alloc};
+
+        for (isize b = 0; b < corner_vertices.num_files(); ++b)
+        {
+            if (!vertex_blocks.read(b, positions) || !corner_vertices.read(b, corners))
+                return MeshIO::Error_ReadFailed;
+
+            for (auto const& [v, c] : corners)
+            {
+                isize const i = v - b * verts_per_block;
+                if (i >= size(positions))
+                    return MeshIO::Error_InvalidData;
+
+                Vec3<f64> const& p = positions[i];
+                isize const tile = tree.find_tile(p);
+                tile_points.append(tile, CornerPoint{{p[0], p[1], p[2]}, c});
+                ++tile_sizes[tile];
+            }
+
+            vertex_blocks.remove(b);
+            corner_vertices.remove(b);
+        }
+    }
+
+    // The sample only estimates how corners are distributed so split any tiles which are still
+    // too large. New tiles are appended and split in turn if needed. Tiles which can't be split
+    // contain coincident points.
+    {
+        DynamicArray<CornerPoint> points{alloc};
+
+        for (isize t = 0; t < tree.num_tiles(); ++t)
+        {
+            if (tile_sizes[t] <= options.max_corners_per_tile)
+                continue;
+
+            sample.clear();
+            bool ok = tile_points.read_chunks(
+                t,
+                options.max_corners_per_tile,
+                points,
+                [&](Span<CornerPoint const> const chunk) {
+                    for (CornerPoint const& cp : chunk)
+                        sample.add(Vec3<f64>::Map(cp.position));
+                });
+
+            if (!ok)
+                return MeshIO::Error_ReadFailed;
+
+            isize axis;
+            f64 value;
+            if (!find_split(as_span(sample.points), sample.box_min, sample.box_max, axis, value))
+                continue;
+
+            isize const left = tree.split_tile(t, axis, value);
+            tile_points.reserve_files(tree.num_tiles());
+            tile_sizes.resize(tree.num_tiles(), 0);
+
+            ok = tile_points.read_chunks(
+                t,
+                options.max_corners_per_tile,
+                points,
+                [&](Span<CornerPoint const> const chunk) {
+                    for (CornerPoint const& cp : chunk)
+                    {
+                        isize const tile = (cp.position[axis] < value) ? left : left + 1;
+                        tile_points.append(tile, cp);
+                        ++tile_sizes[tile];
+                    }
+                });
+
+            if (!ok)
+                return MeshIO::Error_ReadFailed;
+
+            tile_points.remove(t);
+            tile_sizes[t] = 0;
+        }
+    }
+
+    if (!tile_points.ok())
+        return MeshIO::Error_WriteFailed;
+
+    st.num_tiles = tree.num_leaves();
+
+    // Weld each tile in order. Welded vertices within tolerance of an unprocessed tile are
+    // included at the front of the tile's points so that its vertices merge with them rather than
+    // creating new vertices within tolerance.
+    isize const num_corner_blocks = (num_corners + corners_per_block - 1) / corners_per_block;
+
+    TempFiles halos{options, "halos", alloc};
+    halos.reserve_files(tree.num_tiles());
+
+    TempFiles corner_ids{options, "corner_ids", alloc};
+    corner_ids.reserve_files(num_corner_blocks);
+
+    TempFiles out_vertices{options, "out_vertices", alloc};
+    {
+        DynamicArray<HaloVertex> halo{alloc};
+        DynamicArray<CornerPoint> points{alloc};
+        DynamicArray<Vec3<f64>> weld_points{alloc};
+        DynamicArray<i64> unique_points{alloc};
+        DynamicArray<i64> point_to_unique{alloc};
+        DynamicArray<i64> unique_ids{alloc};
+
+        for (isize t = 0; t < tree.num_tiles(); ++t)
+        {
+            if (tree.is_split(t))
+                continue;
+
+            if (!halos.read(t, halo))
+                return MeshIO::Error_ReadFailed;
+
+            halos.remove(t);
+
+            // Tiles which couldn't be split are welded in chunks. Vertices created by each chunk
+            // are added to the halo of the next.
+            bool const is_chunked = tile_sizes[t] > options.max_corners_per_tile;
+
+            auto const weld_chunk = [&](Span<CornerPoint const> const chunk) {
+                st.max_tile_corners = std::max(st.max_tile_corners, size(chunk));
+
+                isize const num_halo = size(halo);
+                isize const num_points = num_halo + size(chunk);
+                weld_points.resize(num_points);
+                point_to_unique.resize(num_points);
+
+                for (isize i = 0; i < num_halo; ++i)
+                    weld_points[i] = Vec3<f64>::Map(halo[i].position);
+
+                for (isize i = num_halo; i < num_points; ++i)
+                    weld_points[i] = Vec3<f64>::Map(chunk[i - num_halo].position);
+
+                find_unique_points(
+                    as_span(weld_points).as_const(),
+                    tol,
+                    unique_points,
+                    as_span(point_to_unique),
+                    options.executor,
+                    alloc);
+
+                // Assign ids to unique points owned by this tile and pass them on to unprocessed
+                // tiles as needed
+                unique_ids.resize(size(unique_points));
+
+                for (isize u = 0; u < size(unique_points); ++u)
+                {
+                    isize const i = unique_points[u];
+
+                    if (i < num_halo)
+                    {
+                        unique_ids[u] = halo[i].vertex;
+                        continue;
+                    }
+
+                    i64 const id = st.num_vertices++;
+                    Vec3<f64> const& p = weld_points[i];
+                    HaloVertex const hv{{p[0], p[1], p[2]}, id};
+                    unique_ids[u] = id;
+
+                    out_vertices.reserve_files(id / verts_per_block + 1);
+                    out_vertices.append(id / verts_per_block, p);
+
+                    tree.for_each_tile_near(p, tol, [&](isize const adj_tile) {
+                        if (adj_tile > t)
+                            halos.append(adj_tile, hv);
+                    });
+
+                    if (is_chunked)
+                        halo.push_back(hv);
+                }
+
+                for (isize i = num_halo; i < num_points; ++i)
+                {
+                    i64 const c = chunk[i - num_halo].corner;
+                    i64 const id = unique_ids[point_to_unique[i]];
+                    corner_ids.append(c / corners_per_block, CornerVertex{id, c});
+                }
+            };
+
+            if (!tile_points.read_chunks(t, options.max_corners_per_tile, points, weld_chunk))
+                return MeshIO::Error_ReadFailed;
+
+            tile_points.remove(t);
+        }
+    }
+
+    if (!halos.ok() || !corner_ids.ok() || !out_vertices.ok())
+        return MeshIO::Error_WriteFailed;
+
+    // Assemble renumbered triangles one block at a time, dropping any that became degenerate
+    TempFiles out_faces{options, "out_faces", alloc};
+    out_faces.reserve_files(num_corner_blocks);
+    {
+        DynamicArray<CornerVertex> corners{alloc};
+        DynamicArray<i64> corner_to_vertex{alloc};
+
+        for (isize b = 0; b < num_corner_blocks; ++b)
+        {
+            if (!corner_ids.read(b, corners))
+                return MeshIO::Error_ReadFailed;
+
+            corner_ids.remove(b);
+
+            isize const offset = b * corners_per_block;
+            corner_to_vertex.resize(std::min(corners_per_block, num_corners - offset));
+
+            for (auto const& [v, c] : corners)
+                corner_to_vertex[c - offset] = v;
+
+            for (isize i = 0; i < size(corner_to_vertex); i += 3)
+            {
+                Triangle const tri{{
+                    corner_to_vertex[i],
+                    corner_to_vertex[i + 1],
+                    corner_to_vertex[i + 2],
+                }};
+                auto const& [v0, v1, v2] = tri.vertices;
+
+                if (v0 != v1 && v1 != v2 && v2 != v0)
+                {
+                    out_faces.append(b, tri);
+                    ++st.num_faces;
+                }
+            }
+        }
+    }
+
+    if (!out_faces.ok())
+        return MeshIO::Error_WriteFailed;
+
+    // Write the result now that the number of vertices and faces are known
+    {
+        MeshIO::Writer writer{alloc};
+
+        Error err = writer.open<f64>(dst_path, options.format, st.num_vertices, st.num_faces);
+        if (err != MeshIO::Error_None)
+            return err;
+
+        DynamicArray<Vec3<f64>> positions{alloc};
+        for (isize b = 0; b < out_vertices.num_files(); ++b)
+        {
+            if (!out_vertices.read(b, positions))
+                return MeshIO::Error_ReadFailed;
+
+            out_vertices.remove(b);
+
+            err = writer.write_vertices(as_span(positions).as_const(), options.executor);
+            if (err != MeshIO::Error_None)
+                return err;
+        }
+
+        DynamicArray<Triangle> triangles{alloc};
+        SlicedArray<i64> face_vertices{alloc};
+
+        for (isize b = 0; b < out_faces.num_files(); ++b)
+        {
+            if (!out_faces.read(b, triangles))
+                return MeshIO::Error_ReadFailed;
+
+            out_faces.remove(b);
+
+            face_vertices.clear();
+            for (Triangle const& tri : triangles)
+                face_vertices.push_back(Span<i64 const>{tri.vertices, 3});
+
+            err = writer.write_faces(face_vertices, options.executor);
+            if (err != MeshIO::Error_None)
+                return err;
+        }
+
+        if (err = writer.close(); err != MeshIO::Error_None)
+            return err;
+    }
+
+    if (stats != nullptr)
+        *stats = st;
+
+    return MeshIO::Error_None;
+}
+
+} // namespace dr
@@ -0,0 +1,1447 @@
+#include <dr/mesh_io.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <clocale>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <string_view>
+
+#include <fmt/format.h>
+
+namespace dr
+{
+namespace
+{
+
+using Error = MeshIO::Error;
+using Format = MeshIO::Format;
+using Reader = MeshIO::Reader;
+using Writer = MeshIO::Writer;
+
+// Minimum number of bytes assigned to each thread when parsing ASCII files
+constexpr isize min_parse_block_size = isize{1} << 16;
+
+// Number of items formatted by each thread at once when writing ASCII files
+constexpr isize format_block_size = isize{1} << 15;
+
+enum PlyType : u8
+{
+    PlyType_None = 0,
+    PlyType_I8,
+    PlyType_U8,
+    PlyType_I16,
+    PlyType_U16,
+    PlyType_I32,
+    PlyType_U32,
+    PlyType_F32,
+    PlyType_F64,
+    _PlyType_Count
+};
+
+enum PlyElementKind : u8
+{
+    PlyElementKind_Other = 0,
+    PlyElementKind_Vertex,
+    PlyElementKind_Face,
+};
+
+enum PlyRole : u8
+{
+    PlyRole_None = 0,
+    PlyRole_X,
+    PlyRole_Y,
+    PlyRole_Z,
+    PlyRole_FaceVertices,
+};
+
+constexpr isize ply_type_size(u8 const type)
+{
+    constexpr isize sizes[]{0, 1, 1, 2, 2, 4, 4, 4, 8};
+    static_assert(size(sizes) == _PlyType_Count);
+    return sizes[type];
+}
+
+PlyType parse_ply_type(std::string_view const name)
+{
+    struct Entry
+    {
+        std::string_view name;
+        PlyType type;
+    };
+
+    static constexpr Entry entries[]{
+        {"char", PlyType_I8},
+        {"int8", PlyType_I8},
+        {"uchar", PlyType_U8},
+        {"uint8", PlyType_U8},
+        {"short", PlyType_I16},
+        {"int16", PlyType_I16},
+        {"ushort", PlyType_U16},
+        {"uint16", PlyType_U16},
+        {"int", PlyType_I32},
+        {"int32", PlyType_I32},
+        {"uint", PlyType_U32},
+        {"uint32", PlyType_U32},
+        {"float", PlyType_F32},
+        {"float32", PlyType_F32},
+        {"double", PlyType_F64},
+        {"float64", PlyType_F64},
+    };
+
+    for (Entry const& e : entries)
+    {
+        if (e.name == name)
+            return e.type;
+    }
+
+    return PlyType_None;
+}
+
+bool is_little_endian()
+{
+    u16 const value = 1;
+    u8 bytes[2];
+    std::memcpy(bytes, &value, sizeof(value));
+    return bytes[0] == 1;
+}
+
+template <typename T>
+T load(u8 const* const src, bool const swap)
+{
+    u8 bytes[sizeof(T)];
+    std::memcpy(bytes, src, sizeof(T));
+
+    if (swap)
+        std::reverse(bytes, bytes + sizeof(T));
+
+    T result;
+    std::memcpy(&result, bytes, sizeof(T));
+    return result;
+}
+
+template <typename T>
+void store(T const value, bool const swap, DynamicArray<u8>& dst)
+{
+    u8 bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+
+    if (swap)
+        std::reverse(bytes, bytes + sizeof(T));
+
+    dst.insert(dst.end(), bytes, bytes + sizeof(T));
+}
+
+f64 load_ply_value(u8 const* const src, u8 const type, bool const swap)
+{
+    switch (type)
+    {
+        case PlyType_I8:
+            return load<i8>(src, swap);
+        case PlyType_U8:
+            return load<u8>(src, swap);
+        case PlyType_I16:
+            return load<i16>(src, swap);
+        case PlyType_U16:
+            return load<u16>(src, swap);
+        case PlyType_I32:
+            return load<i32>(src, swap);
+        case PlyType_U32:
+            return load<u32>(src, swap);
+        case PlyType_F32:
+            return load<f32>(src, swap);
+        case PlyType_F64:
+            return load<f64>(src, swap);
+        default:
+            assert(false);
+            return 0.0;
+    }
+}
+
+bool is_digit(char const c) { return static_cast<unsigned>(c - '0') < 10; }
+
+bool is_space(char const c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+bool is_line_end(char const c) { return c == '\n' || c == '\0'; }
+
+char const* skip_space(char const* p)
+{
+    while (is_space(*p))
+        ++p;
+
+    return p;
+}
+
+char const* skip_token(char const* p)
+{
+    while (!is_space(*p) && !is_line_end(*p))
+        ++p;
+
+    return p;
+}
+
+/// Parses a decimal integer. Returns nullptr if no integer was found.
+char const* parse_int(char const* p, i64& result)
+{
+    bool const neg = (*p == '-');
+    if (neg || *p == '+')
+        ++p;
+
+    if (!is_digit(*p))
+        return nullptr;
+
+    u64 value = 0;
+    for (; is_digit(*p); ++p)
+        value = value * 10 + u64(*p - '0');
+
+    result = neg ? -i64(value) : i64(value);
+    return p;
+}
+
+/// Parses a decimal floating point number. Returns nullptr if no number was found. Numbers with
+/// at most 19 significant digits and a small exponent are converted exactly without calling into
+/// the C library.
+char const* parse_real(char const* p, f64& result)
+{
+    static constexpr f64 pow10[]{
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+    };
+    constexpr i32 max_exp = i32(size(pow10)) - 1;
+    constexpr u64 max_exact = u64{1} << 53;
+    constexpr i32 max_digits = 19;
+
+    char const* const start = p;
+
+    bool const neg = (*p == '-');
+    if (neg || *p == '+')
+        ++p;
+
+    u64 mantissa = 0;
+    i32 num_digits = 0;
+    i32 exp = 0;
+    bool exact = true;
+    bool found = false;
+
+    auto const accum_digit = [&](char const c) -> bool {
+        if (mantissa == 0 && c == '0')
+            return true;
+
+        if (num_digits == max_digits)
+        {
+            exact = false;
+            return false;
+        }
+
+        mantissa = mantissa * 10 + u64(c - '0');
+        ++num_digits;
+        return true;
+    };
+
+    // Integer part
+    for (; is_digit(*p); ++p)
+    {
+        found = true;
+        if (!accum_digit(*p))
+            ++exp;
+    }
+
+    // Fractional part
+    if (*p == '.')
+    {
+        for (++p; is_digit(*p); ++p)
+        {
+            found = true;
+            if (accum_digit(*p))
+                --exp;
+        }
+    }
+
+    if (found && (*p == 'e' || *p == 'E'))
+    {
+        i64 e;
+        if (char const* const q = parse_int(p + 1, e); q != nullptr)
+        {
+            exp += i32(std::clamp<i64>(e, -1000, 1000));
+            p = q;
+        }
+    }
+
+    if (found && exact && mantissa <= max_exact && exp >= -max_exp && exp <= max_exp)
+    {
+        f64 const value = (exp < 0) ? f64(mantissa) / pow10[-exp] : f64(mantissa) * pow10[exp];
+        result = neg ? -value : value;
+        return p;
+    }
+
+    // Fall back to the standard library for anything else (long mantissas, large exponents, inf,
+    // nan). Files always use '.' as the decimal point regardless of the current locale.
+    char const* const first = (*start == '+') ? start + 1 : start;
+    char const* const last = skip_token(first);
+
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    auto const [end, err] = std::from_chars(first, last, result);
+    return (err == std::errc{} && end != first) ? end : nullptr;
+#else
+    // Substitute the locale's decimal point before calling strtod
+    char buf[128];
+    isize const n = last - first;
+    if (n >= isize(sizeof(buf)))
+        return nullptr;
+
+    char const decimal_point = *std::localeconv()->decimal_point;
+    for (isize i = 0; i < n; ++i)
+        buf[i] = (first[i] == '.') ? decimal_point : first[i];
+
+    buf[n] = '\0';
+
+    char* end;
+    result = std::strtod(buf, &end);
+    return (end != buf) ? first + (end - buf) : nullptr;
+#endif
+}
+
+/// Splits a range of text into blocks that end on line boundaries
+void split_lines(char const* const begin, char const* const end, Span<char const*> const& result)
+{
+    isize const n = result.size() - 1;
+    result[0] = begin;
+
+    for (isize i = 1; i < n; ++i)
+    {
+        char const* const p = std::max(begin + ((end - begin) * i) / n, result[i - 1]);
+        void const* const q = std::memchr(p, '\n', end - p);
+        result[i] = (q != nullptr) ? static_cast<char const*>(q) + 1 : end;
+    }
+
+    result[n] = end;
+}
+
+template <typename Fn>
+void for_each_line(char const* const begin, char const* const end, Fn&& fn)
+{
+    for (char const* p = begin; p < end;)
+    {
+        void const* const q = std::memchr(p, '\n', end - p);
+        char const* const line_end = (q != nullptr) ? static_cast<char const*>(q) : end;
+
+        if (!fn(p))
+            return;
+
+        p = line_end + 1;
+    }
+}
+
+/// Returns true if a line contains nothing but whitespace
+bool is_blank_line(char const* const line) { return is_line_end(*skip_space(line)); }
+
+/// Returns the number of lines in a range of text which aren't blank
+isize count_nonblank_lines(char const* const begin, char const* const end)
+{
+    isize n = 0;
+    for_each_line(begin, end, [&](char const* const line) {
+        n += !is_blank_line(line);
+        return true;
+    });
+
+    return n;
+}
+
+/// Results of parsing a block of text
+template <typename Real, typename Index>
+struct TextBlock
+{
+    DynamicArray<Vec3<Real>> vertex_positions;
+    DynamicArray<Index> face_items;
+    DynamicArray<Index> face_sizes;
+
+    // Face items which are relative to the vertices preceding this block
+    DynamicArray<isize> relative_items;
+
+    // Number of non-blank lines (PLY rows) in this block
+    isize num_rows;
+    bool is_valid;
+
+    // Offsets of this block's elements within the merged result
+    isize vertex_offset;
+    isize item_offset;
+    isize face_offset;
+
+    TextBlock(Allocator const alloc) :
+        vertex_positions(alloc),
+        face_items(alloc),
+        face_sizes(alloc),
+        relative_items(alloc),
+        num_rows(0),
+        is_valid(true),
+        vertex_offset(0),
+        item_offset(0),
+        face_offset(0)
+    {
+    }
+};
+
+template <typename Real, typename Index>
+bool parse_obj_line(char const* p, TextBlock<Real, Index>& block)
+{
+    p = skip_space(p);
+
+    if (p[0] == 'v' && is_space(p[1]))
+    {
+        f64 x[3];
+        p += 1;
+
+        for (isize i = 0; i < 3; ++i)
+        {
+            p = parse_real(skip_space(p), x[i]);
+            if (p == nullptr)
+                return false;
+        }
+
+        block.vertex_positions.emplace_back(Real(x[0]), Real(x[1]), Real(x[2]));
+    }
+    else if (p[0] == 'f' && is_space(p[1]))
+    {
+        Index const num_verts = size_as<Index>(block.vertex_positions);
+        Index face_size = 0;
+
+        for (p = skip_space(p + 1); !is_line_end(*p); p = skip_space(p))
+        {
+            i64 v;
+            p = parse_int(p, v);
+            if (p == nullptr || v == 0)
+                return false;
+
+            if (v > 0)
+            {
+                block.face_items.push_back(Index(v - 1));
+            }
+            else
+            {
+                // Negative indices are relative to the most recent vertex
+                block.relative_items.push_back(size(block.face_items));
+                block.face_items.push_back(Index(num_verts + v));
+            }
+
+            // Skip any texture coordinate and normal indices
+            p = skip_token(p);
+            ++face_size;
+        }
+
+        if (face_size == 0)
+            return false;
+
+        block.face_sizes.push_back(face_size);
+    }
+
+    // Other statements are ignored
+    return true;
+}
+
+template <typename Real, typename Index, typename Property>
+bool parse_ply_line(
+    char const* p,
+    u8 const kind,
+    Span<Property const> const& props,
+    TextBlock<Real, Index>& block)
+{
+    if (kind == PlyElementKind_Other)
+        return true;
+
+    f64 x[3]{};
+    i64 face_size = -1;
+
+    for (auto const& prop : props)
+    {
+        if (prop.count_type != PlyType_None)
+        {
+            i64 count;
+            p = parse_int(skip_space(p), count);
+            if (p == nullptr || count < 0)
+                return false;
+
+            for (i64 i = 0; i < count; ++i)
+            {
+                f64 value;
+                p = parse_real(skip_space(p), value);
+                if (p == nullptr)
+                    return false;
+
+                if (prop.role == PlyRole_FaceVertices)
+                    block.face_items.push_back(Index(value));
+            }
+
+            if (prop.role == PlyRole_FaceVertices)
+                face_size = count;
+        }
+        else
+        {
+            f64 value;
+            p = parse_real(skip_space(p), value);
+            if (p == nullptr)
+                return false;
+
+            if (prop.role >= PlyRole_X && prop.role <= PlyRole_Z)
+                x[prop.role - PlyRole_X] = value;
+        }
+    }
+
+    if (kind == PlyElementKind_Vertex)
+        block.vertex_positions.emplace_back(Real(x[0]), Real(x[1]), Real(x[2]));
+    else if (face_size >= 0)
+        block.face_sizes.push_back(Index(face_size));
+
+    return true;
+}
+
+/// Returns a pointer past the end of the row or nullptr if the row extends past the end of the
+/// given range
+template <typename Index, typename Property>
+u8 const* parse_ply_row(
+    u8 const* p,
+    u8 const* const end,
+    Span<Property const> const& props,
+    bool const swap,
+    f64 (&x)[3],
+    DynamicArray<Index>& face_items,
+    bool& has_face)
+{
+    for (auto const& prop : props)
+    {
+        if (prop.count_type != PlyType_None)
+        {
+            isize const count_size = ply_type_size(prop.count_type);
+            if (end - p < count_size)
+                return nullptr;
+
+            i64 const count = i64(load_ply_value(p, prop.count_type, swap));
+            p += count_size;
+
+            isize const item_size = ply_type_size(prop.type);
+            if (count < 0 || (end - p) / item_size < count)
+                return nullptr;
+
+            if (prop.role == PlyRole_FaceVertices)
+            {
+                for (i64 i = 0; i < count; ++i, p += item_size)
+                    face_items.push_back(Index(load_ply_value(p, prop.type, swap)));
+
+                has_face = true;
+            }
+            else
+            {
+                p += count * item_size;
+            }
+        }
+        else
+        {
+            isize const item_size = ply_type_size(prop.type);
+            if (end - p < item_size)
+                return nullptr;
+
+            if (prop.role >= PlyRole_X && prop.role <= PlyRole_Z)
+                x[prop.role - PlyRole_X] = load_ply_value(p, prop.type, swap);
+
+            p += item_size;
+        }
+    }
+
+    return p;
+}
+
+/// Formats items into per-task buffers and writes them to the given file in order
+template <typename FormatItem>
+Error write_text(
+    std::FILE* const file,
+    isize const count,
+    Executor const exec,
+    Allocator const alloc,
+    FormatItem&& format_item)
+{
+    DynamicArray<DynamicArray<char>> buffers(exec.concurrency(), alloc);
+    isize const batch_size = format_block_size * size(buffers);
+
+    for (isize batch_start = 0; batch_start < count; batch_start += batch_size)
+    {
+        isize const batch_end = std::min(batch_start + batch_size, count);
+
+        auto const format_block = [&](isize const t) {
+            DynamicArray<char>& buf = buffers[t];
+            buf.clear();
+
+            isize const start = batch_start + format_block_size * t;
+            isize const end = std::min(start + format_block_size, batch_end);
+
+            for (isize i = start; i < end; ++i)
+                format_item(std::back_inserter(buf), i);
+        };
+
+        exec.run(size(buffers), format_block);
+
+        for (DynamicArray<char> const& buf : buffers)
+        {
+            if (!buf.empty() && std::fwrite(buf.data(), 1, buf.size(), file) != buf.size())
+                return MeshIO::Error_WriteFailed;
+        }
+    }
+
+    return MeshIO::Error_None;
+}
+
+} // namespace
+
+char const* MeshIO::error_message(Error const err)
+{
+    static constexpr char const* messages[]{
+        "",
+        "Failed to open the file",
+        "Failed to read from the file",
+        "Failed to write to the file",
+        "The file header is invalid or unsupported",
+        "The file contains invalid data",
+    };
+    static_assert(size(messages) == _Error_Count);
+
+    assert(err < _Error_Count);
+    return messages[err];
+}
+
+Error Reader::open(char const* const path, isize const chunk_size)
+{
+    close();
+
+    file_ = std::fopen(path, "rb");
+    if (file_ == nullptr)
+        return error_ = Error_OpenFailed;
+
+    // NOTE: The buffer has an extra byte for a null terminator which prevents parsing past the end
+    // of the last line in text files
+    chunk_size_ = std::max<isize>(chunk_size, 1024);
+    buffer_.assign(chunk_size_ + 1, 0);
+
+    if (!refill())
+        return error_ = Error_ReadFailed;
+
+    // Detect format
+    {
+        char const* const text = reinterpret_cast<char const*>(buffer_.data());
+        if (buffer_end_ >= 4 && std::memcmp(text, "ply", 3) == 0
+            && (text[3] == '\n' || text[3] == '\r'))
+        {
+            error_ = parse_ply_header();
+        }
+        else
+        {
+            format_ = Format_Obj;
+        }
+    }
+
+    return error_;
+}
+
+void Reader::close()
+{
+    if (file_ != nullptr)
+        std::fclose(file_);
+
+    file_ = nullptr;
+    buffer_start_ = buffer_end_ = 0;
+    at_eof_ = false;
+    format_ = Format_Unknown;
+    error_ = Error_None;
+    num_vertices_read_ = 0;
+    ply_elements_.clear();
+    ply_properties_.clear();
+    ply_row_ = 0;
+}
+
+isize Reader::num_vertices_hint() const
+{
+    for (PlyElement const& elem : ply_elements_)
+    {
+        if (elem.kind == PlyElementKind_Vertex)
+            return elem.count;
+    }
+
+    return -1;
+}
+
+isize Reader::num_faces_hint() const
+{
+    for (PlyElement const& elem : ply_elements_)
+    {
+        if (elem.kind == PlyElementKind_Face)
+            return elem.count;
+    }
+
+    return -1;
+}
+
+bool Reader::refill()
+{
+    // Move any unconsumed bytes to the front of the buffer
+    isize const n = buffer_end_ - buffer_start_;
+    if (buffer_start_ > 0)
+    {
+        std::memmove(buffer_.data(), buffer_.data() + buffer_start_, n);
+        buffer_start_ = 0;
+        buffer_end_ = n;
+    }
+
+    isize const capacity = size(buffer_) - 1;
+    if (!at_eof_ && buffer_end_ < capacity)
+    {
+        usize const count = capacity - buffer_end_;
+        usize const num_read = std::fread(buffer_.data() + buffer_end_, 1, count, file_);
+        buffer_end_ += num_read;
+
+        if (num_read < count)
+        {
+            if (std::ferror(file_))
+                return false;
+
+            at_eof_ = true;
+        }
+    }
+
+    buffer_[buffer_end_] = 0;
+    return true;
+}
+
+void Reader::grow()
+{
+    chunk_size_ *= 2;
+    buffer_.resize(chunk_size_ + 1);
+}
+
+Error Reader::parse_ply_header()
+{
+    // Ensure the entire header is in the buffer
+    char const* header_end = nullptr;
+    while (true)
+    {
+        char const* const text = reinterpret_cast<char const*>(buffer_.data());
+        char const* const p = std::strstr(text, "\nend_header");
+
+        if (p != nullptr)
+        {
+            char const* const q = std::strchr(p + 1, '\n');
+            if (q != nullptr)
+            {
+                header_end = q + 1;
+                break;
+            }
+        }
+
+        if (at_eof_)
+            return Error_InvalidHeader;
+
+        grow();
+        if (!refill())
+            return Error_ReadFailed;
+    }
+
+    char const* const text = reinterpret_cast<char const*>(buffer_.data());
+    bool found_format = false;
+    i64 row_end = 0;
+
+    for (char const* p = text; p < header_end;)
+    {
+        char const* const line_end = std::strchr(p, '\n');
+
+        // Split line into whitespace-separated tokens
+        std::string_view tokens[6];
+        isize num_tokens = 0;
+
+        for (p = skip_space(p); p < line_end && num_tokens < size(tokens); p = skip_space(p))
+        {
+            char const* const token_end = skip_token(p);
+            tokens[num_tokens++] = {p, usize(token_end - p)};
+            p = token_end;
+        }
+
+        p = line_end + 1;
+
+        if (num_tokens == 0)
+            continue;
+
+        std::string_view const keyword = tokens[0];
+
+        if (keyword == "format")
+        {
+            if (num_tokens < 2)
+                return Error_InvalidHeader;
+
+            if (tokens[1] == "ascii")
+                format_ = Format_PlyAscii;
+            else if (tokens[1] == "binary_little_endian")
+                format_ = Format_PlyBinaryLE;
+            else if (tokens[1] == "binary_big_endian")
+                format_ = Format_PlyBinaryBE;
+            else
+                return Error_InvalidHeader;
+
+            found_format = true;
+        }
+        else if (keyword == "element")
+        {
+            i64 count;
+            if (num_tokens < 3 || parse_int(tokens[2].data(), count) == nullptr || count < 0)
+                return Error_InvalidHeader;
+
+            PlyElement& elem = ply_elements_.emplace_back();
+            elem.kind = PlyElementKind_Other;
+            elem.property_start = elem.property_end = i32(size(ply_properties_));
+            elem.count = count;
+            elem.row_end = (row_end += count);
+
+            if (tokens[1] == "vertex")
+                elem.kind = PlyElementKind_Vertex;
+            else if (tokens[1] == "face")
+                elem.kind = PlyElementKind_Face;
+        }
+        else if (keyword == "property")
+        {
+            if (ply_elements_.empty())
+                return Error_InvalidHeader;
+
+            PlyElement& elem = ply_elements_.back();
+            PlyProperty& prop = ply_properties_.emplace_back();
+            prop.role = PlyRole_None;
+            ++elem.property_end;
+
+            std::string_view name;
+            if (num_tokens == 5 && tokens[1] == "list")
+            {
+                prop.count_type = parse_ply_type(tokens[2]);
+                prop.type = parse_ply_type(tokens[3]);
+                name = tokens[4];
+
+                if (prop.count_type == PlyType_None || prop.count_type >= PlyType_F32)
+                    return Error_InvalidHeader;
+
+                if (elem.kind == PlyElementKind_Face
+                    && (name == "vertex_indices" || name == "vertex_index"))
+                    prop.role = PlyRole_FaceVertices;
+            }
+            else if (num_tokens == 3)
+            {
+                prop.count_type = PlyType_None;
+                prop.type = parse_ply_type(tokens[1]);
+                name = tokens[2];
+
+                if (elem.kind == PlyElementKind_Vertex && name.size() == 1
+                    && name[0] >= 'x' && name[0] <= 'z')
+                    prop.role = u8(PlyRole_X + (name[0] - 'x'));
+            }
+            else
+            {
+                return Error_InvalidHeader;
+            }
+
+            if (prop.type == PlyType_None)
+                return Error_InvalidHeader;
+        }
+        else if (keyword == "end_header")
+        {
+            break;
+        }
+
+        // Other keywords (ply, comment, obj_info) are ignored
+    }
+
+    if (!found_format)
+        return Error_InvalidHeader;
+
+    // Validate elements
+    for (PlyElement& elem : ply_elements_)
+    {
+        u8 roles{};
+        for (i32 i = elem.property_start; i < elem.property_end; ++i)
+            roles |= u8(1 << ply_properties_[i].role);
+
+        if (elem.kind == PlyElementKind_Vertex)
+        {
+            constexpr u8 required = (1 << PlyRole_X) | (1 << PlyRole_Y) | (1 << PlyRole_Z);
+            if ((roles & required) != required)
+                return Error_InvalidHeader;
+        }
+        else if (elem.kind == PlyElementKind_Face)
+        {
+            // Faces without vertex indices are skipped
+            if ((roles & (1 << PlyRole_FaceVertices)) == 0)
+                elem.kind = PlyElementKind_Other;
+        }
+    }
+
+    buffer_start_ = header_end - text;
+    return Error_None;
+}
+
+template <typename Real, typename Index>
+bool Reader::read(Chunk<Real, Index>& result, Executor const exec)
+{
+    result.clear();
+
+    if (file_ == nullptr || error_ != Error_None)
+        return false;
+
+    if (format_ == Format_PlyBinaryLE || format_ == Format_PlyBinaryBE)
+        return read_binary(result, exec);
+    else
+        return read_text(result, exec);
+}
+
+template <typename Real, typename Index>
+bool Reader::read_text(Chunk<Real, Index>& result, Executor const exec)
+{
+    using Block = TextBlock<Real, Index>;
+
+    bool const is_obj = (format_ == Format_Obj);
+    i64 const num_rows = ply_elements_.empty() ? 0 : ply_elements_.back().row_end;
+
+    while (true)
+    {
+        if (!is_obj && ply_row_ >= num_rows)
+            return false;
+
+        if (!refill())
+        {
+            error_ = Error_ReadFailed;
+            return false;
+        }
+
+        char const* const begin = reinterpret_cast<char const*>(buffer_.data());
+        char const* end = begin + buffer_end_;
+
+        if (begin == end)
+            return false;
+
+        // Only parse complete lines unless the end of the file has been reached
+        if (!at_eof_)
+        {
+            auto const last = std::find(
+                std::make_reverse_iterator(end),
+                std::make_reverse_iterator(begin),
+                '\n');
+
+            if (last.base() == begin)
+            {
+                // Line doesn't fit in the buffer
+                grow();
+                continue;
+            }
+
+            end = last.base();
+        }
+
+        buffer_start_ = end - begin;
+
+        // Split text into blocks which are parsed independently
+        isize const num_blocks = std::clamp<isize>(
+            (end - begin) / min_parse_block_size,
+            1,
+            exec.concurrency());
+
+        DynamicArray<Block> blocks{allocator()};
+        blocks.reserve(num_blocks);
+
+        for (isize i = 0; i < num_blocks; ++i)
+            blocks.emplace_back(allocator());
+
+        DynamicArray<char const*> bounds(num_blocks + 1, allocator());
+        split_lines(begin, end, as_span(bounds));
+
+        auto const parse_block = [&](isize const i) {
+            Block& block = blocks[i];
+
+            if (is_obj)
+            {
+                for_each_line(bounds[i], bounds[i + 1], [&](char const* const line) {
+                    return block.is_valid = parse_obj_line(line, block);
+                });
+            }
+            else
+            {
+                // PLY rows are assigned to elements by line number
+                i64 row = ply_row_;
+                for (isize j = 0; j < i; ++j)
+                    row += blocks[j].num_rows;
+
+                isize elem = 0;
+                for_each_line(bounds[i], bounds[i + 1], [&](char const* const line) {
+                    // Blank lines don't count as rows
+                    if (is_blank_line(line))
+                        return true;
+
+                    // Ignore anything after the last element
+                    if (row >= num_rows)
+                        return false;
+
+                    while (row >= ply_elements_[elem].row_end)
+                        ++elem;
+
+                    PlyElement const& e = ply_elements_[elem];
+                    Span<PlyProperty const> const props{
+                        ply_properties_.data() + e.property_start,
+                        e.property_end - e.property_start};
+
+                    ++row;
+                    return block.is_valid = parse_ply_line(line, e.kind, props, block);
+                });
+            }
+        };
+
+        auto const merge_block = [&](isize const i) {
+            Block& block = blocks[i];
+
+            std::copy(
+                block.vertex_positions.begin(),
+                block.vertex_positions.end(),
+                result.vertex_positions.begin() + block.vertex_offset);
+
+            std::copy(
+                block.face_items.begin(),
+                block.face_items.end(),
+                result.face_vertices.items.begin() + block.item_offset);
+
+            // Resolve relative indices
+            Index const offset = Index(num_vertices_read_ + block.vertex_offset);
+            for (isize const j : block.relative_items)
+            {
+                Index& v = result.face_vertices.items[block.item_offset + j];
+                if ((v += offset) < 0)
+                    block.is_valid = false;
+            }
+
+            auto& slice_ends = result.face_vertices.slice_ends;
+            using SliceIndex = typename std::decay_t<decltype(slice_ends)>::value_type;
+
+            SliceIndex slice_end = SliceIndex(block.item_offset);
+            for (isize j = 0; j < size(block.face_sizes); ++j)
+                slice_ends[block.face_offset + j] = (slice_end += SliceIndex(block.face_sizes[j]));
+        };
+
+        // Assigns block offsets and sizes the result. Returns false if any blocks are invalid.
+        auto const prepare_merge = [&]() -> bool {
+            isize num_verts = 0;
+            isize num_items = 0;
+            isize num_faces = 0;
+
+            for (Block& block : blocks)
+            {
+                if (!block.is_valid)
+                    return false;
+
+                block.vertex_offset = num_verts;
+                block.item_offset = num_items;
+                block.face_offset = num_faces;
+
+                num_verts += size(block.vertex_positions);
+                num_items += size(block.face_items);
+                num_faces += size(block.face_sizes);
+            }
+
+            result.vertex_positions.resize(num_verts);
+            result.face_vertices.items.resize(num_items);
+            result.face_vertices.slice_ends.resize(num_faces);
+            return true;
+        };
+
+        if (!is_obj)
+        {
+            // PLY blocks need the row counts of preceding blocks to assign rows to elements
+            exec.run(num_blocks, [&](isize const i) {
+                blocks[i].num_rows = count_nonblank_lines(bounds[i], bounds[i + 1]);
+            });
+        }
+
+        exec.run(num_blocks, parse_block);
+
+        bool is_valid = prepare_merge();
+
+        if (is_valid)
+            exec.run(num_blocks, merge_block);
+
+        for (Block const& block : blocks)
+        {
+            is_valid &= block.is_valid;
+            num_vertices_read_ += size(block.vertex_positions);
+            ply_row_ += block.num_rows;
+        }
+
+        if (!is_valid)
+        {
+            error_ = Error_InvalidData;
+            return false;
+        }
+
+        if (!result.empty())
+            return true;
+    }
+}
+
+template <typename Real, typename Index>
+bool Reader::read_binary(Chunk<Real, Index>& result, Executor const exec)
+{
+    bool const swap = (format_ == Format_PlyBinaryLE) != is_little_endian();
+    isize elem = 0;
+
+    while (true)
+    {
+        while (elem < size(ply_elements_) && ply_row_ >= ply_elements_[elem].row_end)
+            ++elem;
+
+        if (elem == size(ply_elements_))
+            return !result.empty();
+
+        PlyElement const& e = ply_elements_[elem];
+        Span<PlyProperty const> const props{
+            ply_properties_.data() + e.property_start,
+            e.property_end - e.property_start};
+
+        u8 const* const begin = buffer_.data() + buffer_start_;
+        u8 const* const end = buffer_.data() + buffer_end_;
+        i64 const max_rows = e.row_end - ply_row_;
+
+        // Rows of elements without list properties have a fixed size
+        isize stride = 0;
+        for (PlyProperty const& prop : props)
+        {
+            if (prop.count_type != PlyType_None)
+            {
+                stride = 0;
+                break;
+            }
+
+            stride += ply_type_size(prop.type);
+        }
+
+        u8 const* p = begin;
+        i64 num_rows = 0;
+
+        if (stride > 0)
+        {
+            num_rows = std::min<i64>(max_rows, (end - begin) / stride);
+
+            if (e.kind == PlyElementKind_Vertex)
+            {
+                isize const offset = size(result.vertex_positions);
+                result.vertex_positions.resize(offset + num_rows);
+
+                auto const parse_vertex = [&](isize const i) {
+                    f64 x[3]{};
+                    bool has_face;
+
+                    // NOTE: Face items aren't modified since vertex rows contain no lists
+                    parse_ply_row(
+                        begin + i * stride,
+                        end,
+                        props,
+                        swap,
+                        x,
+                        result.face_vertices.items,
+                        has_face);
+
+                    result.vertex_positions[offset + i] = {Real(x[0]), Real(x[1]), Real(x[2])};
+                };
+
+                exec.parallel_for(num_rows, parse_vertex);
+            }
+
+            p += num_rows * stride;
+        }
+        else
+        {
+            auto& face_verts = result.face_vertices;
+
+            for (; num_rows < max_rows; ++num_rows)
+            {
+                f64 x[3]{};
+                bool has_face = false;
+                isize const num_items = size(face_verts.items);
+
+                u8 const* const next =
+                    parse_ply_row(p, end, props, swap, x, face_verts.items, has_face);
+                if (next == nullptr)
+                {
+                    // Discard items from the incomplete row
+                    face_verts.items.resize(num_items);
+                    break;
+                }
+
+                if (e.kind == PlyElementKind_Vertex)
+                    result.vertex_positions.emplace_back(Real(x[0]), Real(x[1]), Real(x[2]));
+                else if (has_face)
+                    face_verts.slice_ends.push_back(face_verts.num_items());
+
+                p = next;
+            }
+        }
+
+        buffer_start_ += p - begin;
+        ply_row_ += num_rows;
+
+        if (num_rows > 0)
+            continue;
+
+        // The buffer doesn't contain a complete row
+        if (!result.empty())
+            return true;
+
+        if (at_eof_)
+        {
+            error_ = Error_InvalidData;
+            return false;
+        }
+
+        // Row doesn't fit in the buffer
+        if (buffer_start_ == 0 && buffer_end_ == chunk_size_)
+            grow();
+
+        if (!refill())
+        {
+            error_ = Error_ReadFailed;
+            return false;
+        }
+    }
+}
+
+Error Writer::open_impl(
+    char const* const path,
+    Format const format,
+    u8 const real_size,
+    isize const num_vertices,
+    isize const num_faces)
+{
+    assert(format > Format_Unknown && format < _Format_Count);
+    close();
+
+    file_ = std::fopen(path, "wb");
+    if (file_ == nullptr)
+        return Error_OpenFailed;
+
+    format_ = format;
+    real_size_ = real_size;
+    num_vertices_ = num_vertices;
+    num_vertices_written_ = 0;
+    num_faces_ = num_faces;
+    num_faces_written_ = 0;
+
+    if (format == Format_Obj)
+        return Error_None;
+
+    // Write PLY header
+    char const* const format_name = (format == Format_PlyAscii)    ? "ascii"
+                                    : (format == Format_PlyBinaryLE) ? "binary_little_endian"
+                                                                     : "binary_big_endian";
+
+    char const* const real_name = (real_size == sizeof(f32)) ? "float" : "double";
+
+    fmt::memory_buffer buf;
+    fmt::format_to(
+        std::back_inserter(buf),
+        "ply\n"
+        "format {} 1.0\n"
+        "element vertex {}\n"
+        "property {} x\n"
+        "property {} y\n"
+        "property {} z\n"
+        "element face {}\n"
+        "property list uchar int vertex_indices\n"
+        "end_header\n",
+        format_name,
+        num_vertices,
+        real_name,
+        real_name,
+        real_name,
+        num_faces);
+
+    return write_bytes(buf.data(), size(buf));
+}
+
+Error Writer::close()
+{
+    if (file_ == nullptr)
+        return Error_None;
+
+    bool ok = (std::fclose(file_) == 0);
+    file_ = nullptr;
+
+    // PLY files must contain the number of elements declared in the header
+    if (format_ != Format_Obj)
+        ok &= (num_vertices_written_ == num_vertices_ && num_faces_written_ == num_faces_);
+
+    return ok ? Error_None : Error_WriteFailed;
+}
+
+Error Writer::write_bytes(void const* const data, isize const size)
+{
+    assert(file_ != nullptr);
+
+    if (size > 0 && std::fwrite(data, 1, size, file_) != usize(size))
+        return Error_WriteFailed;
+
+    return Error_None;
+}
+
+template <typename Real>
+Error Writer::write_vertices(
+    Span<Vec3<Real> const> const& vertex_positions,
+    Executor const exec)
+{
+    assert(file_ != nullptr);
+    assert(num_faces_written_ == 0);
+    isize const n = vertex_positions.size();
+
+    switch (format_)
+    {
+        case Format_Obj:
+        {
+            return write_text(file_, n, exec, allocator(), [&](auto out, isize const i) {
+                Vec3<Real> const& p = vertex_positions[i];
+                fmt::format_to(out, "v {} {} {}\n", p[0], p[1], p[2]);
+            });
+        }
+        case Format_PlyAscii:
+        {
+            assert(num_vertices_written_ + n <= num_vertices_);
+            num_vertices_written_ += n;
+
+            return write_text(file_, n, exec, allocator(), [&](auto out, isize const i) {
+                Vec3<Real> const& p = vertex_positions[i];
+                fmt::format_to(out, "{} {} {}\n", p[0], p[1], p[2]);
+            });
+        }
+        default:
+        {
+            assert(sizeof(Real) == real_size_);
+            assert(num_vertices_written_ + n <= num_vertices_);
+            num_vertices_written_ += n;
+
+            bool const swap = (format_ == Format_PlyBinaryLE) != is_little_endian();
+            if (!swap)
+                return write_bytes(vertex_positions.data(), n * sizeof(Vec3<Real>));
+
+            for (isize i = 0; i < n; i += format_block_size)
+            {
+                buffer_.clear();
+
+                for (isize j = i; j < std::min(i + format_block_size, n); ++j)
+                {
+                    for (isize k = 0; k < 3; ++k)
+                        store(vertex_positions[j][k], swap, buffer_);
+                }
+
+                if (Error const err = write_bytes(buffer_.data(), size(buffer_)); err != Error_None)
+                    return err;
+            }
+
+            return Error_None;
+        }
+    }
+}
+
+template <typename Index>
+Error Writer::write_faces(SlicedArray<Index> const& face_vertices, Executor const exec)
+{
+    assert(file_ != nullptr);
+    isize const n = face_vertices.num_slices();
+
+    switch (format_)
+    {
+        case Format_Obj:
+        {
+            return write_text(file_, n, exec, allocator(), [&](auto out, isize const i) {
+                *out++ = 'f';
+                for (Index const v : face_vertices[i])
+                    fmt::format_to(out, " {}", i64(v) + 1);
+
+                *out++ = '\n';
+            });
+        }
+        case Format_PlyAscii:
+        {
+            assert(num_faces_written_ + n <= num_faces_);
+            num_faces_written_ += n;
+
+            return write_text(file_, n, exec, allocator(), [&](auto out, isize const i) {
+                auto const face = face_vertices[i];
+                fmt::format_to(out, "{}", face.size());
+
+                for (Index const v : face)
+                    fmt::format_to(out, " {}", i64(v));
+
+                *out++ = '\n';
+            });
+        }
+        default:
+        {
+            assert(num_faces_written_ + n <= num_faces_);
+
+            // Face sizes are written as a single byte
+            for (isize i = 0; i < n; ++i)
+            {
+                if (face_vertices[i].size() > 255)
+                    return Error_InvalidData;
+            }
+
+            num_faces_written_ += n;
+            bool const swap = (format_ == Format_PlyBinaryLE) != is_little_endian();
+
+            for (isize i = 0; i < n; i += format_block_size)
+            {
+                buffer_.clear();
+
+                for (isize j = i; j < std::min(i + format_block_size, n); ++j)
+                {
+                    auto const face = face_vertices[j];
+                    buffer_.push_back(u8(face.size()));
+
+                    for (Index const v : face)
+                        store(i32(v), swap, buffer_);
+                }
+
+                if (Error const err = write_bytes(buffer_.data(), size(buffer_)); err != Error_None)
+                    return err;
+            }
+
+            return Error_None;
+        }
+    }
+}
+
+// Explicit template instantiation
+
+#define DR_TEMPLATE(Real, Index)                                                                   \
+    template bool Reader::read(Chunk<Real, Index>& result, Executor exec);
+
+DR_TEMPLATE(f32, i32)
+DR_TEMPLATE(f32, i64)
+DR_TEMPLATE(f64, i32)
+DR_TEMPLATE(f64, i64)
+
+#undef DR_TEMPLATE
+
+#define DR_TEMPLATE(Real)                                                                          \
+    template Error Writer::write_vertices(                                                         \
+        Span<Vec3<Real> const> const& vertex_positions,                                            \
+        Executor exec);
+
+DR_TEMPLATE(f32)
+DR_TEMPLATE(f64)
+
+#undef DR_TEMPLATE
+
+#define DR_TEMPLATE(Index)                                                                         \
+    template Error Writer::write_faces(                                                            \
+        SlicedArray<Index> const& face_vertices,                                                   \
+        Executor exec);
+
+DR_TEMPLATE(i32)
+DR_TEMPLATE(i64)
+
+#undef DR_TEMPLATE
+
+} // namespace dr
@@ -0,0 +1,196 @@
+#include <utest.h>
+
+#include <algorithm>
+#include <numeric>
+
+#include <dr/algorithms.hpp>
+#include <dr/container_utils.hpp>
+#include <dr/dynamic_array.hpp>
+#include <dr/random.hpp>
+
+UTEST(algorithms, inclusive_scan)
+{
+    using namespace dr;
+
+    Random<> rand{1};
+    auto gen = rand.generator<i32>(0, 10);
+
+    for (isize const n : {0, 1, 7, 1000})
+    {
+        DynamicArray<i32> values(n);
+        for (i32& v : values)
+            v = gen();
+
+        DynamicArray<i32> expect(n);
+        std::inclusive_scan(values.begin(), values.end(), expect.begin());
+
+        for (isize const num_threads : {1, 4})
+        {
+            DynamicArray<i32> result(n);
+            inclusive_scan(as_span(values).as_const(), as_span(result), Executor{num_threads});
+
+            for (isize i = 0; i < n; ++i)
+                ASSERT_EQ(expect[i], result[i]);
+
+            // In-place
+            result = values;
+            inclusive_scan(as_span(result).as_const(), as_span(result), Executor{num_threads});
+
+            for (isize i = 0; i < n; ++i)
+                ASSERT_EQ(expect[i], result[i]);
+        }
+    }
+}
+
+UTEST(algorithms, exclusive_scan)
+{
+    using namespace dr;
+
+    Random<> rand{2};
+    auto gen = rand.generator<i64>(0, 10);
+
+    for (isize const n : {0, 1, 7, 1000})
+    {
+        DynamicArray<i64> values(n);
+        for (i64& v : values)
+            v = gen();
+
+        DynamicArray<i64> expect(n);
+        std::exclusive_scan(values.begin(), values.end(), expect.begin(), i64{0});
+        i64 const total = std::accumulate(values.begin(), values.end(), i64{0});
+
+        for (isize const num_threads : {1, 4})
+        {
+            DynamicArray<i64> result = values;
+            ASSERT_EQ(
+                total,
+                exclusive_scan(as_span(result).as_const(), as_span(result), Executor{num_threads}));
+
+            for (isize i = 0; i < n; ++i)
+                ASSERT_EQ(expect[i], result[i]);
+        }
+    }
+}
+
+UTEST(algorithms, radix_sort)
+{
+    using namespace dr;
+
+    Random<> rand{3};
+    auto gen_high = rand.generator<u32>(0, ~u32{0});
+    auto gen_low = rand.generator<u32>(0, 100);
+
+    for (isize const n : {0, 1, 10, 1000})
+    {
+        for (bool const low : {false, true})
+        {
+            DynamicArray<u32> keys(n);
+            for (u32& k : keys)
+                k = low ? gen_low() : gen_high();
+
+            // Values record the original index of each key to check stability
+            DynamicArray<std::pair<u32, i32>> expect(n);
+            for (isize i = 0; i < n; ++i)
+                expect[i] = {keys[i], i32(i)};
+
+            std::stable_sort(expect.begin(), expect.end(), [](auto const& a, auto const& b) {
+                return a.first < b.first;
+            });
+
+            for (isize const num_threads : {1, 4})
+            {
+                DynamicArray<u32> result_keys = keys;
+                DynamicArray<i32> result_values(n);
+                std::iota(result_values.begin(), result_values.end(), 0);
+
+                radix_sort(as_span(result_keys), as_span(result_values), Executor{num_threads});
+
+                for (isize i = 0; i < n; ++i)
+                {
+                    ASSERT_EQ(expect[i].first, result_keys[i]);
+                    ASSERT_EQ(expect[i].second, result_values[i]);
+                }
+
+                // Keys only
+                result_keys = keys;
+                radix_sort(as_span(result_keys), Executor{num_threads});
+
+                for (isize i = 0; i < n; ++i)
+                    ASSERT_EQ(expect[i].first, result_keys[i]);
+            }
+        }
+    }
+}
+
+UTEST(algorithms, radix_sort_permutation)
+{
+    using namespace dr;
+
+    Random<> rand{4};
+    auto gen_high = rand.generator<u64>(0, ~u64{0});
+    auto gen_low = rand.generator<u64>(0, 100);
+
+    for (isize const n : {0, 1, 10, 1000})
+    {
+        for (bool const low : {false, true})
+        {
+            // Low keys have many duplicates and only vary in their lowest byte
+            DynamicArray<u64> keys(n);
+            for (u64& k : keys)
+                k = low ? gen_low() : gen_high();
+
+            DynamicArray<i32> expect(n);
+            std::iota(expect.begin(), expect.end(), 0);
+            std::stable_sort(expect.begin(), expect.end(), [&](i32 const a, i32 const b) {
+                return keys[a] < keys[b];
+            });
+
+            for (isize const num_threads : {1, 4})
+            {
+                DynamicArray<i32> result(n);
+                radix_sort_permutation(
+                    as_span(keys).as_const(),
+                    as_span(result),
+                    Executor{num_threads});
+
+                for (isize i = 0; i < n; ++i)
+                    ASSERT_EQ(expect[i], result[i]);
+            }
+        }
+    }
+}
+
+UTEST(algorithms, partition)
+{
+    using namespace dr;
+
+    Random<> rand{5};
+    auto gen = rand.generator<i32>(-100, 100);
+
+    for (isize const n : {0, 1, 10, 1000})
+    {
+        DynamicArray<i32> values(n);
+        for (i32& v : values)
+            v = gen();
+
+        auto const is_even = [](i32 const v) { return v % 2 == 0; };
+
+        DynamicArray<i32> expect = values;
+        auto const mid = std::stable_partition(expect.begin(), expect.end(), is_even);
+
+        for (isize const num_threads : {1, 4})
+        {
+            DynamicArray<i32> result(n);
+            isize const num_accepted = partition(
+                as_span(values).as_const(),
+                is_even,
+                as_span(result),
+                Executor{num_threads});
+
+            ASSERT_EQ(isize(mid - expect.begin()), num_accepted);
+
+            for (isize i = 0; i < n; ++i)
+                ASSERT_EQ(expect[i], result[i]);
+        }
+    }
+}
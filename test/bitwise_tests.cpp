@@ -1,5 +1,7 @@
 #include <utest.h>
 
+#include <cstdlib>
+
 #include <dr/bitwise.hpp>
 
 UTEST(bitwise, bit_sum)
@@ -71,3 +73,154 @@ UTEST(bitwise, prev_pow2)
         ASSERT_EQ(x >> 1, prev_pow2(x - 1));
     }
 }
+
+UTEST(bitwise, log2_floor)
+{
+    using namespace dr;
+
+    ASSERT_EQ(0u, log2_floor(1u));
+    ASSERT_EQ(1u, log2_floor(2u));
+    ASSERT_EQ(1u, log2_floor(3u));
+    ASSERT_EQ(2u, log2_floor(4u));
+
+    for (u8 i = 1; i < 63; ++i)
+    {
+        u64 const x = u64{1} << i;
+        ASSERT_EQ(i, log2_floor(x));
+        ASSERT_EQ(i, log2_floor(x + 1));
+        ASSERT_EQ(i - 1, log2_floor(x - 1));
+    }
+}
+
+UTEST(bitwise, trailing_zeros)
+{
+    using namespace dr;
+
+    ASSERT_EQ(0u, trailing_zeros(1u));
+    ASSERT_EQ(1u, trailing_zeros(2u));
+    ASSERT_EQ(0u, trailing_zeros(3u));
+    ASSERT_EQ(2u, trailing_zeros(12u));
+
+    for (u8 i = 0; i < 64; ++i)
+    {
+        u64 const x = u64{1} << i;
+        ASSERT_EQ(i, trailing_zeros(x));
+        ASSERT_EQ(i, trailing_zeros(x | (x << 1)));
+    }
+}
+
+UTEST(bitwise, morton_encode)
+{
+    using namespace dr;
+
+    ASSERT_EQ(0u, morton_encode(0, 0, 0));
+    ASSERT_EQ(1u, morton_encode(1, 0, 0));
+    ASSERT_EQ(2u, morton_encode(0, 1, 0));
+    ASSERT_EQ(4u, morton_encode(0, 0, 1));
+    ASSERT_EQ(7u, morton_encode(1, 1, 1));
+    ASSERT_EQ(8u, morton_encode(2, 0, 0));
+    ASSERT_EQ(~u64{0} >> 1, morton_encode(0x1fffff, 0x1fffff, 0x1fffff));
+
+    u32 const coords[][3]{
+        {0, 0, 0},
+        {1, 2, 3},
+        {7, 7, 7},
+        {1000, 20, 300000},
+        {0x1fffff, 0, 0x1fffff},
+    };
+
+    for (auto const& c : coords)
+    {
+        u32 result[3];
+        morton_decode(morton_encode(c[0], c[1], c[2]), result);
+        ASSERT_EQ(c[0], result[0]);
+        ASSERT_EQ(c[1], result[1]);
+        ASSERT_EQ(c[2], result[2]);
+    }
+}
+
+UTEST(bitwise, morton_encode_2d)
+{
+    using namespace dr;
+
+    ASSERT_EQ(0u, morton_encode(0, 0));
+    ASSERT_EQ(1u, morton_encode(1, 0));
+    ASSERT_EQ(2u, morton_encode(0, 1));
+    ASSERT_EQ(3u, morton_encode(1, 1));
+    ASSERT_EQ(4u, morton_encode(2, 0));
+    ASSERT_EQ(~u64{0}, morton_encode(~u32{0}, ~u32{0}));
+
+    u32 const coords[][2]{
+        {0, 0},
+        {1, 2},
+        {7, 7},
+        {1000, 300000},
+        {~u32{0}, 0},
+    };
+
+    for (auto const& c : coords)
+    {
+        u32 result[2];
+        morton_decode(morton_encode(c[0], c[1]), result);
+        ASSERT_EQ(c[0], result[0]);
+        ASSERT_EQ(c[1], result[1]);
+    }
+}
+
+UTEST(bitwise, hilbert_encode)
+{
+    using namespace dr;
+
+    // Consecutive cells along the curve should be adjacent
+    {
+        constexpr u32 n = 16;
+        u32 cells[n * n][2];
+
+        for (u32 y = 0; y < n; ++y)
+        {
+            for (u32 x = 0; x < n; ++x)
+            {
+                u64 const code = hilbert_encode(x, y);
+                ASSERT_TRUE(code < n * n);
+                cells[code][0] = x;
+                cells[code][1] = y;
+            }
+        }
+
+        for (u32 i = 1; i < n * n; ++i)
+        {
+            u32 const dist = u32(std::abs(i32(cells[i][0]) - i32(cells[i - 1][0])))
+                + u32(std::abs(i32(cells[i][1]) - i32(cells[i - 1][1])));
+            ASSERT_EQ(1u, dist);
+        }
+    }
+
+    {
+        constexpr u32 n = 8;
+        u32 cells[n * n * n][3];
+
+        for (u32 z = 0; z < n; ++z)
+        {
+            for (u32 y = 0; y < n; ++y)
+            {
+                for (u32 x = 0; x < n; ++x)
+                {
+                    u64 const code = hilbert_encode(x, y, z);
+                    ASSERT_TRUE(code < n * n * n);
+                    cells[code][0] = x;
+                    cells[code][1] = y;
+                    cells[code][2] = z;
+                }
+            }
+        }
+
+        for (u32 i = 1; i < n * n * n; ++i)
+        {
+            u32 dist = 0;
+            for (isize j = 0; j < 3; ++j)
+                dist += u32(std::abs(i32(cells[i][j]) - i32(cells[i - 1][j])));
+
+            ASSERT_EQ(1u, dist);
+        }
+    }
+}
@@ -0,0 +1,102 @@
+#include <utest.h>
+
+#include <dr/bricked_grid.hpp>
+#include <dr/container_utils.hpp>
+#include <dr/defer.hpp>
+#include <dr/memory.hpp>
+
+UTEST(bricked_grid, allocator_propagation)
+{
+    using namespace dr;
+
+    // Restore default memory resource after test is complete
+    auto def_mem = std::pmr::get_default_resource();
+    auto _ = defer([=]() {
+        std::pmr::set_default_resource(def_mem);
+    });
+
+    DebugMemoryResource mem[3]{};
+    std::pmr::set_default_resource(&mem[0]);
+
+    BrickedGrid<f64> src{&mem[1]};
+    ASSERT_TRUE(src.allocator().resource()->is_equal(mem[1]));
+
+    {
+        // dst should use the given memory resource
+        BrickedGrid<f64> dst{src, &mem[2]};
+        ASSERT_TRUE(dst.allocator().resource()->is_equal(mem[2]));
+    }
+
+    {
+        // dst should use the current default memory resource
+        BrickedGrid<f64> dst{src};
+        ASSERT_TRUE(dst.allocator().resource()->is_equal(mem[0]));
+    }
+
+    {
+        // dst should use the same memory resource as src
+        BrickedGrid<f64> dst{std::move(src)};
+        ASSERT_TRUE(dst.allocator().resource()->is_equal(mem[1]));
+    }
+}
+
+UTEST(bricked_grid, access)
+{
+    using namespace dr;
+
+    BrickedGrid<i32> grid{{10, 9, 3}, -1};
+    ASSERT_EQ(4, grid.num_bricks());
+    ASSERT_EQ(4 * grid_brick_size, grid.values().size());
+
+    for (isize k = 0; k < 3; ++k)
+    {
+        for (isize j = 0; j < 9; ++j)
+        {
+            for (isize i = 0; i < 10; ++i)
+                grid[{i, j, k}] = i32(i + j * 10 + k * 90);
+        }
+    }
+
+    for (isize i = 0; i < grid.values().size(); ++i)
+    {
+        Vec3<isize> const id = grid.to_grid(i);
+        i32 const expect = grid.contains(id) ? i32(id[0] + id[1] * 10 + id[2] * 90) : -1;
+        ASSERT_EQ(expect, grid.values()[i]);
+    }
+
+    // Values in a brick should cover a contiguous block of grid points
+    {
+        auto const brick = grid.brick(1);
+        ASSERT_EQ(i32(8), brick[0]);
+        ASSERT_EQ(i32(9), brick[1]);
+        ASSERT_EQ(i32(8 + 10), brick[2]);
+        ASSERT_EQ(i32(8 + 90), brick[4]);
+    }
+}
+
+UTEST(bricked_grid, assign)
+{
+    using namespace dr;
+
+    Vec3<isize> const shape{17, 5, 12};
+
+    DynamicArray<f32> src(shape.prod());
+    for (isize i = 0; i < size(src); ++i)
+        src[i] = f32(i);
+
+    for (isize const num_threads : {1, 4})
+    {
+        BrickedGrid<f32> grid{shape};
+        grid.assign(as_span(src).as_const(), Executor{num_threads});
+
+        Vec3<isize> const stride = grid_stride(shape);
+        for (isize i = 0; i < size(src); ++i)
+            ASSERT_EQ(src[i], (grid[index_to_grid(i, stride)]));
+
+        DynamicArray<f32> dst(shape.prod());
+        grid.copy_to(as_span(dst), Executor{num_threads});
+
+        for (isize i = 0; i < size(src); ++i)
+            ASSERT_EQ(src[i], dst[i]);
+    }
+}
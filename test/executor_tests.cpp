@@ -0,0 +1,252 @@
+#include <utest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <dr/dynamic_array.hpp>
+#include <dr/executor.hpp>
+
+namespace
+{
+
+// Runs tasks serially while counting calls to run
+struct CountingResource final : dr::ExecutionResource
+{
+    dr::isize num_runs{};
+
+    dr::isize concurrency() const override { return 3; }
+
+    void run(dr::isize const num_tasks, dr::FunctionRef<void(dr::isize)> const fn) override
+    {
+        ++num_runs;
+        for (dr::isize i = 0; i < num_tasks; ++i)
+            fn(i);
+    }
+};
+
+} // namespace
+
+UTEST(executor, parallel_for)
+{
+    using namespace dr;
+
+    ThreadPool pool{4};
+    CountingResource counting{};
+
+    for (Executor const exec : {Executor{}, Executor{4}, Executor{pool}, Executor{counting}})
+    {
+        for (isize const n : {0, 1, 3, 1000})
+        {
+            DynamicArray<i32> counts(n, 0);
+
+            exec.parallel_for(n, [&](isize const i) {
+                ++counts[i];
+            });
+
+            for (isize i = 0; i < n; ++i)
+                ASSERT_EQ(1, counts[i]);
+        }
+    }
+
+    ASSERT_GT(counting.num_runs, 0);
+}
+
+UTEST(executor, parallel_for_blocks)
+{
+    using namespace dr;
+
+    ThreadPool pool{4};
+
+    for (Executor const exec : {Executor{}, Executor{pool}})
+    {
+        for (isize const n : {0, 1, 3, 1000})
+        {
+            isize const num_blocks = exec.num_blocks(n);
+            ASSERT_GE(num_blocks, 1);
+            ASSERT_LE(num_blocks, exec.concurrency());
+
+            DynamicArray<isize> begins(num_blocks, -1);
+            DynamicArray<isize> ends(num_blocks, -1);
+
+            exec.parallel_for_blocks(n, [&](isize const b, isize const begin, isize const end) {
+                begins[b] = begin;
+                ends[b] = end;
+            });
+
+            // Blocks are contiguous and cover the whole range
+            ASSERT_EQ(0, begins[0]);
+            ASSERT_EQ(n, ends[num_blocks - 1]);
+
+            for (isize b = 1; b < num_blocks; ++b)
+                ASSERT_EQ(ends[b - 1], begins[b]);
+        }
+    }
+}
+
+UTEST(executor, parallel_for_ranges)
+{
+    using namespace dr;
+
+    ThreadPool pool{4};
+    CountingResource counting{};
+
+    for (Executor const exec : {Executor{}, Executor{4}, Executor{pool}, Executor{counting}})
+    {
+        for (isize const n : {0, 1, 3, 1000})
+        {
+            for (isize const grain_size : {0, 1, 7})
+            {
+                DynamicArray<i32> counts(n, 0);
+
+                exec.parallel_for_ranges(
+                    n,
+                    [&](isize const begin, isize const end) {
+                        ASSERT_TRUE(begin < end);
+                        ASSERT_TRUE(grain_size == 0 || end - begin <= grain_size);
+
+                        for (isize i = begin; i < end; ++i)
+                            ++counts[i];
+                    },
+                    grain_size);
+
+                for (isize i = 0; i < n; ++i)
+                    ASSERT_EQ(1, counts[i]);
+            }
+        }
+    }
+}
+
+UTEST(executor, parallel_for_dynamic)
+{
+    using namespace dr;
+
+    ThreadPool pool{4};
+    Executor const exec{pool};
+
+    // Cost of each item grows with its index
+    constexpr isize n = 2000;
+    DynamicArray<i64> sums(n, 0);
+
+    exec.parallel_for_dynamic(n, [&](isize const i) {
+        i64 sum = 0;
+        for (isize j = 0; j < i; ++j)
+            sum += j;
+
+        sums[i] = sum;
+    });
+
+    for (isize i = 0; i < n; ++i)
+        ASSERT_EQ(i64(i) * (i - 1) / 2, sums[i]);
+}
+
+UTEST(executor, parallel_reduce)
+{
+    using namespace dr;
+
+    ThreadPool pool{4};
+
+    for (Executor const exec : {Executor{}, Executor{4}, Executor{pool}})
+    {
+        for (isize const n : {0, 1, 1000})
+        {
+            i64 const sum = exec.parallel_reduce(
+                n,
+                i64{0},
+                [](i64& acc, isize const i) { acc += i; },
+                [](i64& acc, i64 const& partial) { acc += partial; });
+
+            ASSERT_EQ(i64(n) * (n - 1) / 2, sum);
+        }
+    }
+}
+
+UTEST(executor, nested_run)
+{
+    using namespace dr;
+
+    ThreadPool pool{4};
+    Executor const exec{pool};
+
+    std::atomic<isize> count{0};
+
+    // Nested calls run serially on the calling thread
+    exec.run(8, [&](isize) {
+        exec.run(8, [&](isize) {
+            count.fetch_add(1, std::memory_order_relaxed);
+        });
+    });
+
+    ASSERT_EQ(64, count.load());
+}
+
+UTEST(executor, task_batch)
+{
+    using namespace dr;
+
+    ThreadPool pool{4};
+
+    for (Executor const exec : {Executor{}, Executor{pool}})
+    {
+        i32 a = 0;
+        i32 b = 0;
+
+        TaskBatch tasks{exec};
+        tasks.add([&]() { a = 1; });
+        tasks.add([&]() { b = 2; });
+        ASSERT_EQ(2, tasks.num_pending());
+        ASSERT_EQ(0, a);
+
+        tasks.run();
+        ASSERT_EQ(0, tasks.num_pending());
+        ASSERT_EQ(1, a);
+        ASSERT_EQ(2, b);
+    }
+}
+
+UTEST(executor, thread_pool)
+{
+    using namespace dr;
+
+    ThreadPool pool{3};
+    ASSERT_EQ(3, pool.concurrency());
+
+    // Repeated jobs reuse the same workers
+    for (isize k = 0; k < 100; ++k)
+    {
+        std::atomic<isize> sum{0};
+
+        auto const add = [&](isize const i) {
+            sum.fetch_add(i, std::memory_order_relaxed);
+        };
+
+        pool.run(k, &add);
+
+        ASSERT_EQ(k * (k - 1) / 2, sum.load());
+    }
+}
+
+UTEST(executor, thread_pool_idle)
+{
+    using namespace dr;
+
+    ThreadPool pool{4};
+
+    // One slow item leaves the other threads idle for the rest of the job. They should be woken
+    // once it completes.
+    for (isize k = 0; k < 10; ++k)
+    {
+        std::atomic<isize> count{0};
+
+        auto const run_range = [&](isize const begin, isize const end) {
+            if (begin == 0)
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+            count.fetch_add(end - begin, std::memory_order_relaxed);
+        };
+
+        pool.run_ranges(1000, 1, &run_range);
+
+        ASSERT_EQ(1000, count.load());
+    }
+}
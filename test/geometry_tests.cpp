@@ -556,6 +556,46 @@ UTEST(geometry, nearest_point_plane)
     }
 }
 
+UTEST(geometry, nearest_point_tri)
+{
+    using namespace dr;
+
+    constexpr f64 eps = 1.0e-8;
+
+    struct TestCase
+    {
+        Vec3<f64> point;
+        Vec3<f64> expect;
+    };
+
+    Vec3<f64> const tri[]{
+        vec(0.0, 0.0, 0.0),
+        vec(2.0, 0.0, 0.0),
+        vec(0.0, 2.0, 0.0),
+    };
+
+    TestCase const test_cases[] = {
+        // Face region
+        {vec(0.5, 0.5, 1.0), vec(0.5, 0.25, 0.25)},
+        // Vertex regions
+        {vec(-1.0, -1.0, 1.0), vec(1.0, 0.0, 0.0)},
+        {vec(3.0, -1.0, 0.0), vec(0.0, 1.0, 0.0)},
+        {vec(-1.0, 3.0, -1.0), vec(0.0, 0.0, 1.0)},
+        // Edge regions
+        {vec(1.0, -1.0, 0.0), vec(0.5, 0.5, 0.0)},
+        {vec(-1.0, 1.0, 2.0), vec(0.5, 0.0, 0.5)},
+        {vec(2.0, 2.0, 0.0), vec(0.0, 0.5, 0.5)},
+    };
+
+    for (auto const& [p, expect] : test_cases)
+    {
+        auto const w = nearest_point_tri(p, tri[0], tri[1], tri[2]);
+        ASSERT_NEAR(expect[0], w[0], eps);
+        ASSERT_NEAR(expect[1], w[1], eps);
+        ASSERT_NEAR(expect[2], w[2], eps);
+    }
+}
+
 UTEST(geometry, nearest_line_line)
 {
     using namespace dr;
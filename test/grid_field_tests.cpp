@@ -0,0 +1,230 @@
+#include <utest.h>
+
+#include <dr/bricked_grid.hpp>
+#include <dr/container_utils.hpp>
+#include <dr/dynamic_array.hpp>
+#include <dr/grid_field.hpp>
+#include <dr/random.hpp>
+
+namespace
+{
+
+template <typename Real>
+void make_linear_field(
+    dr::Grid3<Real> const& grid,
+    dr::Vec3<Real> const& slope,
+    Real const offset,
+    dr::DynamicArray<Real>& values)
+{
+    values.resize(grid.shape.prod());
+
+    for (dr::isize i = 0; i < dr::size(values); ++i)
+        values[i] = slope.dot(grid.to_world(grid.to_grid(i))) + offset;
+}
+
+} // namespace
+
+UTEST(grid_field, sample)
+{
+    using namespace dr;
+
+    constexpr f64 eps = 1.0e-10;
+
+    Grid3<f64> const grid{{6, 5, 4}, {0.5, 0.25, 1.0}, {-1.0, 0.0, 2.0}};
+    Vec3<f64> const slope{1.0, -2.0, 0.5};
+    f64 const offset = 3.0;
+
+    DynamicArray<f64> values{};
+    make_linear_field(grid, slope, offset, values);
+
+    GridField<f64> const field{grid, as_span(values)};
+
+    // Linear functions should be reproduced exactly by both filters away from the boundary
+    Vec3<f64> const points[]{
+        grid.to_world(Vec3<f64>{1.0, 1.0, 1.0}),
+        grid.to_world(Vec3<f64>{2.5, 1.25, 1.75}),
+        grid.to_world(Vec3<f64>{3.9, 2.1, 1.01}),
+    };
+
+    for (GridFilter const filter : {GridFilter_Linear, GridFilter_Cubic})
+    {
+        for (auto const& p : points)
+        {
+            f64 const expect = slope.dot(p) + offset;
+            ASSERT_NEAR(expect, field.sample(p, filter), eps);
+
+            Vec3<f64> grad;
+            ASSERT_NEAR(expect, field.sample(p, filter, grad), eps);
+            ASSERT_NEAR(0.0, (grad - slope).norm(), eps);
+        }
+    }
+
+    // Points outside the grid should be clamped to the boundary
+    {
+        Vec3<f64> const p = grid.to_world(Vec3<f64>{-2.0, 10.0, 1.5});
+        Vec3<f64> const p_clamped = grid.to_world(Vec3<f64>{0.0, 4.0, 1.5});
+        f64 const expect = slope.dot(p_clamped) + offset;
+        ASSERT_NEAR(expect, field.sample(p, GridFilter_Linear), eps);
+    }
+}
+
+UTEST(grid_field, sample_batch)
+{
+    using namespace dr;
+
+    constexpr f64 eps = 1.0e-10;
+
+    Grid3<f64> const grid{{9, 7, 8}, {0.5, 0.5, 0.5}, {0.0, 0.0, 0.0}};
+
+    DynamicArray<f64> values(grid.shape.prod());
+    {
+        Random<> rand{1};
+        auto gen = rand.generator(0.0, 1.0);
+        for (f64& v : values)
+            v = gen();
+    }
+
+    GridField<f64> const field{grid, as_span(values)};
+
+    // Random points including some outside of the grid
+    DynamicArray<Vec3<f64>> points(5000);
+    {
+        Vec3<f64> const lo = grid.to_world(Vec3<f64>{-1.0, -1.0, -1.0});
+        Vec3<f64> const hi = grid.to_world((grid.shape.cast<f64>().array() + 1.0).matrix().eval());
+
+        Random<> rand{2};
+        auto gen = rand.generator(0.0, 1.0);
+        for (Vec3<f64>& p : points)
+        {
+            for (int i = 0; i < 3; ++i)
+                p[i] = lo[i] + (hi[i] - lo[i]) * gen();
+        }
+    }
+
+    for (GridFilter const filter : {GridFilter_Linear, GridFilter_Cubic})
+    {
+        for (isize const num_threads : {1, 4})
+        {
+            DynamicArray<f64> batch_vals(size(points));
+            DynamicArray<Vec3<f64>> batch_grads(size(points));
+
+            sample_field(
+                field,
+                filter,
+                as_span(points).as_const(),
+                as_span(batch_vals),
+                as_span(batch_grads),
+                Executor{num_threads});
+
+            DynamicArray<f64> batch_vals_only(size(points));
+            sample_field(
+                field,
+                filter,
+                as_span(points).as_const(),
+                as_span(batch_vals_only),
+                {},
+                Executor{num_threads});
+
+            // Results should match point-wise evaluation
+            for (isize i = 0; i < size(points); ++i)
+            {
+                Vec3<f64> grad;
+                f64 const val = field.sample(points[i], filter, grad);
+
+                ASSERT_NEAR(val, batch_vals[i], eps);
+                ASSERT_NEAR(val, batch_vals_only[i], eps);
+                ASSERT_NEAR(0.0, (grad - batch_grads[i]).norm(), eps);
+            }
+        }
+    }
+}
+
+UTEST(grid_field, sample_cubic_interpolates)
+{
+    using namespace dr;
+
+    constexpr f64 eps = 1.0e-12;
+
+    Grid3<f64> const grid{{4, 4, 4}, {1.0, 1.0, 1.0}, {0.0, 0.0, 0.0}};
+
+    DynamicArray<f64> values(grid.shape.prod());
+    {
+        Random<> rand{3};
+        auto gen = rand.generator(0.0, 1.0);
+        for (f64& v : values)
+            v = gen();
+    }
+
+    GridField<f64> const field{grid, as_span(values)};
+
+    // Both filters should interpolate values at grid vertices
+    for (isize i = 0; i < size(values); ++i)
+    {
+        Vec3<f64> const p = grid.to_world(grid.to_grid(i));
+        ASSERT_NEAR(values[i], field.sample(p, GridFilter_Linear), eps);
+        ASSERT_NEAR(values[i], field.sample(p, GridFilter_Cubic), eps);
+    }
+}
+
+UTEST(grid_field, sample_bricked)
+{
+    using namespace dr;
+
+    constexpr f64 eps = 1.0e-12;
+
+    Grid3<f64> const grid{{11, 9, 17}, {0.5, 1.0, 0.25}, {1.0, 2.0, 3.0}};
+
+    DynamicArray<f64> values(grid.shape.prod());
+    {
+        Random<> rand{4};
+        auto gen = rand.generator(0.0, 1.0);
+
+        for (f64& v : values)
+            v = gen();
+    }
+
+    BrickedGrid<f64> bricked{grid.shape};
+    bricked.assign(as_span(values).as_const());
+
+    GridField<f64> const field{grid, as_span(values)};
+    GridField<f64> const bricked_field{grid, bricked.values(), GridLayout_Bricked};
+    ASSERT_EQ(bricked.values().size(), bricked_field.num_values());
+
+    DynamicArray<Vec3<f64>> points(1000);
+    {
+        Vec3<f64> const lo = grid.to_world(Vec3<f64>{-1.0, -1.0, -1.0});
+        Vec3<f64> const hi = grid.to_world((grid.shape.cast<f64>().array() + 1.0).matrix().eval());
+
+        Random<> rand{5};
+        auto gen = rand.generator(0.0, 1.0);
+
+        for (Vec3<f64>& p : points)
+        {
+            for (int i = 0; i < 3; ++i)
+                p[i] = lo[i] + (hi[i] - lo[i]) * gen();
+        }
+    }
+
+    // Results should be independent of layout
+    for (GridFilter const filter : {GridFilter_Linear, GridFilter_Cubic})
+    {
+        DynamicArray<f64> a(size(points));
+        DynamicArray<Vec3<f64>> a_grads(size(points));
+        sample_field(field, filter, as_span(points).as_const(), as_span(a), as_span(a_grads));
+
+        DynamicArray<f64> b(size(points));
+        DynamicArray<Vec3<f64>> b_grads(size(points));
+        sample_field(
+            bricked_field,
+            filter,
+            as_span(points).as_const(),
+            as_span(b),
+            as_span(b_grads));
+
+        for (isize i = 0; i < size(points); ++i)
+        {
+            ASSERT_NEAR(a[i], b[i], eps);
+            ASSERT_NEAR(0.0, (a_grads[i] - b_grads[i]).norm(), eps);
+        }
+    }
+}
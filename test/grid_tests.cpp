@@ -1,5 +1,6 @@
 #include <utest.h>
 
+#include <dr/dynamic_array.hpp>
 #include <dr/grid.hpp>
 #include <dr/math_ctors.hpp>
 
@@ -163,4 +164,41 @@ UTEST(grid, world_to_grid)
         ASSERT_NEAR(expect.grid_pt[1], grid_pt[1], eps);
         ASSERT_NEAR(expect.grid_pt[2], grid_pt[2], eps);
     }
-}
\ No newline at end of file
+}
+
+UTEST(grid, bricked_grid_to_index)
+{
+    using namespace dr;
+
+    Vec3<isize> const shape{19, 8, 10};
+    Vec3<isize> const brick_stride = grid_stride(grid_brick_count(shape));
+    isize const num_indices = grid_brick_count(shape).prod() * grid_brick_size;
+
+    // Mapping should be a bijection between grid points and indices
+    DynamicArray<bool> visited(num_indices, false);
+
+    for (isize k = 0; k < shape[2]; ++k)
+    {
+        for (isize j = 0; j < shape[1]; ++j)
+        {
+            for (isize i = 0; i < shape[0]; ++i)
+            {
+                Vec3<isize> const id{i, j, k};
+                isize const index = bricked_grid_to_index(id, brick_stride);
+                ASSERT_TRUE(index >= 0 && index < num_indices);
+                ASSERT_FALSE(visited[index]);
+                visited[index] = true;
+
+                ASSERT_TRUE(id == bricked_index_to_grid(index, brick_stride));
+            }
+        }
+    }
+
+    // Points within the same brick should be contiguous
+    ASSERT_EQ(0, bricked_grid_to_index(Vec3<isize>{0, 0, 0}, brick_stride));
+    ASSERT_EQ(1, bricked_grid_to_index(Vec3<isize>{1, 0, 0}, brick_stride));
+    ASSERT_EQ(7, bricked_grid_to_index(Vec3<isize>{1, 1, 1}, brick_stride));
+    ASSERT_EQ(511, bricked_grid_to_index(Vec3<isize>{7, 7, 7}, brick_stride));
+    ASSERT_EQ(512, bricked_grid_to_index(Vec3<isize>{8, 0, 0}, brick_stride));
+    ASSERT_EQ(512 * 3, bricked_grid_to_index(Vec3<isize>{0, 0, 8}, brick_stride));
+}
@@ -0,0 +1,172 @@
+#include <utest.h>
+
+#include <dr/bricked_grid.hpp>
+#include <dr/container_utils.hpp>
+#include <dr/dynamic_array.hpp>
+#include <dr/hash_map.hpp>
+#include <dr/isosurface.hpp>
+#include <dr/math_constants.hpp>
+#include <dr/math_types.hpp>
+
+namespace
+{
+
+dr::DynamicArray<dr::f64> make_sphere_field(dr::Grid3<dr::f64> const& grid, dr::f64 const radius)
+{
+    using namespace dr;
+
+    DynamicArray<f64> result(grid.shape.prod());
+    for (isize i = 0; i < size(result); ++i)
+        result[i] = grid.to_world(grid.to_grid(i)).norm() - radius;
+
+    return result;
+}
+
+} // namespace
+
+UTEST(isosurface, extract_isosurface)
+{
+    using namespace dr;
+
+    constexpr f64 radius = 0.8;
+    Grid3<f64> const grid{{27, 25, 30}, {0.08, 0.08, 0.08}, {-1.03, -0.99, -1.15}};
+    DynamicArray<f64> const values = make_sphere_field(grid, radius);
+    GridField<f64> const field{grid, as_span(values)};
+
+    DynamicArray<Vec3<f64>> vert_positions{};
+    DynamicArray<Vec3<i32>> face_verts{};
+    extract_isosurface(field, 0.0, vert_positions, face_verts);
+
+    ASSERT_LT(0, size(face_verts));
+
+    // Vertices should be close to the sphere
+    for (auto const& p : vert_positions)
+        ASSERT_NEAR(radius, p.norm(), 0.01);
+
+    // Mesh should be closed and consistently oriented i.e. each directed edge should appear once
+    // along with its opposite
+    {
+        auto const to_key = [](i32 const a, i32 const b) -> u64 {
+            return (u64(a) << 32) | u64(b);
+        };
+
+        HashMap<u64, i32> edge_counts{};
+        for (auto const& f_v : face_verts)
+        {
+            for (int i = 0; i < 3; ++i)
+            {
+                i32 const a = f_v[i];
+                i32 const b = f_v[(i + 1) % 3];
+                ASSERT_NE(a, b);
+                ++edge_counts[to_key(a, b)];
+            }
+        }
+
+        for (auto const& [key, count] : edge_counts)
+        {
+            ASSERT_EQ(1, count);
+            ASSERT_EQ(1u, edge_counts.count(to_key(i32(key & 0xffffffff), i32(key >> 32))));
+        }
+    }
+
+    // Faces should be oriented outwards
+    {
+        f64 vol = 0.0;
+        for (auto const& f_v : face_verts)
+        {
+            vol += vert_positions[f_v[0]].dot(
+                       vert_positions[f_v[1]].cross(vert_positions[f_v[2]]))
+                / 6.0;
+        }
+
+        f64 const expect = 4.0 / 3.0 * pi<f64> * radius * radius * radius;
+        ASSERT_NEAR(expect, vol, expect * 0.02);
+    }
+
+    // Result should be independent of the number of threads and the layout of the field
+    {
+        DynamicArray<Vec3<f64>> vert_positions_mt{};
+        DynamicArray<Vec3<i32>> face_verts_mt{};
+        extract_isosurface(field, 0.0, vert_positions_mt, face_verts_mt, Executor{4});
+
+        ASSERT_EQ(size(vert_positions), size(vert_positions_mt));
+        ASSERT_EQ(size(face_verts), size(face_verts_mt));
+
+        for (isize i = 0; i < size(vert_positions); ++i)
+            ASSERT_EQ(vert_positions[i], vert_positions_mt[i]);
+
+        for (isize i = 0; i < size(face_verts); ++i)
+            ASSERT_EQ(face_verts[i], face_verts_mt[i]);
+    }
+
+    {
+        BrickedGrid<f64> bricked{grid.shape};
+        bricked.assign(as_span(values).as_const());
+
+        DynamicArray<Vec3<f64>> vert_positions_br{};
+        DynamicArray<Vec3<i32>> face_verts_br{};
+        extract_isosurface(
+            GridField<f64>{grid, bricked.values(), GridLayout_Bricked},
+            0.0,
+            vert_positions_br,
+            face_verts_br);
+
+        ASSERT_EQ(size(vert_positions), size(vert_positions_br));
+        ASSERT_EQ(size(face_verts), size(face_verts_br));
+
+        for (isize i = 0; i < size(vert_positions); ++i)
+            ASSERT_EQ(vert_positions[i], vert_positions_br[i]);
+
+        for (isize i = 0; i < size(face_verts); ++i)
+            ASSERT_EQ(face_verts[i], face_verts_br[i]);
+    }
+}
+
+UTEST(isosurface, extract_isosurface_slabs)
+{
+    using namespace dr;
+
+    Grid3<f64> const grid{{20, 21, 40}, {0.1, 0.1, 0.1}, {-1.01, -0.97, -2.03}};
+    DynamicArray<f64> const values = make_sphere_field(grid, 0.9);
+    GridField<f64> const field{grid, as_span(values)};
+
+    DynamicArray<Vec3<f64>> expect_vert_positions{};
+    DynamicArray<Vec3<i32>> expect_face_verts{};
+    extract_isosurface(field, 0.0, expect_vert_positions, expect_face_verts);
+
+    for (isize const num_threads : {1, 3})
+    {
+        DynamicArray<Vec3<f64>> vert_positions{};
+        DynamicArray<Vec3<i32>> face_verts{};
+        bool refs_valid = true;
+
+        extract_isosurface_slabs<i32>(
+            field,
+            0.0,
+            [&](Span<Vec3<f64> const> const& slab_vert_positions,
+                Span<Vec3<i32> const> const& slab_face_verts) {
+                vert_positions.insert(
+                    vert_positions.end(),
+                    begin(slab_vert_positions),
+                    end(slab_vert_positions));
+
+                // Faces should only refer to vertices which have already been received
+                for (auto const& f_v : slab_face_verts)
+                {
+                    refs_valid &= (f_v.array() < size_as<i32>(vert_positions)).all();
+                    face_verts.push_back(f_v);
+                }
+            },
+            Executor{num_threads});
+
+        ASSERT_TRUE(refs_valid);
+        ASSERT_EQ(size(expect_vert_positions), size(vert_positions));
+        ASSERT_EQ(size(expect_face_verts), size(face_verts));
+
+        for (isize i = 0; i < size(vert_positions); ++i)
+            ASSERT_EQ(expect_vert_positions[i], vert_positions[i]);
+
+        for (isize i = 0; i < size(face_verts); ++i)
+            ASSERT_EQ(expect_face_verts[i], face_verts[i]);
+    }
+}
@@ -0,0 +1,298 @@
+#include <utest.h>
+
+#include <cstdio>
+#include <filesystem>
+
+#include <dr/defer.hpp>
+#include <dr/dynamic_array.hpp>
+#include <dr/geometry.hpp>
+#include <dr/halfedge.hpp>
+#include <dr/mesh_archive.hpp>
+#include <dr/mesh_primitives.hpp>
+#include <dr/sliced_array.hpp>
+
+namespace fs = std::filesystem;
+
+UTEST(mesh_archive, write_read)
+{
+    using namespace dr;
+
+    fs::path const path = fs::temp_directory_path() / "mesh_archive_test.drm";
+    auto _ = defer([&]() {
+        std::remove(path.string().c_str());
+    });
+
+    auto& mesh_prim = MeshPrimitives::Tri::cube();
+    auto const vert_coords = as<Vec3<f32>>(mesh_prim.vertex_positions);
+    auto const face_verts = as<Vec3<i16>>(mesh_prim.face_vertices);
+
+    {
+        MeshArchive::Writer writer{};
+        writer.add("vertex_positions", vert_coords);
+        writer.add("face_vertices", face_verts);
+        ASSERT_EQ(MeshArchive::Error_None, writer.write(path.string().c_str()));
+    }
+
+    MeshArchive archive{};
+    ASSERT_EQ(MeshArchive::Error_None, archive.open(path.string().c_str(), true));
+    ASSERT_EQ(2, archive.num_sections());
+
+    {
+        auto const result = archive.find<Vec3<f32>>("vertex_positions");
+        ASSERT_EQ(vert_coords.size(), result.size());
+
+        for (isize i = 0; i < result.size(); ++i)
+            ASSERT_TRUE(vert_coords[i] == result[i]);
+
+        // Returned spans can be passed directly to library functions
+        auto const a = bounding_interval(result);
+        auto const b = bounding_interval(vert_coords);
+        ASSERT_TRUE(a.min() == b.min());
+        ASSERT_TRUE(a.max() == b.max());
+    }
+
+    {
+        auto const result = archive.find<Vec3<i16>>("face_vertices");
+        ASSERT_EQ(face_verts.size(), result.size());
+
+        for (isize i = 0; i < result.size(); ++i)
+            ASSERT_TRUE(face_verts[i] == result[i]);
+    }
+
+    // Mismatched element types and missing sections should return invalid spans
+    ASSERT_FALSE(archive.find<Vec3<f64>>("vertex_positions").is_valid());
+    ASSERT_FALSE(archive.find<Vec2<f32>>("vertex_positions").is_valid());
+    ASSERT_FALSE(archive.find<f32>("vertex_normals").is_valid());
+}
+
+UTEST(mesh_archive, write_read_sliced)
+{
+    using namespace dr;
+
+    fs::path const path = fs::temp_directory_path() / "mesh_archive_sliced_test.drm";
+    auto _ = defer([&]() {
+        std::remove(path.string().c_str());
+    });
+
+    SlicedArray<i32> src{};
+    i32 const a[] = {0, 1, 2};
+    i32 const b[] = {3, 4, 5, 6};
+    i32 const c[] = {7};
+
+    src.push_back(as_span(a));
+    src.push_back(as_span(b));
+    src.push_back(as_span(c));
+
+    {
+        MeshArchive::Writer writer{};
+        writer.add("face_vertices", src);
+        ASSERT_EQ(MeshArchive::Error_None, writer.write(path.string().c_str()));
+    }
+
+    MeshArchive archive{};
+    ASSERT_EQ(MeshArchive::Error_None, archive.open(path.string().c_str()));
+
+    SlicedArray<i32> dst{};
+    ASSERT_TRUE(archive.read("face_vertices", dst));
+    ASSERT_EQ(src.num_slices(), dst.num_slices());
+
+    for (isize i = 0; i < src.num_slices(); ++i)
+    {
+        auto const a = src[i];
+        auto const b = dst[i];
+        ASSERT_EQ(a.size(), b.size());
+
+        for (isize j = 0; j < a.size(); ++j)
+            ASSERT_EQ(a[j], b[j]);
+    }
+
+    SlicedArray<f32> mismatch{};
+    ASSERT_FALSE(archive.read("face_vertices", mismatch));
+}
+
+UTEST(mesh_archive, write_read_halfedge)
+{
+    using namespace dr;
+
+    fs::path const path = fs::temp_directory_path() / "mesh_archive_halfedge_test.drm";
+    auto _ = defer([&]() {
+        std::remove(path.string().c_str());
+    });
+
+    HalfedgeMesh src{};
+    {
+        auto& mesh_prim = MeshPrimitives::Tri::cube();
+        auto const face_verts = as<Vec3<i16>>(mesh_prim.face_vertices);
+
+        HalfedgeMesh::Builder builder{};
+        ASSERT_EQ(HalfedgeMesh::Builder::Error_None, builder.make_from_face_vertex(face_verts, src));
+    }
+
+    {
+        MeshArchive::Writer writer{};
+        writer.add("cube", src);
+        ASSERT_EQ(MeshArchive::Error_None, writer.write(path.string().c_str()));
+    }
+
+    MeshArchive archive{};
+    ASSERT_EQ(MeshArchive::Error_None, archive.open(path.string().c_str(), true));
+
+    HalfedgeMesh dst{};
+    ASSERT_TRUE(archive.read("cube", dst));
+    ASSERT_FALSE(archive.read("sphere", dst));
+
+    ASSERT_EQ(src.num_vertices(), dst.num_vertices());
+    ASSERT_EQ(src.num_halfedges(), dst.num_halfedges());
+    ASSERT_EQ(src.num_faces(), dst.num_faces());
+    ASSERT_EQ(src.num_holes(), dst.num_holes());
+
+    for (i32 i = 0; i < src.num_halfedges(); ++i)
+    {
+        auto const he = HalfedgeMesh::halfedge(i);
+        ASSERT_EQ(src.next(he), dst.next(he));
+        ASSERT_EQ(src.vertex(he), dst.vertex(he));
+        ASSERT_EQ(src.face(he), dst.face(he));
+    }
+}
+
+UTEST(mesh_archive, read_halfedge_invalid)
+{
+    using namespace dr;
+
+    fs::path const path = fs::temp_directory_path() / "mesh_archive_halfedge_invalid_test.drm";
+    auto _ = defer([&]() {
+        std::remove(path.string().c_str());
+    });
+
+    constexpr char const* suffixes[]{
+        ".hedge_next",
+        ".hedge_prev",
+        ".hedge_vert",
+        ".hedge_face",
+        ".hedge_hole",
+        ".vert_hedge",
+        ".face_hedge",
+        ".hole_hedge",
+    };
+
+    // Copy the sections of a valid mesh so they can be damaged
+    DynamicArray<i32> arrays[size(suffixes)];
+    {
+        HalfedgeMesh mesh{};
+        {
+            auto& mesh_prim = MeshPrimitives::Tri::cube();
+            auto const face_verts = as<Vec3<i16>>(mesh_prim.face_vertices);
+
+            HalfedgeMesh::Builder builder{};
+            ASSERT_EQ(
+                HalfedgeMesh::Builder::Error_None,
+                builder.make_from_face_vertex(face_verts, mesh));
+        }
+
+        MeshArchive::Writer writer{};
+        writer.add("cube", mesh);
+        ASSERT_EQ(MeshArchive::Error_None, writer.write(path.string().c_str()));
+
+        MeshArchive archive{};
+        ASSERT_EQ(MeshArchive::Error_None, archive.open(path.string().c_str()));
+
+        char name[MeshArchive::max_name_size];
+        for (isize i = 0; i < size(suffixes); ++i)
+        {
+            std::snprintf(name, sizeof(name), "cube%s", suffixes[i]);
+            Span<i32 const> const src = archive.find<i32>(name);
+            ASSERT_TRUE(src.is_valid());
+            arrays[i].assign(begin(src), end(src));
+        }
+    }
+
+    // Halfedge vertices are truncated
+    DynamicArray<i32> truncated = arrays[2];
+    truncated.pop_back();
+
+    // Next halfedge is out of range
+    DynamicArray<i32> out_of_range = arrays[0];
+    out_of_range[0] = i32(size(out_of_range));
+
+    {
+        MeshArchive::Writer writer{};
+        char name[MeshArchive::max_name_size];
+
+        for (isize i = 0; i < size(suffixes); ++i)
+        {
+            std::snprintf(name, sizeof(name), "valid%s", suffixes[i]);
+            writer.add(name, as_span(arrays[i]).as_const());
+
+            std::snprintf(name, sizeof(name), "truncated%s", suffixes[i]);
+            writer.add(name, as_span(i == 2 ? truncated : arrays[i]).as_const());
+
+            std::snprintf(name, sizeof(name), "out_of_range%s", suffixes[i]);
+            writer.add(name, as_span(i == 0 ? out_of_range : arrays[i]).as_const());
+        }
+
+        ASSERT_EQ(MeshArchive::Error_None, writer.write(path.string().c_str()));
+    }
+
+    MeshArchive archive{};
+    ASSERT_EQ(MeshArchive::Error_None, archive.open(path.string().c_str()));
+
+    HalfedgeMesh dst{};
+    ASSERT_TRUE(archive.read("valid", dst));
+    isize const num_hedges = dst.num_halfedges();
+    ASSERT_GT(num_hedges, 0);
+
+    // Rejected reads leave the result unchanged
+    ASSERT_FALSE(archive.read("truncated", dst));
+    ASSERT_FALSE(archive.read("out_of_range", dst));
+    ASSERT_EQ(num_hedges, dst.num_halfedges());
+}
+
+UTEST(mesh_archive, verify_checksums)
+{
+    using namespace dr;
+
+    fs::path const path = fs::temp_directory_path() / "mesh_archive_checksum_test.drm";
+    auto _ = defer([&]() {
+        std::remove(path.string().c_str());
+    });
+
+    auto& mesh_prim = MeshPrimitives::Tri::cube();
+    auto const vert_coords = as<Vec3<f32>>(mesh_prim.vertex_positions);
+
+    {
+        MeshArchive::Writer writer{};
+        writer.add("vertex_positions", vert_coords);
+        ASSERT_EQ(MeshArchive::Error_None, writer.write(path.string().c_str()));
+    }
+
+    // Corrupt the last byte of section data
+    {
+        std::FILE* file = std::fopen(path.string().c_str(), "r+b");
+        ASSERT_TRUE(file != nullptr);
+
+        std::fseek(file, 0, SEEK_END);
+        long const size = std::ftell(file);
+
+        long const offset = size - static_cast<long>(sizeof(Vec3<f32>) * vert_coords.size());
+        std::fseek(file, offset, SEEK_SET);
+        u8 const byte = 0xFF;
+        std::fwrite(&byte, 1, 1, file);
+        std::fclose(file);
+    }
+
+    {
+        MeshArchive archive{};
+        ASSERT_EQ(MeshArchive::Error_None, archive.open(path.string().c_str()));
+    }
+
+    {
+        MeshArchive archive{};
+        ASSERT_EQ(MeshArchive::Error_ChecksumMismatch, archive.open(path.string().c_str(), true));
+        ASSERT_FALSE(archive.is_open());
+    }
+
+    {
+        MeshArchive archive{};
+        ASSERT_EQ(MeshArchive::Error_OpenFailed, archive.open("does_not_exist.drm"));
+    }
+}
@@ -255,13 +255,13 @@ template void face_vector_areas(
     Span<Vec3<f32> const> const&,
     Span<Vec3<i32> const> const&,
     Span<Vec3<f32>> const&,
-    isize const);
+    Executor const);
 
 template void face_normals(
     Span<Vec3<f32> const> const&,
     Span<Vec3<i32> const> const&,
     Span<Vec3<f32>> const&,
-    isize const);
+    Executor const);
 
 template Vec2<f32> integrate_vertex_func(
     Span<Vec3<f32> const> const&,
@@ -296,7 +296,7 @@ template Vec2<f32> interpolate_mean_value_robust(
     Span<Vec3<i32> const> const&,
     Vec3<f32> const&,
     f32 const,
-    isize const);
+    Executor const);
 
 template Vec2<f32> interpolate_mean_value_naive(
     Span<Vec3<f32> const> const&,
@@ -304,6 +304,6 @@ template Vec2<f32> interpolate_mean_value_naive(
     Span<Vec3<i32> const> const&,
     Vec3<f32> const&,
     f32 const,
-    isize const);
+    Executor const);
 
 } // namespace dr
\ No newline at end of file
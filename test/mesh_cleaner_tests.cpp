@@ -0,0 +1,137 @@
+#include <utest.h>
+
+#include <dr/container_utils.hpp>
+#include <dr/dynamic_array.hpp>
+#include <dr/math_types.hpp>
+#include <dr/mesh_cleaner.hpp>
+
+#include "test_utils.hpp"
+
+UTEST(mesh_cleaner, clean)
+{
+    using namespace dr;
+
+    // Two triangles sharing an edge with duplicated vertices, a degenerate face, a duplicate face
+    // (rotated), and an unused vertex
+    DynamicArray<Vec3<f64>> positions{
+        {0.0, 0.0, 0.0},
+        {1.0, 0.0, 0.0},
+        {0.0, 1.0, 0.0},
+        {5.0, 5.0, 5.0},
+        {1.0, 0.0, 0.0},
+        {1.0, 1.0, 0.0},
+        {0.0, 1.0, 0.0},
+    };
+
+    DynamicArray<i32> vertex_ids{0, 1, 2, 3, 4, 5, 6};
+
+    DynamicArray<Vec3<i32>> faces{
+        {0, 1, 2},
+        {0, 4, 1},
+        {4, 5, 6},
+        {1, 2, 0},
+        {2, 0, 1},
+        {6, 4, 5},
+    };
+
+    DynamicArray<i32> face_ids{0, 1, 2, 3, 4, 5};
+
+    MeshAttributeSpan const vertex_attrs[]{MeshAttributeSpan::from(as_span(vertex_ids))};
+    MeshAttributeSpan const face_attrs[]{MeshAttributeSpan::from(as_span(face_ids))};
+
+    MeshCleaner<f64, i32> cleaner{};
+    cleaner.weld_tolerance = 1.0e-8;
+
+    auto const [num_verts, num_faces] = cleaner.clean(
+        as_span(positions),
+        as_span(faces),
+        as_span(vertex_attrs),
+        as_span(face_attrs));
+
+    ASSERT_EQ(4, num_verts);
+    ASSERT_EQ(2, num_faces);
+
+    Vec3<f64> const expect_positions[]{
+        {0.0, 0.0, 0.0},
+        {1.0, 0.0, 0.0},
+        {0.0, 1.0, 0.0},
+        {1.0, 1.0, 0.0},
+    };
+    i32 const expect_vertex_ids[]{0, 1, 2, 5};
+
+    for (isize i = 0; i < num_verts; ++i)
+    {
+        ASSERT_TRUE(expect_positions[i] == positions[i]);
+        ASSERT_EQ(expect_vertex_ids[i], vertex_ids[i]);
+    }
+
+    Vec3<i32> const expect_faces[]{{0, 1, 2}, {1, 3, 2}};
+    i32 const expect_face_ids[]{0, 2};
+    for (isize i = 0; i < num_faces; ++i)
+    {
+        ASSERT_TRUE(expect_faces[i] == faces[i]);
+        ASSERT_EQ(expect_face_ids[i], face_ids[i]);
+    }
+
+    i32 const expect_new_indices[]{0, 1, 2, -1, 1, 3, 2};
+    auto const new_indices = cleaner.vertex_new_indices();
+    ASSERT_EQ(isize(7), new_indices.size());
+
+    for (isize i = 0; i < new_indices.size(); ++i)
+        ASSERT_EQ(expect_new_indices[i], new_indices[i]);
+}
+
+UTEST(mesh_cleaner, options)
+{
+    using namespace dr;
+
+    DynamicArray<Vec3<f32>> const positions{
+        {0.0f, 0.0f, 0.0f},
+        {1.0f, 0.0f, 0.0f},
+        {0.0f, 1.0f, 0.0f},
+        {1.0f, 1.0f, 0.0f},
+    };
+
+    DynamicArray<Vec3<i32>> const faces{
+        {0, 1, 2},
+        {1, 1, 2},
+        {2, 0, 1},
+        {0, 2, 1},
+    };
+
+    // Cleaner is reused across calls
+    MeshCleaner<f32, i32> cleaner{};
+
+    auto const clean = [&]() {
+        DynamicArray<Vec3<f32>> p = positions;
+        DynamicArray<Vec3<i32>> f = faces;
+        return cleaner.clean(as_span(p), as_span(f));
+    };
+
+    {
+        auto const [num_verts, num_faces] = clean();
+        ASSERT_EQ(3, num_verts);
+        ASSERT_EQ(2, num_faces);
+    }
+
+    cleaner.remove_duplicate_faces = false;
+    {
+        auto const [num_verts, num_faces] = clean();
+        ASSERT_EQ(3, num_verts);
+        ASSERT_EQ(3, num_faces);
+    }
+
+    cleaner.remove_degenerate_faces = false;
+    {
+        auto const [num_verts, num_faces] = clean();
+        ASSERT_EQ(3, num_verts);
+        ASSERT_EQ(4, num_faces);
+    }
+
+    cleaner.remove_unused_vertices = false;
+    {
+        auto const [num_verts, num_faces] = clean();
+        ASSERT_EQ(4, num_verts);
+        ASSERT_EQ(4, num_faces);
+    }
+}
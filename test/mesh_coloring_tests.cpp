@@ -0,0 +1,196 @@
+#include <utest.h>
+
+#include <dr/container_utils.hpp>
+#include <dr/dynamic_array.hpp>
+#include <dr/mesh_attributes.hpp>
+#include <dr/mesh_coloring.hpp>
+#include <dr/mesh_operators.hpp>
+#include <dr/mesh_primitives.hpp>
+#include <dr/random.hpp>
+#include <dr/sliced_array.hpp>
+
+#include "test_utils.hpp"
+
+namespace
+{
+
+template <typename Index, int size>
+bool is_valid_coloring(
+    dr::Span<dr::Vec<Index, size> const> const& element_vertices,
+    dr::SlicedArray<Index> const& element_colors,
+    dr::isize const num_vertices)
+{
+    using namespace dr;
+
+    if (element_colors.num_items() != element_vertices.size())
+        return false;
+
+    DynamicArray<bool> visited(element_vertices.size(), false);
+
+    for (isize c = 0; c < element_colors.num_slices(); ++c)
+    {
+        // Each vertex is used by at most one element of each color
+        DynamicArray<bool> used(num_vertices, false);
+
+        for (Index const e : element_colors[c])
+        {
+            if (visited[e])
+                return false;
+
+            visited[e] = true;
+
+            for (int j = 0; j < size; ++j)
+            {
+                Index const v = element_vertices[e][j];
+                if (used[v])
+                    return false;
+
+                used[v] = true;
+            }
+        }
+    }
+
+    return true;
+}
+
+} // namespace
+
+UTEST(mesh_coloring, color_elements)
+{
+    using namespace dr;
+
+    {
+        using MeshPrims = MeshPrimitives::Tri;
+        auto const f_v = as<Vec3<i16>>(MeshPrims::icosahedron().face_vertices);
+        isize const num_verts = MeshPrims::icosahedron().vertex_positions.size();
+
+        SlicedArray<i16> colors{};
+        color_elements(f_v, colors);
+        ASSERT_TRUE(is_valid_coloring(f_v, colors, num_verts));
+    }
+
+    {
+        using MeshPrims = MeshPrimitives::Tet;
+        auto const c_v = as<Vec4<i16>>(MeshPrims::cube().cell_vertices);
+        isize const num_verts = MeshPrims::cube().vertex_positions.size();
+
+        SlicedArray<i16> colors{};
+        color_elements(c_v, colors);
+        ASSERT_TRUE(is_valid_coloring(c_v, colors, num_verts));
+    }
+
+    // Result should be independent of thread count
+    {
+        DynamicArray<Vec3<f64>> v_p{};
+        DynamicArray<Vec3<i32>> f_v{};
+        make_grid_mesh(20, v_p, f_v);
+
+        SlicedArray<i32> colors{};
+        color_elements(as_span(f_v).as_const(), colors, i32(size(v_p)));
+        ASSERT_TRUE(is_valid_coloring(as_span(f_v).as_const(), colors, size(v_p)));
+
+        // Each vertex of a triangulated grid is shared by at most 6 faces
+        ASSERT_LE(colors.num_slices(), 12);
+
+        SlicedArray<i32> colors_par{};
+        color_elements(as_span(f_v).as_const(), colors_par, -1, Executor{4});
+        ASSERT_TRUE(colors.items == colors_par.items);
+        ASSERT_TRUE(colors.slice_ends == colors_par.slice_ends);
+    }
+
+    // Empty
+    {
+        SlicedArray<i32> colors{};
+        color_elements(Span<Vec3<i32> const>{}, colors);
+        ASSERT_EQ(0, colors.num_slices());
+    }
+}
+
+UTEST(mesh_coloring, scatter_kernels)
+{
+    using namespace dr;
+
+    constexpr f64 eps = 1.0e-10;
+
+    DynamicArray<Vec3<f64>> v_p{};
+    DynamicArray<Vec3<i32>> f_v{};
+    make_grid_mesh(20, v_p, f_v);
+
+    isize const num_verts = size(v_p);
+    isize const num_faces = size(f_v);
+
+    SlicedArray<i32> colors{};
+    color_elements(as_span(f_v).as_const(), colors, i32(num_verts), Executor{4});
+
+    Random<> rand{2};
+    auto gen = rand.generator(-1.0, 1.0);
+
+    DynamicArray<f64> v_s(num_verts);
+    for (f64& s : v_s)
+        s = gen();
+
+    DynamicArray<Vec3<f64>> f_vec(num_faces);
+    for (Vec3<f64>& v : f_vec)
+        v = {gen(), gen(), gen()};
+
+    // Laplacian
+    {
+        DynamicArray<f64> expect(num_verts);
+        eval_laplacian(
+            as_span(v_p).as_const(),
+            as_span(v_s).as_const(),
+            as_span(f_v).as_const(),
+            as_span(expect));
+
+        DynamicArray<f64> result(num_verts);
+        eval_laplacian(
+            as_span(v_p).as_const(),
+            as_span(v_s).as_const(),
+            as_span(f_v).as_const(),
+            colors,
+            as_span(result),
+            Executor{4});
+
+        for (isize i = 0; i < num_verts; ++i)
+            ASSERT_NEAR(expect[i], result[i], eps);
+    }
+
+    // Divergence
+    {
+        DynamicArray<f64> expect(num_verts);
+        eval_divergence(
+            as_span(v_p).as_const(),
+            as_span(f_v).as_const(),
+            as_span(f_vec).as_const(),
+            as_span(expect));
+
+        DynamicArray<f64> result(num_verts);
+        eval_divergence(
+            as_span(v_p).as_const(),
+            as_span(f_v).as_const(),
+            colors,
+            as_span(f_vec).as_const(),
+            as_span(result),
+            Executor{4});
+
+        for (isize i = 0; i < num_verts; ++i)
+            ASSERT_NEAR(expect[i], result[i], eps);
+    }
+
+    // Vertex vector areas
+    {
+        DynamicArray<Vec3<f64>> expect(num_verts);
+        vertex_vector_areas(as_span(v_p).as_const(), as_span(f_v).as_const(), as_span(expect));
+
+        DynamicArray<Vec3<f64>> result(num_verts);
+        vertex_vector_areas(
+            as_span(v_p).as_const(),
+            as_span(f_v).as_const(),
+            colors,
+            as_span(result),
+            Executor{4});
+
+        for (isize i = 0; i < num_verts; ++i)
+            ASSERT_LT((expect[i] - result[i]).norm(), eps);
+    }
+}
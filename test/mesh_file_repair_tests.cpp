@@ -0,0 +1,259 @@
+#include <utest.h>
+
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <utility>
+
+#include <dr/defer.hpp>
+#include <dr/dynamic_array.hpp>
+#include <dr/math_constants.hpp>
+#include <dr/math_types.hpp>
+#include <dr/mesh_file_repair.hpp>
+#include <dr/mesh_io.hpp>
+#include <dr/random.hpp>
+#include <dr/sliced_array.hpp>
+
+namespace fs = std::filesystem;
+
+UTEST(mesh_file_repair, weld_triangle_soup)
+{
+    using namespace dr;
+
+    std::string const temp_dir = fs::temp_directory_path().string();
+    fs::path const src_path = fs::path{temp_dir} / "mesh_file_repair_src.obj";
+    fs::path const dst_path = fs::path{temp_dir} / "mesh_file_repair_dst.ply";
+    auto _ = defer([&]() {
+        std::remove(src_path.string().c_str());
+        std::remove(dst_path.string().c_str());
+    });
+
+    constexpr i32 nx = 30;
+    constexpr i32 ny = 20;
+
+    for (f64 const tol : {0.0, 0.05})
+    {
+        // Split a grid of quads into a soup of triangles with jittered vertices
+        DynamicArray<Vec3<f64>> src_verts{};
+        SlicedArray<i32> src_faces{};
+        {
+            Random<> rand{1};
+            auto jitter = rand.generator(-0.25 * tol, 0.25 * tol);
+
+            auto const add_vertex = [&](i32 const i, i32 const j) -> i32 {
+                Vec3<f64> p{f64(i), f64(j), 0.0};
+                for (isize k = 0; k < 3; ++k)
+                    p[k] += jitter();
+
+                src_verts.push_back(p);
+                return i32(src_verts.size() - 1);
+            };
+
+            for (i32 j = 0; j + 1 < ny; ++j)
+            {
+                for (i32 i = 0; i + 1 < nx; ++i)
+                {
+                    i32 const f0[]{
+                        add_vertex(i, j),
+                        add_vertex(i + 1, j),
+                        add_vertex(i + 1, j + 1),
+                    };
+                    i32 const f1[]{
+                        add_vertex(i, j),
+                        add_vertex(i + 1, j + 1),
+                        add_vertex(i, j + 1),
+                    };
+                    src_faces.push_back(as_span(f0));
+                    src_faces.push_back(as_span(f1));
+                }
+            }
+
+            // Unused vertex
+            src_verts.emplace_back(100.0, 100.0, 100.0);
+
+            // Degenerate face
+            i32 const f[]{add_vertex(0, 0), add_vertex(0, 0), add_vertex(1, 0)};
+            src_faces.push_back(as_span(f));
+        }
+
+        MeshIO::Error err = write_mesh(
+            src_path.string().c_str(),
+            MeshIO::Format_Obj,
+            as_span(src_verts).as_const(),
+            src_faces);
+
+        ASSERT_EQ(MeshIO::Error_None, err);
+
+        // Use small limits to exercise tiling, halos, and blocking
+        MeshFileRepair::Options options{};
+        options.temp_dir = temp_dir.c_str();
+        options.temp_prefix = "mesh_file_repair_test";
+        options.weld_tolerance = tol;
+        options.max_corners_per_tile = 256;
+        options.max_vertices_per_block = 100;
+        options.max_faces_per_block = 50;
+        options.buffer_size = 64;
+
+        MeshFileRepair::Stats stats{};
+        err = repair_mesh_file(
+            src_path.string().c_str(),
+            dst_path.string().c_str(),
+            options,
+            &stats);
+
+        ASSERT_EQ(MeshIO::Error_None, err);
+        ASSERT_EQ(isize(src_verts.size()), stats.num_input_vertices);
+        ASSERT_EQ(isize(src_faces.num_slices()), stats.num_input_faces);
+        ASSERT_EQ(isize(nx * ny), stats.num_vertices);
+        ASSERT_EQ(isize((nx - 1) * (ny - 1) * 2), stats.num_faces);
+        ASSERT_TRUE(stats.num_tiles > 1);
+
+        DynamicArray<Vec3<f64>> dst_verts{};
+        SlicedArray<i32> dst_faces{};
+        err = read_mesh(dst_path.string().c_str(), dst_verts, dst_faces);
+
+        ASSERT_EQ(MeshIO::Error_None, err);
+        ASSERT_EQ(stats.num_vertices, isize(dst_verts.size()));
+        ASSERT_EQ(stats.num_faces, isize(dst_faces.num_slices()));
+
+        // Each grid point should map to exactly one vertex
+        std::map<std::pair<i32, i32>, i32> grid_to_vert{};
+        for (isize v = 0; v < isize(dst_verts.size()); ++v)
+        {
+            Vec3<f64> const& p = dst_verts[v];
+            std::pair<i32, i32> const key{i32(std::round(p[0])), i32(std::round(p[1]))};
+            ASSERT_TRUE(grid_to_vert.emplace(key, i32(v)).second);
+        }
+
+        // Faces should reference the vertices of the original grid
+        for (i32 f = 0; f < dst_faces.num_slices(); ++f)
+        {
+            auto const face = dst_faces[f];
+            ASSERT_EQ(isize(3), face.size());
+
+            for (i32 const v : face)
+            {
+                ASSERT_TRUE(v >= 0 && v < i32(dst_verts.size()));
+                std::pair<i32, i32> const key{
+                    i32(std::round(dst_verts[v][0])),
+                    i32(std::round(dst_verts[v][1])),
+                };
+                ASSERT_EQ(v, grid_to_vert[key]);
+            }
+        }
+    }
+}
+
+UTEST(mesh_file_repair, weld_skewed)
+{
+    using namespace dr;
+
+    std::string const temp_dir = fs::temp_directory_path().string();
+    fs::path const src_path = fs::path{temp_dir} / "mesh_file_repair_skewed_src.obj";
+    fs::path const dst_path = fs::path{temp_dir} / "mesh_file_repair_skewed_dst.ply";
+    auto _ = defer([&]() {
+        std::remove(src_path.string().c_str());
+        std::remove(dst_path.string().c_str());
+    });
+
+    constexpr i32 n = 1000;
+    constexpr f64 tol = 0.01;
+
+    // Split a dense fan of triangles into a soup along with a single distant triangle. Every
+    // triangle in the fan has its own copy of the center vertex.
+    DynamicArray<Vec3<f64>> src_verts{};
+    SlicedArray<i32> src_faces{};
+    {
+        Random<> rand{1};
+        auto jitter = rand.generator(-0.25 * tol, 0.25 * tol);
+
+        auto const add_vertex = [&](Vec3<f64> p) -> i32 {
+            for (isize k = 0; k < 3; ++k)
+                p[k] += jitter();
+
+            src_verts.push_back(p);
+            return i32(src_verts.size() - 1);
+        };
+
+        auto const rim_point = [&](i32 const i) -> Vec3<f64> {
+            f64 const t = 2.0 * pi<f64> * f64(i) / f64(n);
+            return {10.0 * std::cos(t), 10.0 * std::sin(t), 0.0};
+        };
+
+        for (i32 i = 0; i < n; ++i)
+        {
+            src_verts.emplace_back(0.0, 0.0, 0.0);
+            i32 const f[]{
+                i32(src_verts.size() - 1),
+                add_vertex(rim_point(i)),
+                add_vertex(rim_point((i + 1) % n)),
+            };
+            src_faces.push_back(as_span(f));
+        }
+
+        i32 const f[]{
+            add_vertex({1000.0, 1000.0, 1000.0}),
+            add_vertex({1001.0, 1000.0, 1000.0}),
+            add_vertex({1000.0, 1001.0, 1000.0}),
+        };
+        src_faces.push_back(as_span(f));
+    }
+
+    MeshIO::Error err = write_mesh(
+        src_path.string().c_str(),
+        MeshIO::Format_Obj,
+        as_span(src_verts).as_const(),
+        src_faces);
+
+    ASSERT_EQ(MeshIO::Error_None, err);
+
+    MeshFileRepair::Options options{};
+    options.temp_dir = temp_dir.c_str();
+    options.temp_prefix = "mesh_file_repair_skewed_test";
+    options.weld_tolerance = tol;
+    options.max_corners_per_tile = 256;
+    options.buffer_size = 64;
+
+    MeshFileRepair::Stats stats{};
+    err = repair_mesh_file(
+        src_path.string().c_str(),
+        dst_path.string().c_str(),
+        options,
+        &stats);
+
+    ASSERT_EQ(MeshIO::Error_None, err);
+    ASSERT_EQ(isize(n + 4), stats.num_vertices);
+    ASSERT_EQ(isize(n + 1), stats.num_faces);
+    ASSERT_TRUE(stats.num_tiles > 1);
+    ASSERT_TRUE(stats.max_tile_corners <= options.max_corners_per_tile);
+
+    DynamicArray<Vec3<f64>> dst_verts{};
+    SlicedArray<i32> dst_faces{};
+    err = read_mesh(dst_path.string().c_str(), dst_verts, dst_faces);
+
+    ASSERT_EQ(MeshIO::Error_None, err);
+    ASSERT_EQ(stats.num_vertices, isize(dst_verts.size()));
+    ASSERT_EQ(stats.num_faces, isize(dst_faces.num_slices()));
+
+    // Output vertices should be farther than tolerance from each other
+    for (isize i = 0; i < isize(dst_verts.size()); ++i)
+    {
+        for (isize j = i + 1; j < isize(dst_verts.size()); ++j)
+            ASSERT_TRUE((dst_verts[i] - dst_verts[j]).norm() > tol);
+    }
+
+    // All fan triangles should share the center vertex
+    isize num_center = 0;
+    for (i32 f = 0; f < dst_faces.num_slices(); ++f)
+    {
+        for (i32 const v : dst_faces[f])
+        {
+            if (dst_verts[v].norm() < tol)
+                ++num_center;
+        }
+    }
+
+    ASSERT_EQ(isize(n), num_center);
+}
@@ -0,0 +1,337 @@
+#include <utest.h>
+
+#include <cstdio>
+#include <filesystem>
+
+#include <dr/defer.hpp>
+#include <dr/mesh_io.hpp>
+#include <dr/mesh_primitives.hpp>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+void write_text_file(fs::path const& path, char const* text)
+{
+    std::FILE* file = std::fopen(path.string().c_str(), "wb");
+    std::fputs(text, file);
+    std::fclose(file);
+}
+
+template <typename Real, typename Index>
+void make_grid(
+    Index const nx,
+    Index const ny,
+    dr::DynamicArray<dr::Vec3<Real>>& vertex_positions,
+    dr::SlicedArray<Index>& face_vertices)
+{
+    for (Index j = 0; j < ny; ++j)
+    {
+        for (Index i = 0; i < nx; ++i)
+            vertex_positions.emplace_back(Real(i) * Real(0.1), Real(j) * Real(-0.25), Real(i + j));
+    }
+
+    for (Index j = 0; j + 1 < ny; ++j)
+    {
+        for (Index i = 0; i + 1 < nx; ++i)
+        {
+            Index const v0 = i + j * nx;
+            Index const face[]{v0, v0 + 1, v0 + nx + 1, v0 + nx};
+            face_vertices.push_back(dr::as_span(face));
+        }
+    }
+}
+
+} // namespace
+
+UTEST(mesh_io, read_obj)
+{
+    using namespace dr;
+
+    fs::path const path = fs::temp_directory_path() / "mesh_io_read_obj_test.obj";
+    auto _ = defer([&]() {
+        std::remove(path.string().c_str());
+    });
+
+    write_text_file(
+        path,
+        "# Comment\n"
+        "o square\n"
+        "v 0.0 0.0 0.0\n"
+        "v 1.0 0.0 0.0\r\n"
+        "vt 0.0 0.0\n"
+        "vn 0.0 0.0 1.0\n"
+        "v 1.0 1.5e1 -0.25\n"
+        "  v 0 1 0\n"
+        "f 1/1/1 2/1/1 3/1/1\n"
+        "f -4//1 -2//1 -1//1\n"
+        "f 1 2 3 4");
+
+    DynamicArray<Vec3<f64>> verts{};
+    SlicedArray<i32> faces{};
+    ASSERT_EQ(MeshIO::Error_None, read_mesh(path.string().c_str(), verts, faces));
+
+    ASSERT_EQ(4, size(verts));
+    ASSERT_EQ(3, faces.num_slices());
+    ASSERT_TRUE(verts[2] == Vec3<f64>(1.0, 15.0, -0.25));
+    ASSERT_TRUE(verts[3] == Vec3<f64>(0.0, 1.0, 0.0));
+
+    i32 const expect_items[]{0, 1, 2, 0, 2, 3, 0, 1, 2, 3};
+    i32 const expect_ends[]{3, 6, 10};
+
+    ASSERT_EQ(size(expect_items), size(faces.items));
+    for (isize i = 0; i < size(expect_items); ++i)
+        ASSERT_EQ(expect_items[i], faces.items[i]);
+
+    ASSERT_EQ(size(expect_ends), size(faces.slice_ends));
+    for (isize i = 0; i < size(expect_ends); ++i)
+        ASSERT_EQ(expect_ends[i], faces.slice_ends[i]);
+}
+
+UTEST(mesh_io, read_ply)
+{
+    using namespace dr;
+
+    fs::path const path = fs::temp_directory_path() / "mesh_io_read_ply_test.ply";
+    auto _ = defer([&]() {
+        std::remove(path.string().c_str());
+    });
+
+    write_text_file(
+        path,
+        "ply\n"
+        "format ascii 1.0\n"
+        "comment Extra elements and properties should be skipped\n"
+        "element vertex 3\n"
+        "property float x\n"
+        "property float nx\n"
+        "property float y\n"
+        "property float z\n"
+        "property list uchar float uv\n"
+        "element material 1\n"
+        "property uchar r\n"
+        "element face 1\n"
+        "property uchar flags\n"
+        "property list uchar uint vertex_indices\n"
+        "end_header\n"
+        "0 9 0 0 2 0.5 0.5\n"
+        "\n"
+        "1 9 0 0.250000000000000000000001 0\n"
+        "  \r\n"
+        "0 9 1 0.5 1 1\n"
+        "255\n"
+        "7 3 2 1 0\n"
+        "\n");
+
+    MeshIO::Reader reader{};
+    ASSERT_EQ(MeshIO::Error_None, reader.open(path.string().c_str()));
+    ASSERT_EQ(MeshIO::Format_PlyAscii, reader.format());
+    ASSERT_EQ(3, reader.num_vertices_hint());
+    ASSERT_EQ(1, reader.num_faces_hint());
+
+    MeshIO::Chunk<f32, i32> chunk{};
+    ASSERT_TRUE(reader.read(chunk));
+    ASSERT_EQ(3, size(chunk.vertex_positions));
+    ASSERT_TRUE(chunk.vertex_positions[1] == Vec3<f32>(1.0f, 0.0f, 0.25f));
+    ASSERT_TRUE(chunk.vertex_positions[2] == Vec3<f32>(0.0f, 1.0f, 0.5f));
+
+    ASSERT_EQ(1, chunk.face_vertices.num_slices());
+    ASSERT_EQ(2, chunk.face_vertices[0][0]);
+    ASSERT_EQ(0, chunk.face_vertices[0][2]);
+
+    ASSERT_FALSE(reader.read(chunk));
+    ASSERT_EQ(MeshIO::Error_None, reader.error());
+}
+
+UTEST(mesh_io, read_invalid)
+{
+    using namespace dr;
+
+    fs::path const path = fs::temp_directory_path() / "mesh_io_read_invalid_test.obj";
+    auto _ = defer([&]() {
+        std::remove(path.string().c_str());
+    });
+
+    DynamicArray<Vec3<f64>> verts{};
+    SlicedArray<i32> faces{};
+
+    ASSERT_EQ(MeshIO::Error_OpenFailed, read_mesh("does_not_exist.obj", verts, faces));
+
+    write_text_file(path, "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 x\n");
+    ASSERT_EQ(MeshIO::Error_InvalidData, read_mesh(path.string().c_str(), verts, faces));
+
+    // Vertices must have x, y, and z properties
+    write_text_file(
+        path,
+        "ply\n"
+        "format ascii 1.0\n"
+        "element vertex 1\n"
+        "property float x\n"
+        "end_header\n");
+    ASSERT_EQ(MeshIO::Error_InvalidHeader, read_mesh(path.string().c_str(), verts, faces));
+}
+
+UTEST(mesh_io, write_read)
+{
+    using namespace dr;
+
+    fs::path const path = fs::temp_directory_path() / "mesh_io_write_read_test";
+    auto _ = defer([&]() {
+        std::remove(path.string().c_str());
+    });
+
+    DynamicArray<Vec3<f32>> src_verts{};
+    SlicedArray<i32> src_faces{};
+    make_grid(200, 150, src_verts, src_faces);
+
+    MeshIO::Format const formats[]{
+        MeshIO::Format_Obj,
+        MeshIO::Format_PlyAscii,
+        MeshIO::Format_PlyBinaryLE,
+        MeshIO::Format_PlyBinaryBE,
+    };
+
+    for (MeshIO::Format const format : formats)
+    {
+        for (isize const num_threads : {1, 4})
+        {
+            MeshIO::Error err = write_mesh(
+                path.string().c_str(),
+                format,
+                as_span(src_verts).as_const(),
+                src_faces,
+                Executor{num_threads});
+
+            ASSERT_EQ(MeshIO::Error_None, err);
+
+            DynamicArray<Vec3<f32>> dst_verts{};
+            SlicedArray<i32> dst_faces{};
+            err = read_mesh(path.string().c_str(), dst_verts, dst_faces, Executor{num_threads});
+            ASSERT_EQ(MeshIO::Error_None, err);
+
+            ASSERT_EQ(size(src_verts), size(dst_verts));
+            for (isize i = 0; i < size(src_verts); ++i)
+                ASSERT_TRUE(src_verts[i] == dst_verts[i]);
+
+            ASSERT_EQ(size(src_faces.items), size(dst_faces.items));
+            for (isize i = 0; i < size(src_faces.items); ++i)
+                ASSERT_EQ(src_faces.items[i], dst_faces.items[i]);
+
+            ASSERT_EQ(size(src_faces.slice_ends), size(dst_faces.slice_ends));
+            for (isize i = 0; i < size(src_faces.slice_ends); ++i)
+                ASSERT_EQ(src_faces.slice_ends[i], dst_faces.slice_ends[i]);
+        }
+    }
+}
+
+UTEST(mesh_io, write_large_face)
+{
+    using namespace dr;
+
+    fs::path const path = fs::temp_directory_path() / "mesh_io_write_large_face_test";
+    auto _ = defer([&]() {
+        std::remove(path.string().c_str());
+    });
+
+    // Polygon with more vertices than a binary PLY face can store
+    constexpr i32 n = 300;
+
+    DynamicArray<Vec3<f32>> src_verts{};
+    SlicedArray<i32> src_faces{};
+    {
+        DynamicArray<i32> face{};
+
+        for (i32 i = 0; i < n; ++i)
+        {
+            src_verts.emplace_back(f32(i), 0.0f, 0.0f);
+            face.push_back(i);
+        }
+
+        src_faces.push_back(as_span(face).as_const());
+    }
+
+    for (MeshIO::Format const format : {MeshIO::Format_PlyBinaryLE, MeshIO::Format_PlyBinaryBE})
+    {
+        MeshIO::Error const err =
+            write_mesh(path.string().c_str(), format, as_span(src_verts).as_const(), src_faces);
+
+        ASSERT_EQ(MeshIO::Error_InvalidData, err);
+    }
+
+    for (MeshIO::Format const format : {MeshIO::Format_Obj, MeshIO::Format_PlyAscii})
+    {
+        MeshIO::Error err =
+            write_mesh(path.string().c_str(), format, as_span(src_verts).as_const(), src_faces);
+
+        ASSERT_EQ(MeshIO::Error_None, err);
+
+        DynamicArray<Vec3<f32>> dst_verts{};
+        SlicedArray<i32> dst_faces{};
+        err = read_mesh(path.string().c_str(), dst_verts, dst_faces);
+
+        ASSERT_EQ(MeshIO::Error_None, err);
+        ASSERT_EQ(isize(n), size(dst_verts));
+        ASSERT_EQ(1, dst_faces.num_slices());
+        ASSERT_EQ(isize(n), dst_faces[0].size());
+    }
+}
+
+UTEST(mesh_io, read_chunked)
+{
+    using namespace dr;
+
+    fs::path const path = fs::temp_directory_path() / "mesh_io_read_chunked_test";
+    auto _ = defer([&]() {
+        std::remove(path.string().c_str());
+    });
+
+    DynamicArray<Vec3<f64>> src_verts{};
+    SlicedArray<i64> src_faces{};
+    make_grid<f64, i64>(50, 40, src_verts, src_faces);
+
+    for (MeshIO::Format const format : {MeshIO::Format_Obj, MeshIO::Format_PlyBinaryLE})
+    {
+        MeshIO::Error const err = write_mesh(
+            path.string().c_str(),
+            format,
+            as_span(src_verts).as_const(),
+            src_faces);
+
+        ASSERT_EQ(MeshIO::Error_None, err);
+
+        MeshIO::Reader reader{};
+        ASSERT_EQ(MeshIO::Error_None, reader.open(path.string().c_str(), 1024));
+
+        // Consume the file one chunk at a time
+        MeshIO::Chunk<f64, i64> chunk{};
+        isize num_chunks = 0;
+        isize num_verts = 0;
+        isize num_faces = 0;
+
+        while (reader.read(chunk))
+        {
+            for (isize i = 0; i < size(chunk.vertex_positions); ++i)
+                ASSERT_TRUE(src_verts[num_verts + i] == chunk.vertex_positions[i]);
+
+            for (isize i = 0; i < chunk.face_vertices.num_slices(); ++i)
+            {
+                auto const a = src_faces[num_faces + i];
+                auto const b = chunk.face_vertices[i];
+                ASSERT_EQ(a.size(), b.size());
+
+                for (isize j = 0; j < a.size(); ++j)
+                    ASSERT_EQ(a[j], b[j]);
+            }
+
+            num_verts += size(chunk.vertex_positions);
+            num_faces += chunk.face_vertices.num_slices();
+            ++num_chunks;
+        }
+
+        ASSERT_EQ(MeshIO::Error_None, reader.error());
+        ASSERT_EQ(size(src_verts), num_verts);
+        ASSERT_EQ(src_faces.num_slices(), num_faces);
+        ASSERT_LT(1, num_chunks);
+    }
+}
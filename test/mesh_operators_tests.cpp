@@ -26,14 +26,14 @@ template void eval_gradient(
     Span<f32 const> const&,
     Span<Vec3<i32> const> const&,
     Span<Covec3<f32>> const&,
-    isize);
+    Executor);
 
 template void eval_jacobian(
     Span<Vec3<f32> const> const&,
     Span<Vec3<f32> const> const&,
     Span<Vec3<i32> const> const&,
     Span<Mat3<f32>> const&,
-    isize);
+    Executor);
 
 template void eval_divergence(
     Span<Vec3<f32> const> const&,
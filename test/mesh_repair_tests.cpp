@@ -1,7 +1,9 @@
 #include <utest.h>
 
+#include <dr/container_utils.hpp>
 #include <dr/dynamic_array.hpp>
 #include <dr/mesh_repair.hpp>
+#include <dr/random.hpp>
 
 #include "test_utils.hpp"
 
@@ -103,6 +105,142 @@ UTEST(mesh_repair, find_unique_points)
 
         ASSERT_TRUE(all_equal(as_span(pt_to_unique), as_span(result.point_to_unique)));
         ASSERT_TRUE(all_equal(as_span(unique_pts), as_span(result.unique_points)));
+
+        find_unique_points(as_span(points), tol, unique_pts, as_span(pt_to_unique), Executor{2});
+
+        ASSERT_TRUE(all_equal(as_span(pt_to_unique), as_span(result.point_to_unique)));
+        ASSERT_TRUE(all_equal(as_span(unique_pts), as_span(result.unique_points)));
+    }
+}
+
+UTEST(mesh_repair, find_unique_points_tie_break)
+{
+    using namespace dr;
+
+    // The last point is within tolerance of both unique points. It should map to the one with the
+    // lowest index rather than the nearest one or the last one found.
+    DynamicArray<Vec2<f64>> const points{
+        {0.0, 0.0},
+        {1.5, 0.0},
+        {1.0, 0.0},
+    };
+    constexpr f64 tol = 1.0;
+
+    i32 const expect_unique[]{0, 1};
+    i32 const expect_to_unique[]{0, 1, 0};
+
+    DynamicArray<i32> unique_pts{};
+    DynamicArray<i32> pt_to_unique(size(points), -1);
+    HashGrid2<f64> grid{};
+
+    find_unique_points(as_span(points).as_const(), grid, tol, unique_pts, as_span(pt_to_unique));
+    ASSERT_TRUE(all_equal(as_span(unique_pts), as_span(expect_unique)));
+    ASSERT_TRUE(all_equal(as_span(pt_to_unique), as_span(expect_to_unique)));
+}
+
+UTEST(mesh_repair, find_unique_points_parallel)
+{
+    using namespace dr;
+
+    // Clusters of nearby points in random order along with a chain of points spaced closer than
+    // the tolerance (which requires sequential resolution)
+    constexpr f64 tol = 1.0e-3;
+    constexpr isize num_clusters = 500;
+
+    Random<> rand{1};
+    auto gen = rand.generator(-1.0, 1.0);
+
+    DynamicArray<Vec3<f64>> points{};
+    for (isize i = 0; i < num_clusters; ++i)
+    {
+        Vec3<f64> const c{gen(), gen(), gen()};
+        isize const num_copies = 1 + i % 4;
+
+        for (isize j = 0; j < num_copies; ++j)
+            points.push_back(c + Vec3<f64>{gen(), gen(), gen()} * (0.5 * tol));
+    }
+
+    for (isize i = 0; i < 100; ++i)
+        points.push_back(Vec3<f64>{2.0 + f64(i) * 0.4 * tol, 0.0, 0.0});
+
+    for (isize i = size(points) - 1; i > 0; --i)
+        std::swap(points[i], points[isize((gen() * 0.5 + 0.5) * f64(i))]);
+
+    HashGrid3<f64> grid{};
+    DynamicArray<i32> expect_unique{};
+    DynamicArray<i32> expect_to_unique(size(points));
+    find_unique_points(
+        as_span(points).as_const(),
+        grid,
+        tol,
+        expect_unique,
+        as_span(expect_to_unique));
+
+    for (isize const num_threads : {1, 4})
+    {
+        DynamicArray<i32> unique_pts{};
+        DynamicArray<i32> pt_to_unique(size(points));
+        find_unique_points(
+            as_span(points).as_const(),
+            tol,
+            unique_pts,
+            as_span(pt_to_unique),
+            Executor{num_threads});
+
+        ASSERT_TRUE(all_equal(as_span(unique_pts), as_span(expect_unique)));
+        ASSERT_TRUE(all_equal(as_span(pt_to_unique), as_span(expect_to_unique)));
+    }
+
+    // Empty input
+    {
+        DynamicArray<i32> unique_pts{};
+        find_unique_points(Span<Vec3<f64> const>{}, tol, unique_pts, Span<i32>{}, Executor{4});
+        ASSERT_EQ(0, size(unique_pts));
+    }
+}
+
+UTEST(mesh_repair, find_unique_points_coincident)
+{
+    using namespace dr;
+
+    // Triangle soups have several coincident copies of each vertex. Each cluster should be resolved
+    // in two rounds regardless of its size, without falling back to sequential resolution.
+    constexpr f64 tol = 1.0e-6;
+    constexpr isize num_clusters = 100;
+    constexpr isize num_copies = 32;
+
+    Random<> rand{2};
+    auto gen = rand.generator(-1.0, 1.0);
+
+    DynamicArray<Vec3<f64>> centers(num_clusters);
+    for (Vec3<f64>& c : centers)
+        c = {gen(), gen(), gen()};
+
+    // Copies are interleaved as they would be in a triangle soup
+    DynamicArray<Vec3<f64>> points{};
+    for (isize j = 0; j < num_copies; ++j)
+    {
+        for (Vec3<f64> const& c : centers)
+            points.push_back(c);
+    }
+
+    for (isize const num_threads : {1, 4})
+    {
+        DynamicArray<i32> unique_pts{};
+        DynamicArray<i32> pt_to_unique(size(points));
+        FindUniquePointsStats const stats = find_unique_points(
+            as_span(points).as_const(),
+            tol,
+            unique_pts,
+            as_span(pt_to_unique),
+            Executor{num_threads});
+
+        ASSERT_EQ(2, stats.num_rounds);
+        ASSERT_EQ(0, stats.num_sequential);
+        ASSERT_EQ(num_clusters, size(unique_pts));
+
+        for (isize i = 0; i < size(points); ++i)
+            ASSERT_EQ(i32(i % num_clusters), pt_to_unique[i]);
     }
 }
 
@@ -193,6 +331,36 @@ UTEST(mesh_repair, gather_points)
 
             ASSERT_EQ(size(unique_pts), result.num_unique_after);
         }
+
+        // Jacobi iteration should also converge and be independent of thread count
+        DynamicArray<Vec2<f64>> points_serial{};
+
+        for (isize const num_threads : {1, 4})
+        {
+            points = points_in;
+            bool const converged_jacobi = gather_points_jacobi(
+                as_span(points),
+                grid,
+                rad_start,
+                rad_end,
+                10,
+                Executor{num_threads});
+            ASSERT_TRUE(converged_jacobi);
+
+            find_unique_points(
+                as_span(points).as_const(),
+                grid,
+                tol,
+                unique_pts,
+                as_span(pt_to_unique));
+
+            ASSERT_EQ(size(unique_pts), result.num_unique_after);
+
+            if (num_threads == 1)
+                points_serial = points;
+            else
+                ASSERT_TRUE(all_equal(as_span(points), as_span(points_serial)));
+        }
     }
 }
 
@@ -0,0 +1,117 @@
+#include <utest.h>
+
+#include <cmath>
+
+#include <dr/container_utils.hpp>
+#include <dr/dynamic_array.hpp>
+#include <dr/math_types.hpp>
+#include <dr/mesh_attributes.hpp>
+#include <dr/mesh_primitives.hpp>
+#include <dr/mesh_sdf.hpp>
+
+namespace
+{
+
+template <typename Real, typename Index>
+Real brute_force_distance(
+    dr::Span<dr::Vec3<Real> const> const& vertex_positions,
+    dr::Span<dr::Vec3<Index> const> const& face_vertices,
+    dr::Vec3<Real> const& point)
+{
+    using namespace dr;
+
+    Real result = std::numeric_limits<Real>::infinity();
+
+    for (auto const& f_v : face_vertices)
+    {
+        Vec3<Real> const& a = vertex_positions[f_v[0]];
+        Vec3<Real> const& b = vertex_positions[f_v[1]];
+        Vec3<Real> const& c = vertex_positions[f_v[2]];
+
+        Vec3<Real> const w = nearest_point_tri(point, a, b, c);
+        result = std::min(result, (point - (a * w[0] + b * w[1] + c * w[2])).norm());
+    }
+
+    return result;
+}
+
+} // namespace
+
+UTEST(mesh_sdf, signed_distance_field)
+{
+    using namespace dr;
+
+    constexpr f32 eps = 1.0e-4f;
+    using MeshPrims = MeshPrimitives::Tri;
+
+    struct TestCase
+    {
+        Span<Vec3<f32> const> vertex_positions;
+        Span<Vec3<i16> const> face_vertices;
+    };
+
+    TestCase const test_cases[] = {
+        {
+            as<Vec3<f32>>(MeshPrims::tetrahedron().vertex_positions),
+            as<Vec3<i16>>(MeshPrims::tetrahedron().face_vertices),
+        },
+        {
+            as<Vec3<f32>>(MeshPrims::cube().vertex_positions),
+            as<Vec3<i16>>(MeshPrims::cube().face_vertices),
+        },
+        {
+            as<Vec3<f32>>(MeshPrims::icosahedron().vertex_positions),
+            as<Vec3<i16>>(MeshPrims::icosahedron().face_vertices),
+        },
+    };
+
+    // Offset origin so that grid points don't lie exactly on the surface
+    Grid3<f32> const grid{{24, 23, 22}, {0.1f, 0.1f, 0.1f}, {-1.23f, -1.17f, -1.09f}};
+
+    // Distances are exact near the surface. Elsewhere they're propagated from neighboring grid
+    // points so they can be slightly overestimated near the medial axis.
+    f32 const band_dist = grid.spacing.minCoeff();
+    f32 const far_eps = 0.05f * grid.spacing.minCoeff();
+
+    for (auto const& [vert_positions, face_verts] : test_cases)
+    {
+        DynamicArray<f32> expect(grid.shape.prod());
+        for (isize i = 0; i < size(expect); ++i)
+        {
+            Vec3<f32> const p = grid.to_world(grid.to_grid(i));
+            f32 const d = brute_force_distance(vert_positions, face_verts, p);
+            expect[i] = (winding_number(vert_positions, face_verts, p) > 0.5f) ? -d : d;
+        }
+
+        for (isize const num_threads : {1, 4})
+        {
+            DynamicArray<f32> result(grid.shape.prod());
+            signed_distance_field(
+                vert_positions,
+                face_verts,
+                grid,
+                as_span(result),
+                Executor{num_threads});
+
+            for (isize i = 0; i < size(expect); ++i)
+            {
+                if (std::abs(expect[i]) <= band_dist)
+                    ASSERT_NEAR(expect[i], result[i], eps);
+                else
+                    ASSERT_NEAR(expect[i], result[i], far_eps);
+            }
+        }
+    }
+}
+
+UTEST(mesh_sdf, signed_distance_field_empty)
+{
+    using namespace dr;
+
+    Grid3<f64> const grid{{4, 4, 4}};
+    DynamicArray<f64> result(grid.shape.prod());
+    signed_distance_field<f64, i32>({}, {}, grid, as_span(result));
+
+    for (f64 const d : result)
+        ASSERT_TRUE(std::isinf(d) && d > 0.0);
+}
@@ -0,0 +1,182 @@
+#include <utest.h>
+
+#include <dr/container_utils.hpp>
+#include <dr/dynamic_array.hpp>
+#include <dr/math.hpp>
+#include <dr/math_constants.hpp>
+#include <dr/math_types.hpp>
+#include <dr/skinning.hpp>
+#include <dr/sliced_array.hpp>
+
+UTEST(skinning, single_influence)
+{
+    using namespace dr;
+
+    constexpr f64 eps = 1.0e-10;
+    constexpr isize num_verts = 100;
+
+    Conformal3<f64> const xforms[]{
+        {{Quat<f64>::UnitRandom()}, Vec3<f64>::Random(), 1.5},
+        {{Quat<f64>::UnitRandom()}, Vec3<f64>::Random(), 0.5},
+    };
+
+    DynamicArray<Vec3<f64>> rest(num_verts);
+    for (auto& p : rest)
+        p = Vec3<f64>::Random();
+
+    // Each vertex is influenced by a single transform (split into two equal weights) except for
+    // the last which has no influences
+    SlicedArray<SkinWeight<f64>> influences{};
+    for (isize i = 0; i + 1 < num_verts; ++i)
+    {
+        i32 const xform = i32(i % 2);
+        SkinWeight<f64> const weights[]{{xform, 0.25}, {xform, 0.75}};
+        influences.push_back(as_span(weights).as_const());
+    }
+    influences.push_back(0);
+
+    for (auto const mode : {SkinningMode_LinearBlend, SkinningMode_DualQuat})
+    {
+        for (isize const num_threads : {1, 4})
+        {
+            DynamicArray<Vec3<f64>> result(num_verts);
+            skin(
+                as_span(xforms).as_const(),
+                influences,
+                as_span(rest).as_const(),
+                as_span(result),
+                mode,
+                Executor{num_threads});
+
+            for (isize i = 0; i + 1 < num_verts; ++i)
+            {
+                Vec3<f64> const expect = xforms[i % 2].apply(rest[i]);
+                ASSERT_NEAR(0.0, (expect - result[i]).norm(), eps);
+            }
+
+            ASSERT_EQ(rest[num_verts - 1], result[num_verts - 1]);
+        }
+    }
+}
+
+UTEST(skinning, blend)
+{
+    using namespace dr;
+
+    constexpr f64 eps = 1.0e-10;
+
+    // Blend halfway between the identity and a quarter turn about z
+    Rigid3<f64> const xforms[]{
+        {},
+        {{Quat<f64>{Eigen::AngleAxis<f64>{0.5 * pi<f64>, Vec3<f64>::UnitZ()}}}, {}},
+    };
+
+    Vec3<f64> const rest[]{{1.0, 0.0, 0.0}};
+    Vec3<f64> const rest_normals[]{{0.0, 1.0, 0.0}};
+
+    SlicedArray<SkinWeight<f64>> influences{};
+    SkinWeight<f64> const weights[]{{0, 0.5}, {1, 0.5}};
+    influences.push_back(as_span(weights).as_const());
+
+    Vec3<f64> result[1];
+    Vec3<f64> result_normals[1];
+
+    // Linear blending should collapse toward the axis
+    skin(
+        as_span(xforms).as_const(),
+        influences,
+        as_span(rest).as_const(),
+        as_span(result),
+        as_span(rest_normals).as_const(),
+        as_span(result_normals),
+        SkinningMode_LinearBlend);
+
+    ASSERT_NEAR(0.0, (result[0] - Vec3<f64>{0.5, 0.5, 0.0}).norm(), eps);
+    ASSERT_NEAR(1.0, result_normals[0].norm(), eps);
+
+    // Dual quaternion blending should rotate by half the angle, preserving distance from the axis
+    skin(
+        as_span(xforms).as_const(),
+        influences,
+        as_span(rest).as_const(),
+        as_span(result),
+        as_span(rest_normals).as_const(),
+        as_span(result_normals),
+        SkinningMode_DualQuat);
+
+    f64 const c = std::sqrt(0.5);
+    ASSERT_NEAR(0.0, (result[0] - Vec3<f64>{c, c, 0.0}).norm(), eps);
+    ASSERT_NEAR(0.0, (result_normals[0] - Vec3<f64>{-c, c, 0.0}).norm(), eps);
+
+    // Antipodal quaternions represent the same rotation and should blend the same way
+    Rigid3<f64> const xforms_flip[]{
+        xforms[0],
+        {{Quat<f64>{-xforms[1].rotation.q.coeffs()}}, {}},
+    };
+
+    skin(
+        as_span(xforms_flip).as_const(),
+        influences,
+        as_span(rest).as_const(),
+        as_span(result),
+        SkinningMode_DualQuat);
+
+    ASSERT_NEAR(0.0, (result[0] - Vec3<f64>{c, c, 0.0}).norm(), eps);
+}
+
+UTEST(skinning, blend_normals)
+{
+    using namespace dr;
+
+    constexpr f64 eps = 1.0e-10;
+    constexpr isize num_verts = 100;
+
+    // Blended linear parts of transformations with different rotations and scales aren't
+    // orthogonal
+    Conformal3<f64> const xforms[]{
+        {{Quat<f64>::UnitRandom()}, Vec3<f64>::Random(), 1.5},
+        {{Quat<f64>::UnitRandom()}, Vec3<f64>::Random(), 0.5},
+    };
+
+    DynamicArray<Vec3<f64>> rest(num_verts);
+    DynamicArray<Vec3<f64>> rest_normals(num_verts);
+    DynamicArray<Vec3<f64>> rest_tangents(num_verts);
+    SlicedArray<SkinWeight<f64>> influences{};
+
+    for (isize i = 0; i < num_verts; ++i)
+    {
+        rest[i] = Vec3<f64>::Random();
+        rest_normals[i] = Vec3<f64>::Random().normalized();
+        rest_tangents[i] = rest_normals[i].cross(Vec3<f64>::Random());
+
+        f64 const w = f64(i) / f64(num_verts - 1);
+        SkinWeight<f64> const weights[]{{0, 1.0 - w}, {1, w}};
+        influences.push_back(as_span(weights).as_const());
+    }
+
+    DynamicArray<Vec3<f64>> result(num_verts);
+    DynamicArray<Vec3<f64>> result_normals(num_verts);
+
+    skin(
+        as_span(xforms).as_const(),
+        influences,
+        as_span(rest).as_const(),
+        as_span(result),
+        as_span(rest_normals).as_const(),
+        as_span(result_normals),
+        SkinningMode_LinearBlend);
+
+    // Transformed normals should remain orthogonal to transformed tangents
+    for (isize i = 0; i < num_verts; ++i)
+    {
+        Mat3<f64> linear = Mat3<f64>::Zero();
+        for (auto const& [xform, w] : influences[i32(i)])
+        {
+            Affine3<f64> const a = xforms[xform];
+            linear += w * a.linear;
+        }
+
+        ASSERT_NEAR(1.0, result_normals[i].norm(), eps);
+        ASSERT_NEAR(0.0, result_normals[i].dot(linear * rest_tangents[i]), eps);
+    }
+}
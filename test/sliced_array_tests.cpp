@@ -62,6 +62,64 @@ UTEST(sliced_array, indexer)
     }
 }
 
+UTEST(sliced_array, assign_sizes)
+{
+    using namespace dr;
+
+    i32 const sizes[] = {3, 0, 4, 1};
+    i32 const expect[] = {3, 3, 7, 8};
+
+    for (isize const num_threads : {1, 3})
+    {
+        SlicedArray<f64> arr{};
+        arr.push_back(2, 1.0);
+        arr.assign_sizes(as_span(sizes), Executor{num_threads});
+
+        ASSERT_EQ(4, arr.num_slices());
+        ASSERT_EQ(8, arr.num_items());
+        ASSERT_TRUE(std::equal(begin(arr.slice_ends), end(arr.slice_ends), expect));
+
+        for (i32 i = 0; i < arr.num_slices(); ++i)
+            ASSERT_EQ(sizes[i], arr[i].size());
+    }
+}
+
+UTEST(sliced_array, count_then_fill)
+{
+    using namespace dr;
+
+    constexpr i32 num_slices = 1000;
+
+    // Slice i contains the values [0, i % 7)
+    SlicedArray<i32> expect{};
+    for (i32 i = 0; i < num_slices; ++i)
+    {
+        expect.push_back(i % 7);
+        Span<i32> const slice = expect[i];
+        for (isize j = 0; j < slice.size(); ++j)
+            slice[j] = i32(j);
+    }
+
+    for (isize const num_threads : {1, 4})
+    {
+        SlicedArray<i32> arr{};
+        count_then_fill(
+            num_slices,
+            [](i32 const i) -> i32 {
+                return i % 7;
+            },
+            [](i32 /*i*/, Span<i32> const& slice) {
+                for (isize j = 0; j < slice.size(); ++j)
+                    slice[j] = i32(j);
+            },
+            arr,
+            Executor{num_threads});
+
+        ASSERT_TRUE(arr.items == expect.items);
+        ASSERT_TRUE(arr.slice_ends == expect.slice_ends);
+    }
+}
+
 UTEST(sliced_array, allocator_propagation)
 {
     using namespace dr;
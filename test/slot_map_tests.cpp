@@ -117,4 +117,292 @@ UTEST(slot_map, allocator_propagation)
         Handle const h2 = map.insert(1000, 3);
         ASSERT_TRUE(map[h2]->get_allocator().resource()->is_equal(mem[1]));
     }
-}
\ No newline at end of file
+}
+
+UTEST(slot_map, clear)
+{
+    using namespace dr;
+
+    using SlotMap = SlotMap<i32>;
+    using Handle = SlotMap::Handle;
+
+    SlotMap map{};
+    map.reserve(3);
+
+    Handle const h0 = map.insert(0);
+    Handle const h1 = map.insert(1);
+    Handle const h2 = map.insert(2);
+    ASSERT_TRUE(map.remove(h1));
+
+    map.clear();
+    ASSERT_EQ(0, map.num_items());
+    ASSERT_EQ(3, map.num_slots());
+    ASSERT_FALSE(map.is_valid(h0));
+    ASSERT_FALSE(map.is_valid(h2));
+
+    Handle const h3 = map.insert(3);
+    ASSERT_TRUE(map.is_valid(h3));
+    ASSERT_EQ(1, map.num_items());
+    ASSERT_EQ(3, map.num_slots());
+    ASSERT_EQ(h3.version, map.handle_at(h3.index).version);
+}
+
+UTEST(dense_slot_map, insert_remove)
+{
+    using namespace dr;
+
+    using SlotMap = DenseSlotMap<std::string>;
+    using Handle = SlotMap::Handle;
+
+    SlotMap map{};
+    ASSERT_EQ(0, map.num_items());
+    ASSERT_EQ(0, map.num_slots());
+
+    Handle const h0 = map.insert("One");
+    ASSERT_EQ(0u, h0.index);
+    ASSERT_EQ(1u, h0.version);
+
+    Handle const h1 = map.insert("Two");
+    ASSERT_EQ(1u, h1.index);
+    ASSERT_EQ(1u, h1.version);
+
+    Handle const h2 = map.insert("Three");
+    ASSERT_EQ(2u, h2.index);
+    ASSERT_EQ(1u, h2.version);
+    ASSERT_EQ(3, map.num_items());
+    ASSERT_EQ(3, map.num_slots());
+
+    ASSERT_TRUE(map.remove(h0));
+    ASSERT_FALSE(map.remove(h0));
+    ASSERT_EQ(2, map.num_items());
+    ASSERT_EQ(3, map.num_slots());
+    ASSERT_FALSE(map.is_valid(h0));
+    ASSERT_TRUE(map[h0] == nullptr);
+
+    // Remaining handles should still refer to the same items after relocation
+    ASSERT_TRUE(map[h1]->compare("Two") == 0);
+    ASSERT_TRUE(map[h2]->compare("Three") == 0);
+
+    Handle const h3 = map.insert("Four");
+    ASSERT_EQ(0u, h3.index);
+    ASSERT_EQ(2u, h3.version);
+    ASSERT_EQ(3, map.num_items());
+    ASSERT_EQ(3, map.num_slots());
+    ASSERT_TRUE(map[h3]->compare("Four") == 0);
+
+    // Handles from a different slot map shouldn't be valid
+    ASSERT_FALSE(map.is_valid(Handle{4, 1}));
+}
+
+UTEST(dense_slot_map, items)
+{
+    using namespace dr;
+
+    using SlotMap = DenseSlotMap<i32>;
+    using Handle = SlotMap::Handle;
+
+    SlotMap map{};
+    map.reserve(4);
+
+    Handle handles[4];
+    for (i32 i = 0; i < 4; ++i)
+        handles[i] = map.insert(i);
+
+    map.remove(handles[1]);
+    map.remove(handles[3]);
+
+    {
+        SlotMap const& map_ref = map;
+        Span<i32 const> const items = map_ref.items();
+        ASSERT_EQ(2, items.size());
+
+        i32 sum = 0;
+        for (isize i = 0; i < items.size(); ++i)
+        {
+            Handle const h = map_ref.handle_at(i);
+            ASSERT_EQ(items[i], *map_ref[h]);
+            sum += items[i];
+        }
+        ASSERT_EQ(2, sum);
+    }
+
+    map.clear();
+    ASSERT_EQ(0, map.num_items());
+    ASSERT_EQ(0, map.items().size());
+    ASSERT_FALSE(map.is_valid(handles[0]));
+    ASSERT_FALSE(map.is_valid(handles[2]));
+}
+
+UTEST(dense_slot_map, allocator_propagation)
+{
+    using namespace dr;
+
+    // Restore default memory resource after test is complete
+    auto def_mem = std::pmr::get_default_resource();
+    auto _ = defer([=]() {
+        std::pmr::set_default_resource(def_mem);
+    });
+
+    DebugMemoryResource mem[3]{};
+    std::pmr::set_default_resource(&mem[0]);
+
+    // Check propagation on copy/move
+    {
+        DenseSlotMap<DynamicArray<i32>> src{&mem[1]};
+        ASSERT_TRUE(src.allocator().resource()->is_equal(mem[1]));
+
+        {
+            // dst should use the given memory resource
+            DenseSlotMap<DynamicArray<i32>> dst{src, &mem[2]};
+            ASSERT_TRUE(dst.allocator().resource()->is_equal(mem[2]));
+        }
+
+        {
+            // dst should use the current default memory resource
+            DenseSlotMap<DynamicArray<i32>> dst{src};
+            ASSERT_TRUE(dst.allocator().resource()->is_equal(mem[0]));
+        }
+
+        {
+            // dst should use the same memory resource as src
+            DenseSlotMap<DynamicArray<i32>> dst{std::move(src)};
+            ASSERT_TRUE(dst.allocator().resource()->is_equal(mem[1]));
+        }
+    }
+
+    // Check propagation to elements
+    {
+        DenseSlotMap<DynamicArray<i32>> map{&mem[1]};
+        using Handle = DenseSlotMap<DynamicArray<i32>>::Handle;
+
+        Handle const h0 = map.insert(1000, 1);
+        ASSERT_TRUE(map[h0]->get_allocator().resource()->is_equal(mem[1]));
+
+        Handle const h1 = map.insert(1000, 2);
+        ASSERT_TRUE(map[h1]->get_allocator().resource()->is_equal(mem[1]));
+
+        // Relocated item should keep the container's allocator
+        map.remove(h0);
+        ASSERT_TRUE(map[h1]->get_allocator().resource()->is_equal(mem[1]));
+        ASSERT_EQ(2, (*map[h1])[0]);
+    }
+}
+
+UTEST(concurrent_slot_map, insert_remove)
+{
+    using namespace dr;
+
+    using SlotMap = ConcurrentSlotMap<std::string>;
+    using Handle = SlotMap::Handle;
+
+    SlotMap map{};
+    ASSERT_EQ(0, map.num_items());
+    ASSERT_EQ(0, map.num_slots());
+
+    Handle const h0 = map.insert("One");
+    ASSERT_EQ(0u, h0.index);
+    ASSERT_EQ(1u, h0.version);
+    ASSERT_TRUE(map[h0]->compare("One") == 0);
+
+    Handle const h1 = map.insert("Two");
+    ASSERT_EQ(1u, h1.index);
+    ASSERT_EQ(1u, h1.version);
+    ASSERT_EQ(2, map.num_items());
+    ASSERT_EQ(2, map.num_slots());
+
+    ASSERT_TRUE(map.remove(h0));
+    ASSERT_FALSE(map.remove(h0));
+    ASSERT_FALSE(map.is_valid(h0));
+    ASSERT_TRUE(map[h0] == nullptr);
+    ASSERT_EQ(1, map.num_items());
+
+    Handle const h2 = map.insert("Three");
+    ASSERT_EQ(0u, h2.index);
+    ASSERT_EQ(2u, h2.version);
+    ASSERT_TRUE(map[h2]->compare("Three") == 0);
+    ASSERT_EQ(2, map.num_items());
+    ASSERT_EQ(2, map.num_slots());
+
+    // Handles to slots that haven't been allocated yet shouldn't be valid
+    ASSERT_FALSE(map.is_valid(Handle{1000000, 1}));
+}
+
+UTEST(concurrent_slot_map, stable_references)
+{
+    using namespace dr;
+
+    using SlotMap = ConcurrentSlotMap<i32>;
+    using Handle = SlotMap::Handle;
+
+    SlotMap map{};
+
+    Handle const h0 = map.insert(-1);
+    i32 const* const p0 = map[h0];
+
+    // Growing the map shouldn't relocate existing items
+    for (i32 i = 0; i < 10000; ++i)
+        map.insert(i);
+
+    ASSERT_TRUE(map[h0] == p0);
+    ASSERT_EQ(-1, *p0);
+}
+
+UTEST(concurrent_slot_map, concurrent_insert_remove)
+{
+    using namespace dr;
+
+    using SlotMap = ConcurrentSlotMap<i32>;
+    using Handle = SlotMap::Handle;
+
+    constexpr isize n = 10000;
+    DynamicArray<Handle> handles(n);
+    SlotMap map{};
+
+#pragma omp parallel for schedule(static, 1)
+    for (isize i = 0; i < n; ++i)
+    {
+        handles[i] = map.insert(i32(i));
+
+        // Remove and reinsert every other item to exercise the free list
+        if (i & 1)
+        {
+            map.remove(handles[i]);
+            handles[i] = map.insert(i32(i));
+        }
+    }
+
+    ASSERT_EQ(n, map.num_items());
+
+    bool all_found = true;
+    for (isize i = 0; i < n; ++i)
+    {
+        i32 const* const item = map[handles[i]];
+        all_found &= (item != nullptr && *item == i32(i));
+    }
+    ASSERT_TRUE(all_found);
+
+#pragma omp parallel for schedule(static, 1)
+    for (isize i = 0; i < n; ++i)
+        map.remove(handles[i]);
+
+    ASSERT_EQ(0, map.num_items());
+}
+
+UTEST(concurrent_slot_map, allocator_propagation)
+{
+    using namespace dr;
+
+    DebugMemoryResource mem{};
+
+    {
+        ConcurrentSlotMap<DynamicArray<i32>> map{&mem};
+        ASSERT_TRUE(map.allocator().resource()->is_equal(mem));
+
+        using Handle = ConcurrentSlotMap<DynamicArray<i32>>::Handle;
+        Handle const h0 = map.insert(1000, 1);
+        ASSERT_TRUE(map[h0]->get_allocator().resource()->is_equal(mem));
+    }
+
+    // All memory should be released when the map is destroyed
+    ASSERT_EQ(0u, mem.bytes_allocated);
+}
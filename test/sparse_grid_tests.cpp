@@ -0,0 +1,204 @@
+#include <utest.h>
+
+#include <atomic>
+
+#include <dr/container_utils.hpp>
+#include <dr/defer.hpp>
+#include <dr/dynamic_array.hpp>
+#include <dr/grid_field.hpp>
+#include <dr/math_types.hpp>
+#include <dr/memory.hpp>
+#include <dr/random.hpp>
+#include <dr/sparse_grid.hpp>
+
+UTEST(sparse_grid, allocator_propagation)
+{
+    using namespace dr;
+
+    // Restore default memory resource after test is complete
+    auto def_mem = std::pmr::get_default_resource();
+    auto _ = defer([=]() {
+        std::pmr::set_default_resource(def_mem);
+    });
+
+    DebugMemoryResource mem[3]{};
+    std::pmr::set_default_resource(&mem[0]);
+
+    SparseGrid<f32> src{&mem[1]};
+    src.set({1, 2, 3}, 1.0f);
+    src.set({-20, 2, 3}, 2.0f);
+
+    {
+        // dst should use the given memory resource
+        SparseGrid<f32> dst{src, &mem[2]};
+        ASSERT_TRUE(dst.allocator().resource()->is_equal(mem[2]));
+    }
+
+    {
+        // dst should use the current default memory resource
+        SparseGrid<f32> dst{src};
+        ASSERT_TRUE(dst.allocator().resource()->is_equal(mem[0]));
+    }
+
+    {
+        // dst should use the same memory resource as src
+        SparseGrid<f32> dst{std::move(src)};
+        ASSERT_TRUE(dst.allocator().resource()->is_equal(mem[1]));
+    }
+}
+
+UTEST(sparse_grid, activate)
+{
+    using namespace dr;
+
+    SparseGrid<i32> grid{-1};
+    ASSERT_EQ(0, grid.num_leaves());
+    ASSERT_EQ(-1, (grid[{0, 0, 0}]));
+
+    grid.set({0, 0, 0}, 1);
+    grid.set({7, 7, 7}, 2);
+    grid.set({-1, 0, 0}, 3);
+    grid.set({100, -100, 5}, 4);
+
+    ASSERT_EQ(3, grid.num_leaves());
+    ASSERT_EQ(4, grid.num_active());
+
+    ASSERT_EQ(1, (grid[{0, 0, 0}]));
+    ASSERT_EQ(2, (grid[{7, 7, 7}]));
+    ASSERT_EQ(3, (grid[{-1, 0, 0}]));
+    ASSERT_EQ(4, (grid[{100, -100, 5}]));
+
+    // Inactive points in allocated leaves should have the background value
+    ASSERT_EQ(-1, (grid[{1, 0, 0}]));
+    ASSERT_FALSE(grid.is_active({1, 0, 0}));
+    ASSERT_EQ(nullptr, grid.find({1, 0, 0}));
+    ASSERT_EQ(-1, (grid[{8, 0, 0}]));
+    ASSERT_EQ(-1, grid.find_leaf({8, 0, 0}));
+
+    ASSERT_EQ(-8, grid.leaf_origin(grid.find_leaf({-1, 0, 0}))[0]);
+
+    grid.deactivate({0, 0, 0});
+    ASSERT_FALSE(grid.is_active({0, 0, 0}));
+    ASSERT_EQ(-1, (grid[{0, 0, 0}]));
+    ASSERT_EQ(3, grid.num_active());
+
+    grid.deactivate({-1, 0, 0});
+    ASSERT_EQ(3, grid.num_leaves());
+
+    // Only the leaf containing (-1, 0, 0) should be freed
+    grid.prune();
+    ASSERT_EQ(2, grid.num_leaves());
+    ASSERT_EQ(2, grid.num_active());
+    ASSERT_EQ(-1, grid.find_leaf({-1, 0, 0}));
+    ASSERT_EQ(2, *grid.find({7, 7, 7}));
+    ASSERT_EQ(4, *grid.find({100, -100, 5}));
+
+    grid.clear();
+    ASSERT_EQ(0, grid.num_leaves());
+    ASSERT_EQ(-1, (grid[{7, 7, 7}]));
+}
+
+UTEST(sparse_grid, for_each_active)
+{
+    using namespace dr;
+
+    // Narrow band around a sphere
+    constexpr isize radius = 40;
+    constexpr f64 band = 1.5;
+
+    SparseGrid<f64> grid{band};
+    isize expect_count = 0;
+
+    for (isize k = -radius - 2; k <= radius + 2; ++k)
+    {
+        for (isize j = -radius - 2; j <= radius + 2; ++j)
+        {
+            for (isize i = -radius - 2; i <= radius + 2; ++i)
+            {
+                f64 const d = Vec3<f64>(f64(i), f64(j), f64(k)).norm() - f64(radius);
+                if (std::abs(d) < band)
+                {
+                    grid.set({i, j, k}, d);
+                    ++expect_count;
+                }
+            }
+        }
+    }
+
+    ASSERT_EQ(expect_count, grid.num_active());
+
+    // Allocated leaves should be a small fraction of those covering the bounding box
+    {
+        isize const n = (2 * radius + 5 + grid_brick_width - 1) / grid_brick_width;
+        ASSERT_LT(grid.num_leaves() * 2, n * n * n);
+    }
+
+    for (isize const num_threads : {1, 4})
+    {
+        std::atomic<isize> count = 0;
+
+        grid.for_each_active(
+            [&](Vec3<isize> const& grid_pt, f64& value) {
+                f64 const d = grid_pt.cast<f64>().norm() - f64(radius);
+                if (d == value)
+                    ++count;
+            },
+            Executor{num_threads});
+
+        ASSERT_EQ(expect_count, count.load());
+    }
+}
+
+UTEST(sparse_grid, sample)
+{
+    using namespace dr;
+
+    constexpr f64 eps = 1.0e-12;
+
+    // Compare against dense sampling
+    Vec3<isize> const shape{13, 9, 18};
+    Vec3<isize> const origin{-5, 3, -9};
+
+    DynamicArray<f64> values(shape.prod());
+    SparseGrid<f64> grid{};
+    {
+        Random<> rand{1};
+        auto gen = rand.generator(-1.0, 1.0);
+        Vec3<isize> const stride = grid_stride(shape);
+
+        for (isize i = 0; i < size(values); ++i)
+        {
+            values[i] = gen();
+            grid.set(index_to_grid(i, stride) + origin, values[i]);
+        }
+    }
+
+    GridField<f64> const field{{shape, {1.0, 1.0, 1.0}, origin.cast<f64>()}, as_span(values)};
+
+    Random<> rand{2};
+    auto gen = rand.generator(0.0, 1.0);
+
+    for (isize i = 0; i < 200; ++i)
+    {
+        // Keep the stencil within the dense grid
+        Vec3<f64> p;
+        for (int j = 0; j < 3; ++j)
+            p[j] = f64(origin[j]) + 1.0 + (f64(shape[j]) - 3.0) * gen();
+
+        for (GridFilter const filter : {GridFilter_Linear, GridFilter_Cubic})
+        {
+            Vec3<f64> grad_a;
+            f64 const a = field.sample(p, filter, grad_a);
+
+            Vec3<f64> grad_b;
+            f64 const b = grid.sample(p, filter, grad_b);
+
+            ASSERT_NEAR(a, b, eps);
+            ASSERT_NEAR(0.0, (grad_a - grad_b).norm(), eps);
+            ASSERT_NEAR(a, grid.sample(p, filter), eps);
+        }
+    }
+
+    // Should return the background value away from active points
+    ASSERT_EQ(0.0, grid.sample({100.5, 0.0, 0.0}, GridFilter_Cubic));
+}
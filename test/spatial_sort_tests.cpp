@@ -0,0 +1,97 @@
+#include <utest.h>
+
+#include <dr/container_utils.hpp>
+#include <dr/dynamic_array.hpp>
+#include <dr/math_types.hpp>
+#include <dr/random.hpp>
+#include <dr/spatial_sort.hpp>
+
+UTEST(spatial_sort, spatial_sort_permutation)
+{
+    using namespace dr;
+
+    Random<> rand{2};
+    auto gen = rand.generator(-1.0, 1.0);
+
+    DynamicArray<Vec3<f64>> points(500);
+    for (Vec3<f64>& p : points)
+        p = {gen(), gen(), gen()};
+
+    for (SpatialCurve const curve : {SpatialCurve_Morton, SpatialCurve_Hilbert})
+    {
+        DynamicArray<i32> perm(points.size());
+        spatial_sort_permutation(as_span(points).as_const(), curve, as_span(perm), Executor{2});
+
+        DynamicArray<u64> codes(points.size());
+        spatial_codes(
+            as_span(points).as_const(),
+            bounding_interval(as_span(points).as_const()),
+            curve,
+            as_span(codes));
+
+        // Result should be a permutation which orders codes
+        DynamicArray<i32> inv(points.size());
+        invert_permutation(as_span(perm).as_const(), as_span(inv));
+
+        for (isize i = 0; i < size(perm); ++i)
+        {
+            ASSERT_EQ(i32(i), inv[perm[i]]);
+
+            if (i > 0)
+                ASSERT_TRUE(codes[perm[i - 1]] <= codes[perm[i]]);
+        }
+    }
+
+    // Quantized corners of the bounds should map to the extremes of the Morton curve
+    {
+        Vec2<f32> const corners[]{{0.0f, 0.0f}, {2.0f, 1.0f}};
+        u64 codes[2];
+        spatial_codes(
+            as_span(corners),
+            Interval2<f32>{corners[0], corners[1]},
+            SpatialCurve_Morton,
+            as_span(codes));
+
+        ASSERT_EQ(u64{0}, codes[0]);
+        ASSERT_EQ(~u64{0}, codes[1]);
+    }
+}
+
+UTEST(spatial_sort, apply_vertex_permutation)
+{
+    using namespace dr;
+
+    DynamicArray<Vec3<f32>> const positions{
+        {0.0f, 0.0f, 0.0f},
+        {1.0f, 0.0f, 0.0f},
+        {0.0f, 1.0f, 0.0f},
+        {1.0f, 1.0f, 0.0f},
+        {2.0f, 1.0f, 0.0f},
+    };
+
+    DynamicArray<Vec3<i32>> const faces{
+        {0, 1, 2},
+        {1, 3, 2},
+        {1, 4, 3},
+    };
+
+    i32 const perm[]{3, 0, 4, 2, 1};
+
+    DynamicArray<Vec3<f32>> result_positions(positions.size());
+    DynamicArray<Vec3<i32>> result_faces = faces;
+
+    apply_vertex_permutation(
+        as_span(positions),
+        as_span(perm).as_const(),
+        as_span(result_positions),
+        as_span(result_faces));
+
+    for (isize i = 0; i < size(perm); ++i)
+        ASSERT_TRUE(positions[perm[i]] == result_positions[i]);
+
+    for (isize i = 0; i < size(faces); ++i)
+    {
+        for (isize j = 0; j < 3; ++j)
+            ASSERT_TRUE(positions[faces[i][j]] == result_positions[result_faces[i][j]]);
+    }
+}
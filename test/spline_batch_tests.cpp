@@ -0,0 +1,268 @@
+#include <utest.h>
+
+#include <dr/container_utils.hpp>
+#include <dr/dynamic_array.hpp>
+#include <dr/math_types.hpp>
+#include <dr/random.hpp>
+#include <dr/spline.hpp>
+#include <dr/spline_batch.hpp>
+
+UTEST(spline_batch, curve)
+{
+    using namespace dr;
+    using B = CatmullRomBasis;
+
+    constexpr f64 eps = 1.0e-10;
+
+    Random<> rand{1};
+    auto gen = rand.generator(-1.0, 1.0);
+
+    Vec3<f64> coeffs[4];
+    for (auto& c : coeffs)
+        c = {gen(), gen(), gen()};
+
+    DynamicArray<f64> params(17);
+    for (isize i = 0; i < size(params); ++i)
+        params[i] = f64(i) / 16.0;
+
+    SplineBasisTable<B, f64, 1> const table{as_span(params).as_const()};
+    ASSERT_EQ(size(params), table.num_params());
+
+    DynamicArray<Vec3<f64>> vals(size(params));
+    eval_spline_batch(as_span(coeffs).as_const(), table, 0, as_span(vals));
+
+    DynamicArray<Vec3<f64>> diffs(size(params));
+    eval_spline_batch(as_span(coeffs).as_const(), table, 1, as_span(diffs));
+
+    for (isize i = 0; i < size(params); ++i)
+    {
+        Vec3<f64> const val = eval_cubic(coeffs, params[i]);
+        Vec3<f64> const diff = eval_cubic_dt(coeffs, params[i]);
+        ASSERT_NEAR(0.0, (vals[i] - val).norm(), eps);
+        ASSERT_NEAR(0.0, (diffs[i] - diff).norm(), eps);
+    }
+}
+
+UTEST(spline_batch, surface)
+{
+    using namespace dr;
+    using B = CatmullRomBasis;
+
+    constexpr f64 eps = 1.0e-10;
+
+    Random<> rand{2};
+    auto gen = rand.generator(-1.0, 1.0);
+
+    f64 coeffs[16];
+    for (f64& c : coeffs)
+        c = gen();
+
+    DynamicArray<f64> params_u(9);
+    for (isize i = 0; i < size(params_u); ++i)
+        params_u[i] = f64(i) / 8.0;
+
+    DynamicArray<f64> params_v(5);
+    for (isize i = 0; i < size(params_v); ++i)
+        params_v[i] = f64(i) / 4.0;
+
+    SplineBasisTable<B, f64, 1> const table_u{as_span(params_u).as_const()};
+    SplineBasisTable<B, f64, 1> const table_v{as_span(params_v).as_const()};
+
+    isize const m_u = size(params_u);
+    isize const m_v = size(params_v);
+
+    for (isize const num_threads : {1, 4})
+    {
+        DynamicArray<f64> vals(m_u * m_v);
+        DynamicArray<f64> diffs_u(m_u * m_v);
+        DynamicArray<f64> diffs_v(m_u * m_v);
+
+        auto const x = as_span(coeffs).as_const();
+        Executor const exec{num_threads};
+        eval_spline_batch(x, table_u, 0, table_v, 0, as_span(vals), exec);
+        eval_spline_batch(x, table_u, 1, table_v, 0, as_span(diffs_u), exec);
+        eval_spline_batch(x, table_u, 0, table_v, 1, as_span(diffs_v), exec);
+
+        for (isize j = 0; j < m_v; ++j)
+        {
+            for (isize i = 0; i < m_u; ++i)
+            {
+                f64 const u = params_u[i];
+                f64 const v = params_v[j];
+                isize const index = i + j * m_u;
+
+                ASSERT_NEAR(eval_bicubic(coeffs, u, v), vals[index], eps);
+                ASSERT_NEAR(eval_bicubic_du(coeffs, u, v), diffs_u[index], eps);
+                ASSERT_NEAR(eval_bicubic_dv(coeffs, u, v), diffs_v[index], eps);
+            }
+        }
+    }
+}
+
+UTEST(spline_batch, volume)
+{
+    using namespace dr;
+    using B = CatmullRomBasis;
+
+    constexpr f64 eps = 1.0e-10;
+
+    Random<> rand{3};
+    auto gen = rand.generator(-1.0, 1.0);
+
+    Vec2<f64> coeffs[64];
+    for (auto& c : coeffs)
+        c = {gen(), gen()};
+
+    DynamicArray<f64> params_u(7);
+    for (isize i = 0; i < size(params_u); ++i)
+        params_u[i] = f64(i) / 6.0;
+
+    DynamicArray<f64> params_v(4);
+    for (isize i = 0; i < size(params_v); ++i)
+        params_v[i] = f64(i) / 3.0;
+
+    DynamicArray<f64> params_w(3);
+    for (isize i = 0; i < size(params_w); ++i)
+        params_w[i] = f64(i) / 2.0;
+
+    SplineBasisTable<B, f64, 1> const table_u{as_span(params_u).as_const()};
+    SplineBasisTable<B, f64, 1> const table_v{as_span(params_v).as_const()};
+    SplineBasisTable<B, f64, 1> const table_w{as_span(params_w).as_const()};
+
+    isize const m_u = size(params_u);
+    isize const m_v = size(params_v);
+    isize const m_w = size(params_w);
+
+    for (isize const num_threads : {1, 4})
+    {
+        DynamicArray<Vec2<f64>> vals(m_u * m_v * m_w);
+        DynamicArray<Vec2<f64>> diffs_w(m_u * m_v * m_w);
+
+        auto const x = as_span(coeffs).as_const();
+        Executor const exec{num_threads};
+        eval_spline_batch(x, table_u, 0, table_v, 0, table_w, 0, as_span(vals), exec);
+        eval_spline_batch(x, table_u, 0, table_v, 0, table_w, 1, as_span(diffs_w), exec);
+
+        for (isize k = 0; k < m_w; ++k)
+        {
+            for (isize j = 0; j < m_v; ++j)
+            {
+                for (isize i = 0; i < m_u; ++i)
+                {
+                    f64 const u = params_u[i];
+                    f64 const v = params_v[j];
+                    f64 const w = params_w[k];
+                    isize const index = i + m_u * (j + m_v * k);
+
+                    Vec2<f64> const val = eval_tricubic(coeffs, u, v, w);
+                    Vec2<f64> const diff = eval_tricubic_dw(coeffs, u, v, w);
+                    ASSERT_NEAR(0.0, (vals[index] - val).norm(), eps);
+                    ASSERT_NEAR(0.0, (diffs_w[index] - diff).norm(), eps);
+                }
+            }
+        }
+    }
+}
+
+UTEST(spline_batch, all_orders)
+{
+    using namespace dr;
+    using B = CatmullRomBasis;
+
+    constexpr f64 eps = 1.0e-10;
+
+    Random<> rand{4};
+    auto gen = rand.generator(-1.0, 1.0);
+
+    Vec2<f64> coeffs[64];
+    for (auto& c : coeffs)
+        c = {gen(), gen()};
+
+    DynamicArray<f64> params_u(7);
+    for (isize i = 0; i < size(params_u); ++i)
+        params_u[i] = f64(i) / 6.0;
+
+    DynamicArray<f64> params_v(4);
+    for (isize i = 0; i < size(params_v); ++i)
+        params_v[i] = f64(i) / 3.0;
+
+    DynamicArray<f64> params_w(3);
+    for (isize i = 0; i < size(params_w); ++i)
+        params_w[i] = f64(i) / 2.0;
+
+    SplineBasisTable<B, f64, 2> const table_u{as_span(params_u).as_const()};
+    SplineBasisTable<B, f64, 1> const table_v{as_span(params_v).as_const()};
+    SplineBasisTable<B, f64, 2> const table_w{as_span(params_w).as_const()};
+
+    isize const m_u = size(params_u);
+    isize const m_v = size(params_v);
+    isize const m_w = size(params_w);
+
+    isize const o_u = table_u.num_orders;
+    isize const o_v = table_v.num_orders;
+    isize const o_w = table_w.num_orders;
+
+    // Results should match evaluating each order separately
+    {
+        auto const x = as_span(coeffs).front(4).as_const();
+
+        DynamicArray<Vec2<f64>> all(o_u * m_u);
+        eval_spline_batch(x, table_u, as_span(all));
+
+        DynamicArray<Vec2<f64>> expect(m_u);
+        for (isize a = 0; a < o_u; ++a)
+        {
+            eval_spline_batch(x, table_u, a, as_span(expect));
+
+            for (isize i = 0; i < m_u; ++i)
+                ASSERT_NEAR(0.0, (all[a * m_u + i] - expect[i]).norm(), eps);
+        }
+    }
+
+    for (isize const num_threads : {1, 4})
+    {
+        Executor const exec{num_threads};
+        auto const x = as_span(coeffs).front(16).as_const();
+
+        DynamicArray<Vec2<f64>> all(o_u * o_v * m_u * m_v);
+        eval_spline_batch(x, table_u, table_v, as_span(all), exec);
+
+        DynamicArray<Vec2<f64>> expect(m_u * m_v);
+        for (isize b = 0; b < o_v; ++b)
+        {
+            for (isize a = 0; a < o_u; ++a)
+            {
+                eval_spline_batch(x, table_u, a, table_v, b, as_span(expect), exec);
+                isize const offset = (b * o_u + a) * m_u * m_v;
+
+                for (isize i = 0; i < m_u * m_v; ++i)
+                    ASSERT_NEAR(0.0, (all[offset + i] - expect[i]).norm(), eps);
+            }
+        }
+    }
+
+    for (isize const num_threads : {1, 4})
+    {
+        Executor const exec{num_threads};
+        auto const x = as_span(coeffs).as_const();
+
+        DynamicArray<Vec2<f64>> all(o_u * o_v * o_w * m_u * m_v * m_w);
+        eval_spline_batch(x, table_u, table_v, table_w, as_span(all), exec);
+
+        DynamicArray<Vec2<f64>> expect(m_u * m_v * m_w);
+        for (isize c = 0; c < o_w; ++c)
+        {
+            for (isize b = 0; b < o_v; ++b)
+            {
+                for (isize a = 0; a < o_u; ++a)
+                {
+                    eval_spline_batch(x, table_u, a, table_v, b, table_w, c, as_span(expect), exec);
+                    isize const offset = ((c * o_v + b) * o_u + a) * m_u * m_v * m_w;
+
+                    for (isize i = 0; i < m_u * m_v * m_w; ++i)
+                        ASSERT_NEAR(0.0, (all[offset + i] - expect[i]).norm(), eps);
+                }
+            }
+        }
+    }
+}
@@ -1,3 +1,5 @@
+#include <cmath>
+
 #include <utest.h>
 
 #include <dr/spline.hpp>
@@ -349,6 +351,120 @@ UTEST(spline, bezier_cubic)
     }
 }
 
+UTEST(spline, bernstein_generic)
+{
+    using namespace dr;
+
+    constexpr f64 eps = 1.0e-10;
+    f64 const params[] = {-0.5, 0.0, 0.25, 0.5, 0.75, 1.0, 1.5};
+
+    // Generic evaluation should match the hand-written specializations
+    {
+        auto const check = [&](auto const& basis, auto const& generic, isize const n) -> bool {
+            for (f64 const t : params)
+            {
+                f64 expect[4]{};
+                basis(t, expect);
+
+                f64 result[4]{};
+                generic(t, result);
+
+                for (isize i = 0; i < n; ++i)
+                {
+                    if (std::abs(expect[i] - result[i]) > eps)
+                        return false;
+                }
+            }
+
+            return true;
+        };
+
+        using B2 = BernsteinBasis<2>;
+        ASSERT_TRUE(check(B2::eval<f64>, impl::bernstein_eval<2, f64>, 3));
+        ASSERT_TRUE(check(B2::Diff<1>::eval<f64>, impl::bernstein_diff<2, 1, f64>, 3));
+        ASSERT_TRUE(check(B2::Diff<2>::eval<f64>, impl::bernstein_diff<2, 2, f64>, 3));
+        ASSERT_TRUE(check(B2::Diff<3>::eval<f64>, impl::bernstein_diff<2, 3, f64>, 3));
+
+        using B3 = BernsteinBasis<3>;
+        ASSERT_TRUE(check(B3::eval<f64>, impl::bernstein_eval<3, f64>, 4));
+        ASSERT_TRUE(check(B3::Diff<1>::eval<f64>, impl::bernstein_diff<3, 1, f64>, 4));
+        ASSERT_TRUE(check(B3::Diff<2>::eval<f64>, impl::bernstein_diff<3, 2, f64>, 4));
+        ASSERT_TRUE(check(B3::Diff<3>::eval<f64>, impl::bernstein_diff<3, 3, f64>, 4));
+        ASSERT_TRUE(check(B3::Diff<4>::eval<f64>, impl::bernstein_diff<3, 4, f64>, 4));
+    }
+
+    // Higher degrees should form a partition of unity with derivatives matching finite differences
+    {
+        using B = BernsteinBasis<5>;
+        static_assert(B::size == 6);
+
+        constexpr f64 h = 1.0e-5;
+        constexpr f64 fd_eps = 1.0e-4;
+
+        for (f64 const t : params)
+        {
+            f64 b[6]{};
+            B::eval(t, b);
+
+            f64 b_lo[6]{};
+            B::eval(t - h, b_lo);
+
+            f64 b_hi[6]{};
+            B::eval(t + h, b_hi);
+
+            f64 d1[6]{};
+            B::Diff<1>::eval(t, d1);
+
+            f64 d2[6]{};
+            B::Diff<2>::eval(t, d2);
+
+            f64 d6[6]{};
+            B::Diff<6>::eval(t, d6);
+
+            f64 sum_b = 0.0;
+            f64 sum_d1 = 0.0;
+
+            for (isize i = 0; i < 6; ++i)
+            {
+                sum_b += b[i];
+                sum_d1 += d1[i];
+
+                ASSERT_NEAR((b_hi[i] - b_lo[i]) / (2.0 * h), d1[i], fd_eps);
+                ASSERT_NEAR((b_hi[i] - 2.0 * b[i] + b_lo[i]) / (h * h), d2[i], fd_eps * 100.0);
+                ASSERT_EQ(0.0, d6[i]);
+            }
+
+            ASSERT_NEAR(1.0, sum_b, eps);
+            ASSERT_NEAR(0.0, sum_d1, eps);
+        }
+
+        // Curve should interpolate its end points
+        f64 const x[6]{1.0, -2.0, 3.0, 0.5, 4.0, -1.0};
+        ASSERT_NEAR(x[0], impl::spline_eval<B>(x, 0.0), eps);
+        ASSERT_NEAR(x[5], impl::spline_eval<B>(x, 1.0), eps);
+    }
+
+    // Combined value and gradient evaluation should match separate evaluation
+    {
+        f64 x[27]{};
+        for (isize i = 0; i < 27; ++i)
+            x[i] = f64((i * 7) % 11) - 5.0;
+
+        f64 const u = 0.3;
+        f64 const v = 0.6;
+        f64 const w = 0.2;
+
+        f64 val{};
+        f64 diff[3]{};
+        eval_bezier_triquadratic(x, u, v, w, &val, diff);
+
+        ASSERT_NEAR(eval_bezier_triquadratic(x, u, v, w), val, eps);
+        ASSERT_NEAR(eval_bezier_triquadratic_du(x, u, v, w), diff[0], eps);
+        ASSERT_NEAR(eval_bezier_triquadratic_dv(x, u, v, w), diff[1], eps);
+        ASSERT_NEAR(eval_bezier_triquadratic_dw(x, u, v, w), diff[2], eps);
+    }
+}
+
 UTEST(spline, bilinear)
 {
     using namespace dr;
@@ -0,0 +1,219 @@
+#include <cmath>
+#include <map>
+#include <utility>
+
+#include <utest.h>
+
+#include <dr/container_utils.hpp>
+#include <dr/dynamic_array.hpp>
+#include <dr/math_types.hpp>
+#include <dr/random.hpp>
+#include <dr/sliced_array.hpp>
+#include <dr/tessellate.hpp>
+
+namespace
+{
+
+/// Returns the coefficients of Catmull-Rom patches interpolating a height field over a regular
+/// grid of control points
+dr::DynamicArray<dr::Vec3<dr::f64>> make_height_field_patches(
+    dr::isize const num_points,
+    dr::f64 const amplitude,
+    dr::u32 const seed)
+{
+    using namespace dr;
+
+    Random<> rand{seed};
+    auto gen = rand.generator(-amplitude, amplitude);
+
+    DynamicArray<f64> heights(num_points * num_points);
+    for (f64& h : heights)
+        h = gen();
+
+    isize const num_patches = num_points - 3;
+    DynamicArray<Vec3<f64>> result(num_patches * num_patches * 16);
+    Vec3<f64>* dst = result.data();
+
+    for (isize pj = 0; pj < num_patches; ++pj)
+    {
+        for (isize pi = 0; pi < num_patches; ++pi)
+        {
+            for (isize b = 0; b < 4; ++b)
+            {
+                for (isize a = 0; a < 4; ++a)
+                {
+                    isize const i = pi + a;
+                    isize const j = pj + b;
+                    *dst++ = {f64(i), f64(j), heights[i + j * num_points]};
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+} // namespace
+
+UTEST(tessellate, curves)
+{
+    using namespace dr;
+    using B = BernsteinBasis<3>;
+
+    // Approximation of a unit quarter circle followed by a straight line
+    constexpr f64 k = 0.5522847498;
+    Vec2<f64> const coeffs[]{
+        {1.0, 0.0},
+        {1.0, k},
+        {k, 1.0},
+        {0.0, 1.0},
+        {0.0, 1.0},
+        {-1.0, 1.0},
+        {-2.0, 1.0},
+        {-3.0, 1.0},
+    };
+
+    isize prev_size = 0;
+
+    for (f64 const tol : {1.0e-2, 1.0e-3, 1.0e-4})
+    {
+        SlicedArray<Vec2<f64>> points{};
+        tessellate_curves<B>(as_span(coeffs).as_const(), tol, points);
+        ASSERT_EQ(2, points.num_slices());
+
+        // Line should not be subdivided
+        ASSERT_EQ(2, points[1].size());
+
+        // Arc should be subdivided more finely as tolerance decreases
+        auto const arc = points[0];
+        ASSERT_LT(prev_size, arc.size());
+        prev_size = arc.size();
+
+        ASSERT_NEAR(0.0, (arc[0] - coeffs[0]).norm(), 1.0e-12);
+        ASSERT_NEAR(0.0, (arc[arc.size() - 1] - coeffs[3]).norm(), 1.0e-12);
+
+        // Midpoint of each chord should be within tolerance of the circle
+        for (isize i = 0; i + 1 < arc.size(); ++i)
+        {
+            f64 const r = (0.5 * (arc[i] + arc[i + 1])).norm();
+            ASSERT_LT(1.0 - r, 2.0 * tol);
+        }
+    }
+}
+
+UTEST(tessellate, patches)
+{
+    using namespace dr;
+    using B = CatmullRomBasis;
+
+    constexpr isize num_points = 7;
+    constexpr isize num_patches = (num_points - 3) * (num_points - 3);
+
+    // Flat patches should produce two triangles each
+    {
+        DynamicArray<Vec3<f64>> const coeffs = make_height_field_patches(num_points, 0.0, 1);
+
+        SlicedArray<Vec3<f64>, isize> vert_positions{};
+        SlicedArray<Vec3<i32>, isize> face_verts{};
+        tessellate_patches<B, B>(as_span(coeffs).as_const(), 1.0e-3, vert_positions, face_verts);
+
+        ASSERT_EQ(num_patches, face_verts.num_slices());
+        ASSERT_EQ(2 * num_patches, face_verts.num_items());
+        ASSERT_EQ(4 * num_patches, vert_positions.num_items());
+    }
+
+    DynamicArray<Vec3<f64>> const coeffs = make_height_field_patches(num_points, 0.5, 2);
+    isize prev_num_faces = 0;
+
+    for (f64 const tol : {1.0e-1, 1.0e-2, 1.0e-3})
+    {
+        SlicedArray<Vec3<f64>, isize> vert_positions{};
+        SlicedArray<Vec3<i32>, isize> face_verts{};
+        tessellate_patches<B, B>(as_span(coeffs).as_const(), tol, vert_positions, face_verts);
+
+        ASSERT_EQ(num_patches, vert_positions.num_slices());
+        ASSERT_EQ(num_patches, face_verts.num_slices());
+
+        // Should refine as tolerance decreases
+        ASSERT_LT(prev_num_faces, face_verts.num_items());
+        prev_num_faces = face_verts.num_items();
+
+        // Should be independent of thread count
+        {
+            SlicedArray<Vec3<f64>, isize> vert_positions_par{};
+            SlicedArray<Vec3<i32>, isize> face_verts_par{};
+            tessellate_patches<B, B>(
+                as_span(coeffs).as_const(),
+                tol,
+                vert_positions_par,
+                face_verts_par,
+                64,
+                Executor{4});
+
+            ASSERT_TRUE(vert_positions.items == vert_positions_par.items);
+            ASSERT_TRUE(face_verts.items == face_verts_par.items);
+        }
+
+        // Faces should be consistently oriented upward
+        for (auto const& f_v : face_verts.items)
+        {
+            Vec3<f64> const& p0 = vert_positions.items[f_v[0]];
+            Vec3<f64> const& p1 = vert_positions.items[f_v[1]];
+            Vec3<f64> const& p2 = vert_positions.items[f_v[2]];
+            ASSERT_LT(0.0, (p1 - p0).cross(p2 - p0)[2]);
+        }
+
+        // Weld coincident vertices and check that the surface is crack-free. Each interior edge
+        // should be shared by exactly two faces with opposite orientation so unmatched edges can
+        // only lie on the boundary of the surface.
+        std::map<std::pair<f64, f64>, isize> vert_ids{};
+        DynamicArray<isize> welded(vert_positions.num_items());
+
+        for (isize i = 0; i < size(welded); ++i)
+        {
+            Vec3<f64> const& p = vert_positions.items[i];
+            welded[i] = vert_ids.try_emplace({p[0], p[1]}, i).first->second;
+        }
+
+        std::map<std::pair<isize, isize>, isize> edge_counts{};
+
+        for (auto const& f_v : face_verts.items)
+        {
+            for (isize i = 0; i < 3; ++i)
+            {
+                isize const a = welded[f_v[i]];
+                isize const b = welded[f_v[(i + 1) % 3]];
+                ++edge_counts[{a, b}];
+            }
+        }
+
+        constexpr f64 eps = 1.0e-10;
+        f64 const lo = 1.0;
+        f64 const hi = f64(num_points - 2);
+        bool has_irregular = false;
+
+        for (isize i = 0; i < num_patches; ++i)
+        {
+            if (vert_positions[i].size() != 2 * face_verts[i].size())
+                has_irregular = true;
+        }
+
+        for (auto const& [edge, count] : edge_counts)
+        {
+            ASSERT_EQ(1, count);
+
+            if (edge_counts.count({edge.second, edge.first}) == 0)
+            {
+                auto const on_boundary = [&](isize const v) {
+                    Vec3<f64> const& p = vert_positions.items[v];
+                    return std::abs(p[0] - lo) < eps || std::abs(p[0] - hi) < eps
+                        || std::abs(p[1] - lo) < eps || std::abs(p[1] - hi) < eps;
+                };
+
+                ASSERT_TRUE(on_boundary(edge.first) && on_boundary(edge.second));
+            }
+        }
+
+        ASSERT_TRUE(has_irregular);
+    }
+}
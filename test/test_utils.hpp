@@ -2,7 +2,9 @@
 
 #include <algorithm>
 
+#include <dr/dynamic_array.hpp>
 #include <dr/math.hpp>
+#include <dr/random.hpp>
 #include <dr/span.hpp>
 
 namespace dr
@@ -29,4 +31,35 @@ bool all_near_equal(Span<Real const> const& a, Span<Real const> const& b, Real c
     return true;
 }
 
+/// Creates a triangulated grid of the given size with randomly perturbed vertices
+inline void make_grid_mesh(
+    isize const size,
+    DynamicArray<Vec3<f64>>& vertex_positions,
+    DynamicArray<Vec3<i32>>& face_vertices)
+{
+    Random<> rand{1};
+    auto gen = rand.generator(-0.25, 0.25);
+
+    vertex_positions.clear();
+    for (isize j = 0; j <= size; ++j)
+    {
+        for (isize i = 0; i <= size; ++i)
+            vertex_positions.push_back({f64(i) + gen(), f64(j) + gen(), gen()});
+    }
+
+    face_vertices.clear();
+    for (isize j = 0; j < size; ++j)
+    {
+        for (isize i = 0; i < size; ++i)
+        {
+            i32 const v0 = i32(i + j * (size + 1));
+            i32 const v1 = v0 + 1;
+            i32 const v2 = v1 + i32(size + 1);
+            i32 const v3 = v0 + i32(size + 1);
+            face_vertices.push_back({v0, v1, v2});
+            face_vertices.push_back({v0, v2, v3});
+        }
+    }
+}
+
 } // namespace dr
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include <utest.h>
 
+#include <dr/container_utils.hpp>
+#include <dr/dynamic_array.hpp>
 #include <dr/linalg_reshape.hpp>
 #include <dr/math.hpp>
 #include <dr/math_ctors.hpp>
@@ -268,3 +270,110 @@ UTEST(affine2, apply_inverse_self)
         ASSERT_TRUE(all_near_equal(as_span(b.translation), as_span(identity.translation), eps));
     }
 }
+
+namespace
+{
+
+template <typename Transform>
+bool batch_apply_matches(
+    Transform const& xform,
+    dr::Mat3<dr::f64> const& normal_matrix,
+    dr::f64 const eps)
+{
+    using namespace dr;
+
+    constexpr isize n = 201;
+    DynamicArray<Vec3<f64>> points(n);
+    DynamicArray<Vec3<f64>> normals(n);
+
+    for (isize i = 0; i < n; ++i)
+    {
+        points[i] = Vec3<f64>::Random();
+        normals[i] = Vec3<f64>::Random().normalized();
+    }
+
+    for (isize const num_threads : {1, 4})
+    {
+        DynamicArray<Vec3<f64>> result(n);
+        xform.apply(as_span(points).as_const(), as_span(result), Executor{num_threads});
+
+        for (isize i = 0; i < n; ++i)
+        {
+            if (!near_equal(xform.apply(points[i]), result[i], eps))
+                return false;
+        }
+
+        // In-place
+        result = points;
+        xform.apply(as_span(result).as_const(), as_span(result), Executor{num_threads});
+
+        for (isize i = 0; i < n; ++i)
+        {
+            if (!near_equal(xform.apply(points[i]), result[i], eps))
+                return false;
+        }
+
+        xform.apply_covector(as_span(normals).as_const(), as_span(result), Executor{num_threads});
+
+        for (isize i = 0; i < n; ++i)
+        {
+            if (!near_equal(Vec3<f64>{normal_matrix * normals[i]}, result[i], eps))
+                return false;
+        }
+
+        xform.apply_normal(as_span(normals).as_const(), as_span(result), Executor{num_threads});
+
+        for (isize i = 0; i < n; ++i)
+        {
+            if (!near_equal(Vec3<f64>{(normal_matrix * normals[i]).normalized()}, result[i], eps))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+} // namespace
+
+UTEST(rigid3, apply_batch)
+{
+    using namespace dr;
+
+    constexpr f64 eps = 1.0e-12;
+
+    Rigid3<f64> const xform{{Quat<f64>::UnitRandom()}, Vec3<f64>::Random()};
+    ASSERT_TRUE(batch_apply_matches(xform, xform.rotation.to_matrix(), eps));
+}
+
+UTEST(conformal3, apply_batch)
+{
+    using namespace dr;
+
+    constexpr f64 eps = 1.0e-12;
+
+    Conformal3<f64> const xform{{Quat<f64>::UnitRandom()}, Vec3<f64>::Random(), 2.5};
+    ASSERT_TRUE(batch_apply_matches(xform, xform.rotation.to_matrix() / xform.scale, eps));
+}
+
+UTEST(affine3, apply_batch)
+{
+    using namespace dr;
+
+    constexpr f64 eps = 1.0e-10;
+
+    Affine3<f64> const xform{
+        Mat3<f64>::Random() + Mat3<f64>::Identity() * 2.0,
+        Vec3<f64>::Random(),
+    };
+
+    Mat3<f64> const normal_matrix = xform.linear.inverse().transpose();
+    ASSERT_TRUE(batch_apply_matches(xform, normal_matrix, eps));
+
+    // Transformed normals should remain orthogonal to transformed tangents
+    Vec3<f64> const normal = Vec3<f64>::Random().normalized();
+    Vec3<f64> const tangent = normal.cross(Vec3<f64>::Random());
+
+    Vec3<f64> xform_normal;
+    xform.apply_normal(Span<Vec3<f64> const>{&normal, 1}, Span<Vec3<f64>>{&xform_normal, 1});
+    ASSERT_NEAR(0.0, xform_normal.dot(xform.linear * tangent), eps);
+}